@@ -80,8 +80,77 @@ void GetBucket(qcloud_cos::CosAPI& cos) {
     std::cout << "=========================================================" << std::endl;
 }
 
+// 逐页列出存储桶, 处理当前页时后台预取后续页面
+void GetBucketByPager(qcloud_cos::CosAPI& cos) {
+    qcloud_cos::GetBucketReq req(bucket_name);
+    req.SetPrefix("test/");
+    qcloud_cos::SharedGetBucketPager pager = cos.NewGetBucketPager(req);
+
+    std::cout << "===================GetBucketByPager=====================" << std::endl;
+    for (const qcloud_cos::GetBucketResp& page : *pager) {
+        std::vector<qcloud_cos::Content> contents = page.GetContents();
+        for (size_t i = 0; i < contents.size(); ++i) {
+            std::cout << "key name=" << contents[i].m_key << std::endl;
+        }
+    }
+    qcloud_cos::CosResult result = pager->GetResult();
+    if (!result.IsSucc()) {
+        std::cout << "ErrorMsg=" << result.GetErrorMsg() << std::endl;
+        std::cout << "HttpStatus=" << result.GetHttpStatus() << std::endl;
+    }
+    std::cout << "=========================================================" << std::endl;
+}
+
+// 并发列出对象数量巨大的存储桶, 结果分批通过回调返回
+void ParallelGetBucket(qcloud_cos::CosAPI& cos) {
+    qcloud_cos::ParallelGetBucketReq req(bucket_name, "");
+    req.SetConcurrency(16);
+    req.SetOrdered(false);  // 不要求按key顺序时使用无序输出, 内存占用更低
+
+    uint64_t object_count = 0;
+    qcloud_cos::CosResult result = cos.ParallelGetBucket(
+        req, [&object_count](const std::vector<qcloud_cos::Content>& contents) {
+            object_count += contents.size();
+            return true;  // 返回false时停止列出
+        });
+
+    std::cout << "===================ParallelGetBucket=====================" << std::endl;
+    if (result.IsSucc()) {
+        std::cout << "object count=" << object_count << std::endl;
+    } else {
+        std::cout << "ErrorMsg=" << result.GetErrorMsg() << std::endl;
+        std::cout << "HttpStatus=" << result.GetHttpStatus() << std::endl;
+    }
+    std::cout << "=========================================================" << std::endl;
+}
+
+void GetBucketCompact(qcloud_cos::CosAPI& cos) {
+    qcloud_cos::GetBucketReq req(bucket_name);
+    req.SetPrefix("test/");
+    qcloud_cos::CompactListResult objects;
+    // 逐页流式解析, 结果以紧凑格式保存, 适用于千万级对象的清单扫描
+    qcloud_cos::CosResult result = cos.GetBucketCompact(req, &objects);
+
+    std::cout << "===================GetBucketCompact=====================" << std::endl;
+    if (result.IsSucc()) {
+        uint64_t total_size = 0;
+        for (size_t i = 0; i < objects.Size(); ++i) {
+            total_size += objects.GetSize(i);
+        }
+        std::cout << "object count=" << objects.Size() << ", total size=" << total_size
+                  << ", memory usage=" << objects.MemoryUsage() << std::endl;
+    } else {
+        std::cout << "ErrorMsg=" << result.GetErrorMsg() << std::endl;
+        std::cout << "HttpStatus=" << result.GetHttpStatus() << std::endl;
+    }
+    std::cout << "=========================================================" << std::endl;
+}
+
 int main() {
     qcloud_cos::CosAPI cos = InitCosAPI();
     CosSysConfig::SetLogLevel((LOG_LEVEL)COS_LOG_ERR);
     GetBucket(cos);
+    GetBucketByPager(cos);
+    ParallelGetBucket(cos);
+    GetBucketCompact(cos);
 }
\ No newline at end of file
@@ -139,6 +139,11 @@ void DeleteObjectsByPrefixDemo(qcloud_cos::CosAPI& cos) {
     for (auto& obj : resp.m_succ_del_objs) {
         std::cout << obj << std::endl;
     }
+    std::cout << "Fail del objs:" << std::endl;
+    for (auto& info : resp.m_fail_del_objs) {
+        std::cout << info.m_key << ", code: " << info.m_code
+                  << ", message: " << info.m_message << std::endl;
+    }
     std::cout << "=============================================================" << std::endl;
 }
 
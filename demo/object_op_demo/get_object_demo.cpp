@@ -83,6 +83,38 @@ void GetObjectByFileDemo(qcloud_cos::CosAPI& cos) {
     std::cout << "=========================================================" << std::endl;
 }
 
+/*
+ * 该 Demo 示范如何将 cos 上 test_dir/ 前缀下的对象下载到本地 test_download 目录
+ * 例如 test_dir/a/text1.txt 下载后的本地路径为 test_download/a/text1.txt
+ */
+void GetObjectsByPrefixDemo(qcloud_cos::CosAPI& cos) {
+    std::string prefix = "test_dir/";
+    std::string local_dir = "test_download";
+    qcloud_cos::GetObjectsByPrefixReq req(bucket_name, prefix, local_dir);
+    req.SetConcurrency(8);       // 同时下载8个对象, 大对象自动使用多线程下载
+    req.SetSkipIdentical(true);  // 本地已有相同文件时跳过
+    req.SetTransferProgressCallback([](uint64_t transferred_size, uint64_t total_size, void*) {
+        std::cout << "progress: " << transferred_size << "/" << total_size << std::endl;
+    });
+    qcloud_cos::GetObjectsByPrefixResp resp;
+
+    qcloud_cos::CosResult result = cos.GetObjects(req, &resp);
+    std::cout << "===================GetObjectsByPrefix=====================" << std::endl;
+    if (result.IsSucc()) {
+        std::cout << "GetObjectsByPrefix Succ." << std::endl;
+    } else {
+        std::cout << "GetObjectsByPrefix Fail, ErrorMsg: " << result.GetErrorMsg() << std::endl;
+    }
+    for (auto& r : resp.m_succ_get_objs) {
+        std::cout << "object_name: " << r.m_object_name << ", file_name: " << r.m_file_name
+                  << (r.m_skipped ? " (skipped)" : "") << std::endl;
+    }
+    for (auto& r : resp.m_fail_get_objs) {
+        std::cout << "fail object_name: " << r.m_object_name << ", ErrorMsg: " << r.m_err_msg << std::endl;
+    }
+    std::cout << "==========================================================" << std::endl;
+}
+
 void GetObjectByStreamDemo(qcloud_cos::CosAPI& cos) {
     std::string object_name = "test.txt";
     std::ostringstream os;
@@ -162,6 +194,7 @@ int main() {
     CosSysConfig::SetLogLevel((LOG_LEVEL)COS_LOG_ERR);
     GetObjectByFileDemo(cos);
     GetObjectByStreamDemo(cos);
+    // GetObjectsByPrefixDemo(cos);
     // GetObjectByStreamDemoWithMutualAuthentication(cos);
     GetBucketDemo(cos);
 }
\ No newline at end of file
@@ -102,6 +102,10 @@ void PutObjectsFromDirectoryDemo(qcloud_cos::CosAPI& cos) {
     std::string cos_path = "test_dir/"; // 目录名称，注意末尾需要有/
     PutObjectsByDirectoryReq req(bucket_name, directory_name);
     req.SetCosPath(cos_path);
+    req.SetConcurrency(8);  // 同时上传8个文件, 大文件自动使用分块上传
+    req.SetTransferProgressCallback([](uint64_t transferred_size, uint64_t total_size, void*) {
+        std::cout << "progress: " << transferred_size << "/" << total_size << std::endl;
+    });
     PutObjectsByDirectoryResp resp;
     CosResult result = cos.PutObjects(req, &resp);
 
@@ -115,6 +119,9 @@ void PutObjectsFromDirectoryDemo(qcloud_cos::CosAPI& cos) {
     } else {
         std::cout << "PutObjectsFromDirectoryToCosPath Fail, ErrorMsg: "
                   << result.GetErrorMsg() << std::endl;
+        for (auto& r : resp.m_fail_put_objs) {
+            std::cout << "fail file_name: " << r.m_file_name << ", ErrorMsg: " << r.m_err_msg << std::endl;
+        }
     }
     std::cout << "=========================================================" << std::endl;
 }
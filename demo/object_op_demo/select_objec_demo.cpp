@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <sys/stat.h>
+#include <fstream>
 #include <iostream>
 #include <map>
 #include <string>
@@ -70,8 +71,42 @@ void SelectObjectContentDemo(qcloud_cos::CosAPI& cos) {
     std::cout << "=========================================================" << std::endl;
 }
 
+// 流式SELECT的回调, 结果边接收边写入本地文件
+class SelectToFileHandler : public qcloud_cos::SelectEventHandler {
+ public:
+    explicit SelectToFileHandler(const std::string& file) : m_ofs(file.c_str(), std::ios::out | std::ios::trunc) {}
+
+    bool OnRecords(const char* data, size_t len, const std::string& /*content_type*/) override {
+        m_ofs.write(data, len);
+        return m_ofs.good();  // 返回false时停止接收
+    }
+
+    void OnProgress(const qcloud_cos::SelectProgress& progress) override {
+        std::cout << "progress: scanned=" << progress.bytes_scanned
+                  << ", returned=" << progress.bytes_returned << std::endl;
+    }
+
+ private:
+    std::ofstream m_ofs;
+};
+
+void StreamSelectObjectContentDemo(qcloud_cos::CosAPI& cos) {
+    std::string object_name = "test.csv.gz";
+    qcloud_cos::SelectObjectContentReq req(bucket_name, object_name, CSV, COMPRESS_GZIP, CSV);
+    req.SetSqlExpression("Select * from COSObject");
+    req.SetRequestProgress(true);
+    qcloud_cos::SelectObjectContentResp resp;
+    SelectToFileHandler handler("select_result.csv");
+    qcloud_cos::CosResult result = cos.SelectObjectContent(req, &handler, &resp);
+
+    std::cout << "=================StreamSelectObjectContent===============" << std::endl;
+    PrintResult(result, resp);
+    std::cout << "=========================================================" << std::endl;
+}
+
 int main() {
     qcloud_cos::CosAPI cos = InitCosAPI();
     CosSysConfig::SetLogLevel((LOG_LEVEL)COS_LOG_ERR);
     SelectObjectContentDemo(cos);
+    StreamSelectObjectContentDemo(cos);
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "op/bucket_op.h"
 #include "op/cos_result.h"
+#include "op/list_pager.h"
 #include "op/object_op.h"
 #include "op/service_op.h"
 #include "util/auth_tool.h"
@@ -89,6 +90,67 @@ class CosAPI {
   CosResult ListMultipartUpload(const ListMultipartUploadReq& req,
                                 ListMultipartUploadResp* resp);
 
+  /// \brief 并发列出Bucket下指定前缀的全部对象, 适用于对象数量巨大的Bucket
+  ///        以"/"为delimiter拆分子前缀并发列出, 结果分批通过callback返回,
+  ///        callback返回false时停止列出
+  ///
+  /// \param req      ParallelGetBucket请求
+  /// \param callback 结果回调
+  ///
+  /// \return 返回第一个失败请求的状态码及错误信息
+  CosResult ParallelGetBucket(const ParallelGetBucketReq& req,
+                              const ListContentsCallback& callback);
+
+  /// \brief 创建GetBucket的分页迭代器, 从req指定的位置开始逐页列出,
+  ///        调用方处理当前页时后台预取后续页面, 迭代器不能在CosAPI析构后使用
+  ///
+  /// \param req            第一页的GetBucket请求
+  /// \param prefetch_pages 最多预取的页面数
+  ///
+  /// \return 分页迭代器, 通过Next逐页获取结果
+  SharedGetBucketPager NewGetBucketPager(
+      const GetBucketReq& req,
+      unsigned prefetch_pages = kDefaultListPrefetchPages);
+
+  /// \brief 流式列出该Bucket下的Object, 响应边接收边解析, 每个对象通过handler回调,
+  ///        不缓存响应正文, 对象大小和修改时间解析为数值
+  ///
+  /// \param req       GetBucket请求
+  /// \param handler   解析结果回调, 请求重试时先调用OnReset
+  /// \param page_info 返回IsTruncated、NextMarker等翻页信息
+  ///
+  /// \return 返回HTTP请求的状态码及错误信息
+  CosResult StreamGetBucket(const GetBucketReq& req, ListXmlHandler* handler,
+                            ListPageInfo* page_info);
+
+  /// \brief 流式列出Object多版本, 用法同StreamGetBucket
+  CosResult StreamGetBucketObjectVersions(const GetBucketObjectVersionsReq& req,
+                                          ListXmlHandler* handler,
+                                          ListPageInfo* page_info);
+
+  /// \brief 从req指定的位置开始流式列出全部Object, 结果追加到紧凑的列出结果中,
+  ///        适用于千万级对象的清单扫描, 内存占用约为std::vector<Content>的十分之一
+  ///
+  /// \param req    第一页的GetBucket请求
+  /// \param result 列出结果, 失败时只保留已完整列出的页面
+  ///
+  /// \return 返回第一个失败请求的状态码及错误信息
+  CosResult GetBucketCompact(const GetBucketReq& req, CompactListResult* result);
+
+  /// \brief 流式列出全部Object多版本, 用法同GetBucketCompact
+  CosResult GetBucketObjectVersionsCompact(const GetBucketObjectVersionsReq& req,
+                                           CompactListResult* result);
+
+  /// \brief 并发列出Bucket下指定前缀的全部对象, 结果追加到紧凑的列出结果中,
+  ///        req设置为有序时结果按key排序
+  CosResult ParallelGetBucket(const ParallelGetBucketReq& req,
+                              CompactListResult* result);
+
+  /// \brief 创建ListMultipartUpload的分页迭代器, 用法同NewGetBucketPager
+  SharedListMultipartUploadPager NewListMultipartUploadPager(
+      const ListMultipartUploadReq& req,
+      unsigned prefetch_pages = kDefaultListPrefetchPages);
+
   /// \brief 删除Bucket
   ///        详见: https://cloud.tencent.com/document/product/436/7732
   ///
@@ -606,6 +668,18 @@ class CosAPI {
   CosResult SelectObjectContent(const SelectObjectContentReq& req,
                                 SelectObjectContentResp* resp);
 
+  /// \brief 流式SELECT, 响应边接收边解码并校验CRC, Records/Progress/Stats/End
+  ///        事件到达后立即回调handler, 不缓存完整结果
+  ///
+  /// \param req     SelectObjectContent请求
+  /// \param handler 事件回调, OnRecords返回false时停止接收
+  /// \param resp    SelectObjectContent响应, 只包含响应头部
+  ///
+  /// \return 本次请求的调用情况(如状态码等), 未收到End事件时返回失败
+  CosResult SelectObjectContent(const SelectObjectContentReq& req,
+                                SelectEventHandler* handler,
+                                SelectObjectContentResp* resp);
+
   /// \brief 追加对象, 参考https://cloud.tencent.com/document/product/436/7743
   ///
   /// \param req  AppendObject请求
@@ -623,6 +697,11 @@ class CosAPI {
   CosResult GetBucketObjectVersions(const GetBucketObjectVersionsReq& req,
                                     GetBucketObjectVersionsResp* resp);
 
+  /// \brief 创建GetBucketObjectVersions的分页迭代器, 用法同NewGetBucketPager
+  SharedGetBucketObjectVersionsPager NewGetBucketObjectVersionsPager(
+      const GetBucketObjectVersionsReq& req,
+      unsigned prefetch_pages = kDefaultListPrefetchPages);
+
   /// \brief 创建推流通道
   ///
   /// \param req  PutLiveChannelReq请求
@@ -828,12 +907,40 @@ class CosAPI {
   CosResult MoveObject(const MoveObjectReq& req);
 
   /// \brief 按前缀删除Object
+  ///        列出的对象按批(最多1000个)以quiet模式批量删除, 多个批次并发执行,
+  ///        并在删除当前页的同时列出下一页. 单个对象删除失败不会中止,
+  ///        失败的对象记录在resp->m_fail_del_objs中
   /// \param req  DeleteObjectsByPrefix请求
   /// \param resp DeleteObjectsByPrefix响应
-  /// \return 本次请求的调用情况(如状态码等)
+  /// \return 列出对象失败或批量删除请求本身失败时返回第一个失败结果,
+  ///         否则返回成功
   CosResult DeleteObjects(const DeleteObjectsByPrefixReq& req,
                           DeleteObjectsByPrefixResp* resp);
 
+  /// \brief 按前缀下载对象到本地目录
+  ///        先列出前缀下的所有对象, 再并发下载, 小对象使用GetObject,
+  ///        大对象使用多线程下载. 单个对象下载失败不会中止,
+  ///        失败的对象记录在resp->m_fail_get_objs中
+  /// \param req  GetObjectsByPrefix请求
+  /// \param resp GetObjectsByPrefix响应
+  /// \return 列出对象失败时返回列出结果, 否则返回第一个失败对象的结果或成功
+  CosResult GetObjects(const GetObjectsByPrefixReq& req,
+                       GetObjectsByPrefixResp* resp);
+
+  /// \brief 异步按前缀下载对象到本地目录, 通过req设置的回调获取进度和结果
+  /// \param req  GetObjectsByPrefix请求
+  /// \return 返回context
+  SharedAsyncContext AsyncGetObjects(const GetObjectsByPrefixReq& req);
+
+  /// \brief 增量同步本地目录到cos前缀
+  ///        按大小和CRC64(x-cos-hash-crc64ecma)比较本地文件与对象, 只上传新增或
+  ///        变化的文件, 可选删除本地已不存在的对象. 设置manifest文件后,
+  ///        大小和修改时间未变化的文件复用上次计算的CRC64
+  /// \param req  SyncDirectory请求
+  /// \param resp SyncDirectory响应
+  /// \return 列出对象失败时返回列出结果, 否则返回第一个失败文件的结果或成功
+  CosResult SyncDirectory(const SyncDirectoryReq& req, SyncDirectoryResp* resp);
+
   /* 数据处理接口 */
 
   /*** 存储桶绑定万象服务 ***/
@@ -1025,6 +1132,11 @@ class CosAPI {
   int CosInit();
   void CosUInit();
 
+  // 按前缀下载的实现, handler不为空时更新汇总进度和状态
+  CosResult GetObjectsByPrefix(const GetObjectsByPrefixReq& req,
+                               GetObjectsByPrefixResp* resp,
+                               const SharedTransferHandler& handler);
+
  private:
   // Be careful with the m_config order
   SharedConfig m_config;
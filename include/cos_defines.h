@@ -35,11 +35,31 @@ const int kMinThreadPoolSizeUploadPart = 1;
 /// 最大分开数量
 const int kMaxPartNumbers = 10000;
 
+/// 单次批量删除的最大对象数量
+const unsigned kMaxDeleteObjectsBatchSize = 1000;
+/// 按前缀删除时默认并发的批量删除请求数
+const unsigned kDefaultDeleteObjectsConcurrency = 4;
+
 /// 分块大小1M
 const uint64_t kPartSize1M = 1 * 1024 * 1024;
 /// 分块大小5G
 const uint64_t kPartSize5G = (uint64_t)5 * 1024 * 1024 * 1024;
 
+/// 批量上传时使用分块上传的默认文件大小阈值
+const uint64_t kDefaultMultiUploadThreshold = 16 * kPartSize1M;
+/// 按前缀下载时使用多线程下载的默认文件大小阈值
+const uint64_t kDefaultMultiDownloadThreshold = 16 * kPartSize1M;
+/// 按前缀下载时默认同时下载的对象数
+const unsigned kDefaultGetObjectsConcurrency = 4;
+/// 目录同步时默认同时处理的文件数
+const unsigned kDefaultSyncDirectoryConcurrency = 4;
+/// 并行列出Bucket时默认同时进行的列出请求数
+const unsigned kDefaultParallelListConcurrency = 8;
+/// 并行有序列出时默认最多缓存的尚未回调的对象数
+const uint64_t kDefaultParallelListMaxBufferedKeys = 100000;
+/// 分页列出时默认预取的页面数
+const unsigned kDefaultListPrefetchPages = 2;
+
 using SSLCtxCallback = std::function<int(void *ssl_ctx, void* user_data)>;
 
 const bool COS_CHANGE_BACKUP_DOMAIN = true;
@@ -67,6 +87,12 @@ typedef enum cos_log_level {
 
 typedef enum file_type { CSV = 0, JSON } SELECT_FILE_TYPE;
 
+/// MD5/SHA1/HMAC-SHA1的实现
+typedef enum hash_backend {
+  HASH_BACKEND_OPENSSL = 0,  // OpenSSL EVP, 支持SHA-NI及汇编优化
+  HASH_BACKEND_BUILTIN       // SDK自带的SHA1及Poco的MD5/HMAC
+} HASH_BACKEND;
+
 typedef enum compress_type {
   COMPRESS_NONE = 0,
   COMPRESS_GZIP,
@@ -162,6 +162,9 @@ const char kResumableDownloadTaskContentLength[] = "contentLength";
 const char kResumableDownloadTaskEtag[] = "eTag";
 const char kResumableDownloadTaskCrc64ecma[] = "crc64ecma";
 const char kResumableDownloadResumeOffset[] = "resumeOffset";
+const char kResumableDownloadSliceSize[] = "sliceSize";
+const char kResumableDownloadSliceBitmap[] = "sliceBitmap";
+const char kResumableDownloadSliceCrc64[] = "sliceCrc64";
 
 // Resumable upload checkpoint
 const char kResumableUploadTaskFileSuffix[] = ".cosresumableupload";
@@ -175,6 +178,17 @@ const char kResumableUploadCheckpointLastModified[] = "lastModified";
 const char kResumableUploadCheckpointPartSize[] = "partSize";
 const char kResumableUploadCheckpointMd5Sum[] = "md5Sum";
 
+// 目录同步manifest
+const char kSyncManifestOpType[] = "opType";
+const char kSyncManifestBucket[] = "bucket";
+const char kSyncManifestPrefix[] = "prefix";
+const char kSyncManifestFiles[] = "files";
+const char kSyncManifestPath[] = "path";
+const char kSyncManifestSize[] = "size";
+const char kSyncManifestMtime[] = "mtime";
+const char kSyncManifestCrc64ecma[] = "crc64ecma";
+const char kSyncManifestEtag[] = "eTag";
+
 // 预设ACL
 const char kAclDefault[] = "default";
 const char kAclPrivate[] = "private";
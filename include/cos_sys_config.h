@@ -30,6 +30,12 @@ class CosSysConfig {
   /// \brief 设置文件分片并发上传线程池大小,默认: 5
   static void SetUploadThreadPoolSize(unsigned size);
 
+  /// \brief 设置分块上传时预读的分块数,默认: 2
+  static void SetUploadReadAheadDepth(unsigned depth);
+
+  /// \brief 设置分块上传时预读文件的线程数,默认: 2
+  static void SetUploadReaderThreadNum(unsigned num);
+
   /// \brief 设置异步上传下载线程池大小,默认: 2
   static void SetAsynThreadPoolSize(unsigned size);
 
@@ -45,6 +51,22 @@ class CosSysConfig {
   /// \brief 设置下载分片的大小
   static void SetDownSliceSize(unsigned slice_size);
 
+  /// \brief 设置多线程下载前是否预分配本地文件空间,默认: false
+  static void SetDownFilePreallocate(bool preallocate);
+
+  /// \brief 设置全局传输线程池的线程数上限, 所有分块上传/下载/复制共享,
+  /// 0表示取上传与下载线程池大小之和,默认: 0
+  static void SetTransferWorkerPoolSize(unsigned size);
+
+  /// \brief 设置分块/分片缓冲区池保留内存的上限,单位:字节,默认: 256M
+  static void SetBufferPoolMaxBytes(uint64_t max_bytes);
+
+  /// \brief 设置缓冲区池的大缓冲区是否使用透明大页,默认: false
+  static void SetBufferPoolUseHugePage(bool use_huge_page);
+
+  /// \brief 设置MD5/SHA1/HMAC-SHA1的实现,默认: HASH_BACKEND_OPENSSL
+  static void SetHashBackend(HASH_BACKEND backend);
+
   /// \brief 设置长连接的参数
   static void SetKeepAlive(bool keepalive);
 
@@ -54,6 +76,16 @@ class CosSysConfig {
   /// \brief 设置长连接的参数
   static void SetKeepIntvl(int64_t keepintvl);
 
+  /// \brief 设置长连接池中每个host最多保留的空闲连接数,默认: 16
+  static void SetMaxIdleSessionsPerHost(unsigned max_idle_sessions);
+
+  /// \brief 设置开启长连接时每个host同时使用的连接数上限,
+  ///        达到上限时新请求等待其他请求结束, 0表示不限制,默认: 0
+  static void SetMaxSessionsPerHost(unsigned max_sessions);
+
+  /// \brief 设置长连接池中空闲连接的超时时间,单位:秒,默认: 30
+  static void SetSessionIdleTimeout(int64_t idle_timeout_in_s);
+
   static void SetDestDomain(const std::string& dest_domain);
 
   /// \brief 获取签名超时时间,单位秒
@@ -77,6 +109,12 @@ class CosSysConfig {
   /// \brief 获取上传线程池大小
   static unsigned GetUploadThreadPoolSize();
 
+  /// \brief 获取分块上传时预读的分块数
+  static unsigned GetUploadReadAheadDepth();
+
+  /// \brief 获取分块上传时预读文件的线程数
+  static unsigned GetUploadReaderThreadNum();
+
   /// \brief 获取异步线程池大小
   static unsigned GetAsynThreadPoolSize();
 
@@ -95,11 +133,35 @@ class CosSysConfig {
   /// \brief 获取下载线程池大小
   static unsigned GetDownThreadPoolSize();
 
+  /// \brief 获取多线程下载前是否预分配本地文件空间
+  static bool GetDownFilePreallocate();
+
+  /// \brief 获取全局传输线程池的线程数上限
+  static unsigned GetTransferWorkerPoolSize();
+
+  /// \brief 获取缓冲区池保留内存的上限
+  static uint64_t GetBufferPoolMaxBytes();
+
+  /// \brief 获取缓冲区池是否使用透明大页
+  static bool GetBufferPoolUseHugePage();
+
+  /// \brief 获取MD5/SHA1/HMAC-SHA1的实现
+  static HASH_BACKEND GetHashBackend();
+
   /// \brief 获取keepalive参数
   static bool GetKeepAlive();
   static int64_t GetKeepIdle();
   static int64_t GetKeepIntvl();
 
+  /// \brief 获取长连接池中每个host最多保留的空闲连接数
+  static unsigned GetMaxIdleSessionsPerHost();
+
+  /// \brief 获取开启长连接时每个host同时使用的连接数上限
+  static unsigned GetMaxSessionsPerHost();
+
+  /// \brief 获取长连接池中空闲连接的超时时间,单位:秒
+  static int64_t GetSessionIdleTimeout();
+
   /// \brief 下载过程中是否检查MD5
   static bool IsCheckMd5();
 
@@ -194,18 +256,37 @@ private:
   static uint64_t m_recv_timeout_in_ms;
   // 单文件分片并发上传线程池大小(每个文件一个)
   static unsigned m_threadpool_size;
+  // 分块上传时预读的分块数(不含正在上传的分块)
+  static unsigned m_upload_read_ahead_depth;
+  // 分块上传时预读文件的线程数
+  static unsigned m_upload_reader_thread_num;
   // 异步上传下载线程池大小(全局就一个)
   static unsigned m_asyn_threadpool_size;
   // 下载文件到本地线程池大小
   static unsigned m_down_thread_pool_size;
   // 下载文件到本地,每次下载字节数
   static unsigned m_down_slice_size;
+  // 下载文件到本地前是否预分配文件空间
+  static bool m_down_file_preallocate;
+  // 全局传输线程池的线程数上限, 0表示取上传与下载线程池大小之和
+  static unsigned m_transfer_worker_pool_size;
+  // 缓冲区池保留内存的上限
+  static uint64_t m_buffer_pool_max_bytes;
+  // 缓冲区池是否使用透明大页
+  static bool m_buffer_pool_use_huge_page;
+  // MD5/SHA1/HMAC-SHA1的实现
+  static HASH_BACKEND m_hash_backend;
   // 是否开启长连接
   static bool m_keep_alive;
   // 空闲多久后，发送keepalive探针，单位s
   static int64_t m_keep_idle;
   // 每个keepalive探针时间间隔，单位s
   static int64_t m_keep_intvl;
+  // 长连接池中每个host最多保留的空闲连接数
+  static unsigned m_max_idle_sessions_per_host;
+  static unsigned m_max_sessions_per_host;
+  // 长连接池中空闲连接的超时时间，单位s
+  static int64_t m_session_idle_timeout;
   // 下载时是否检查md5
   static bool m_is_check_md5;
 
@@ -118,6 +118,26 @@ class BaseOp {
       const std::map<std::string, std::string>& additional_params,
       std::istream& is, BaseResp* resp, const SharedTransferHandler& handler = nullptr);
 
+  /// \brief 发送带请求正文的请求, 响应正文边接收边输出到流中,
+  ///        用于需要增量处理响应的接口(如SelectObjectContent)
+  ///        重试前将os seek到起点, 输出流不能回到起点时(数据已交给调用方)不再重试
+  ///
+  /// \param host     目标主机, 以http://开头
+  /// \param path     http path
+  /// \param req      http请求
+  /// \param additional_headers http请求需要所需的额外header
+  /// \param additional_params  http请求需要所需的额外params
+  /// \param req_body http request的body
+  /// \param resp     http返回
+  /// \param os       响应正文的输出流
+  ///
+  /// \return http调用情况(状态码等)
+  CosResult StreamAction(
+      const std::string& host, const std::string& path, const BaseReq& req,
+      const std::map<std::string, std::string>& additional_headers,
+      const std::map<std::string, std::string>& additional_params,
+      const std::string& req_body, BaseResp* resp, std::ostream& os);
+
   std::string GetRealUrl(const std::string& host, const std::string& path,
                          bool is_https, bool is_generate_presigned_url = false);
 
@@ -144,6 +164,13 @@ private:
       const std::map<std::string, std::string>& additional_headers,
       const std::map<std::string, std::string>& additional_params,
       std::istream& is, BaseResp* resp, const uint32_t &request_retry_num, const SharedTransferHandler& handler = nullptr);
+
+  CosResult StreamRequest(
+      const std::string& host, const std::string& path, const BaseReq& req,
+      const std::map<std::string, std::string>& additional_headers,
+      const std::map<std::string, std::string>& additional_params,
+      const std::string& req_body, BaseResp* resp, std::ostream& os,
+      const uint32_t& request_retry_num);
 };
 
 }  // namespace qcloud_cos
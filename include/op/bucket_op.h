@@ -16,6 +16,7 @@
 #include "response/bucket_resp.h"
 #include "response/data_process_resp.h"
 #include "response/auditing_resp.h"
+#include "util/list_xml_parser.h"
 
 namespace qcloud_cos {
 
@@ -69,6 +70,34 @@ class BucketOp : public BaseOp {
   CosResult ListMultipartUpload(const ListMultipartUploadReq& req,
                                 ListMultipartUploadResp* resp,
                                 bool change_backup_domain = false);
+
+  /// \brief 并发列出Bucket下指定前缀的全部对象, 结果分批通过callback返回
+  ///        无序输出时callback可能在多个线程中被调用, 但不会同时被调用
+  ///
+  /// \param req      ParallelGetBucket请求
+  /// \param callback 结果回调, 返回false时停止列出
+  ///
+  /// \return 列出失败时返回第一个失败请求的结果
+  CosResult ParallelGetBucket(const ParallelGetBucketReq& req,
+                              const ListContentsCallback& callback);
+
+  /// \brief 流式列出Bucket下的Object, 响应边接收边解析, 每个对象通过handler回调,
+  ///        不缓存响应正文也不构建DOM, 适用于大批量列出
+  ///
+  /// \param req       GetBucket请求
+  /// \param handler   解析结果回调, 请求重试时先调用OnReset
+  /// \param page_info 返回IsTruncated、NextMarker等翻页信息
+  ///
+  /// \return 本次请求的调用情况(如状态码等)
+  CosResult StreamGetBucket(const GetBucketReq& req, ListXmlHandler* handler,
+                            ListPageInfo* page_info,
+                            bool change_backup_domain = false);
+
+  /// \brief 流式列出Bucket下的Object多版本, 用法同StreamGetBucket
+  CosResult StreamGetBucketObjectVersions(const GetBucketObjectVersionsReq& req,
+                                          ListXmlHandler* handler,
+                                          ListPageInfo* page_info,
+                                          bool change_backup_domain = false);
   /// \brief 删除Bucket
   ///
   /// \param req  DeleteBucket请求
@@ -706,6 +735,11 @@ class BucketOp : public BaseOp {
   /// \brief 处理CI请求
   CosResult ProcessReq(const BucketReq& req, BaseResp* resp,
                        bool is_ci_req = false);
+
+  /// \brief 以下载流的方式发送列出请求, 响应正文直接交给ListXmlParser解析
+  CosResult StreamListAction(const std::string& host, const BucketReq& req,
+                             BaseResp* resp, ListXmlHandler* handler,
+                             ListPageInfo* page_info);
 };
 
 }  // namespace qcloud_cos
\ No newline at end of file
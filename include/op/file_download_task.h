@@ -15,7 +15,7 @@
 #include "cos_config.h"
 #include "trsf/transfer_handler.h"
 #include "util/base_op_util.h"
-#include "util/semaphore.h"
+#include "util/completion_queue.h"
 #include "util/task.h"
 
 namespace qcloud_cos {
@@ -35,8 +35,7 @@ class FileDownTask : public Poco::Runnable {
                bool verify_cert = true,
                const std::string& ca_lication = "",
                SSLCtxCallback ssl_ctx_cb = nullptr,
-               void *user_data = nullptr,
-               Semaphore* semaphore = nullptr);
+               void *user_data = nullptr);
 
   ~FileDownTask() {}
 
@@ -50,8 +49,17 @@ class FileDownTask : public Poco::Runnable {
   void SetCaLocation(const std::string& ca_location);
   void SetSslCtxCb(SSLCtxCallback cb, void *data);
 
-  // 设置信号量，用于任务完成时自动释放资源
-  void SetSemaphore(Semaphore* semaphore) { m_semaphore = semaphore; }
+  // 设置完成队列及任务槽位下标，任务完成时推入队列通知调度线程
+  void SetCompletionQueue(CompletionQueue* queue, unsigned slot) {
+    m_completion_queue = queue;
+    m_slot = slot;
+  }
+
+  // 设置本地文件描述符, 设置后任务下载成功时直接将分片写入文件的对应偏移处
+  void SetWriteFd(int fd) { m_write_fd = fd; }
+
+  // 设置是否在任务线程中计算分片的CRC64
+  void SetCalcCrc64(bool calc_crc64) { m_calc_crc64 = calc_crc64; }
 
   // 设置当前任务在下载序列中的顺序号
   void SetSequence(uint64_t sequence) { m_task_info.sequence = sequence;}
@@ -77,6 +85,10 @@ class FileDownTask : public Poco::Runnable {
 
   std::string GetErrMsg() const { return m_err_msg; }
 
+  uint64_t GetOffset() const { return m_offset; }
+
+  uint64_t GetCrc64() const { return m_crc64; }
+
  private:
   std::string m_host;
   std::string m_path;
@@ -102,14 +114,23 @@ class FileDownTask : public Poco::Runnable {
   SSLCtxCallback m_ssl_ctx_cb;
   void *m_user_data;
 
-  // 信号量指针，用于任务完成时自动通知
-  Semaphore* m_semaphore;
+  // 完成队列及任务槽位下标，用于任务完成时通知调度线程
+  CompletionQueue* m_completion_queue;
+  unsigned m_slot;
+
+  // 本地文件描述符, -1表示由调用方负责写文件
+  int m_write_fd;
+  bool m_calc_crc64;
+  uint64_t m_crc64;
 
   TaskInfo m_task_info;
 
   SharedConfig m_config;
 
   void SendRequestOnce(std::string domain);
+
+  // 计算分片CRC64并写入本地文件, 写入失败时将任务置为失败
+  void WriteDownData();
 };
 
 }  // namespace qcloud_cos
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "util/noncopyable.h"
+
+namespace qcloud_cos {
+
+// 预读完成的分块
+struct ReadAheadPart {
+  uint64_t part_number;  // 从1开始
+  uint64_t offset;
+  unsigned char* buf;
+  size_t len;
+};
+
+// 分块上传的预读线程, 独立于上传线程按顺序将文件分块读入有界的缓冲区环中,
+// 使磁盘读取与网络发送重叠进行. 缓冲区数量为 max_in_use + depth,
+// 其中max_in_use为调用方同时持有的最大分块数(即上传并发数)
+// POSIX 平台使用 pread 读取, 多个读线程之间不共享文件偏移
+class FilePartReader : private NonCopyable {
+ public:
+  FilePartReader(uint64_t file_size, uint64_t part_size, unsigned max_in_use,
+                 unsigned depth, unsigned reader_num);
+  ~FilePartReader();
+
+  // 打开文件并启动读线程, 缓冲区分配失败或打开文件失败时返回false
+  bool Start(const std::string& path);
+#if defined(_WIN32)
+  bool Start(const std::wstring& path);
+#endif
+
+  // 按part_number顺序获取下一个分块, 阻塞直到读取完成
+  // 返回false表示所有分块已取完或读取出错(通过GetErrMsg获取错误信息)
+  bool Next(ReadAheadPart* part);
+
+  // 归还分块占用的缓冲区, 供读线程复用
+  void Release(const unsigned char* buf);
+
+  // 停止并等待读线程退出
+  void Stop();
+
+  std::string GetErrMsg() const;
+
+ private:
+  void ReaderLoop();
+  bool ReadPart(uint64_t offset, unsigned char* buf, size_t len,
+                std::string* err_msg);
+  bool StartThreads();
+  // 将缓冲区归还给全局缓冲区池
+  void ReleaseBuffers();
+
+  uint64_t m_file_size;
+  uint64_t m_part_size;
+  uint64_t m_part_count;
+  unsigned m_reader_num;
+
+  std::vector<unsigned char*> m_buffers;
+  std::vector<unsigned char*> m_free_buffers;
+  // 读取完成等待被取走的分块, key为part_number
+  std::map<uint64_t, ReadAheadPart> m_ready_parts;
+
+  uint64_t m_next_read_part;     // 下一个待读取的part_number
+  uint64_t m_next_deliver_part;  // 下一个交给调用方的part_number
+  bool m_stopped;
+  bool m_failed;
+  std::string m_err_msg;
+
+#if defined(_WIN32)
+  std::string m_path;
+  std::wstring m_wide_path;
+  bool m_is_wide_path;
+#else
+  int m_fd;
+#endif
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_buffer_cond;  // 有空闲缓冲区或停止
+  std::condition_variable m_ready_cond;   // 有分块读取完成或出错
+  std::vector<std::thread> m_readers;
+};
+
+}  // namespace qcloud_cos
@@ -7,7 +7,7 @@
 #include "request/object_req.h"
 #include "trsf/transfer_handler.h"
 #include "util/base_op_util.h"
-#include "util/semaphore.h"
+#include "util/completion_queue.h"
 #include "util/task.h"
 
 namespace qcloud_cos {
@@ -98,8 +98,16 @@ class FileUploadTask : public Poco::Runnable {
     mb_check_crc64 = check_crc64;
   }
 
-  // 设置信号量，用于任务完成时自动释放资源槽位
-  void SetSemaphore(Semaphore* semaphore) { m_semaphore = semaphore; }
+  // 未开启分块crc64校验时, 是否仍需计算分块的crc64(用于合并整个文件的crc64)
+  void SetCalcCrc64(bool calc_crc64) {
+    mb_calc_crc64 = calc_crc64;
+  }
+
+  // 设置完成队列及任务槽位下标，任务完成时推入队列通知调度线程
+  void SetCompletionQueue(CompletionQueue* queue, unsigned slot) {
+    m_completion_queue = queue;
+    m_slot = slot;
+  }
 
   // 设置当前任务在上传序列中的顺序号
   void SetSequence(uint64_t sequence) { m_task_info.sequence = sequence; }
@@ -144,9 +152,11 @@ class FileUploadTask : public Poco::Runnable {
   void *m_user_data;
 
   bool mb_check_crc64;
+  bool mb_calc_crc64;
   uint64_t m_crc64_value;
 
-  Semaphore* m_semaphore;
+  CompletionQueue* m_completion_queue;
+  unsigned m_slot;
   TaskInfo m_task_info;
 
   BaseOpUtil m_op_util;
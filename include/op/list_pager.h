@@ -0,0 +1,238 @@
+#ifndef COS_CPP_SDK_V5_INCLUDE_OP_LIST_PAGER_H_
+#define COS_CPP_SDK_V5_INCLUDE_OP_LIST_PAGER_H_
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "op/cos_result.h"
+#include "request/bucket_req.h"
+#include "response/bucket_resp.h"
+#include "util/noncopyable.h"
+
+namespace qcloud_cos {
+
+/// \brief 各类列出请求的翻页方式: 根据本页响应设置下一页的marker,
+/// 没有下一页时返回false
+template <typename ReqT, typename RespT>
+struct ListPageTraits;
+
+template <>
+struct ListPageTraits<GetBucketReq, GetBucketResp> {
+  static bool Advance(const GetBucketResp& resp, GetBucketReq* req) {
+    if (!resp.IsTruncated()) {
+      return false;
+    }
+    std::string marker = resp.GetNextMarker();
+    if (marker.empty()) {
+      // 未指定delimiter时部分情况下不返回NextMarker, 使用本页最后一个key
+      const std::vector<Content> contents = resp.GetContents();
+      if (contents.empty()) {
+        return false;
+      }
+      marker = contents.back().m_key;
+    }
+    req->SetMarker(marker);
+    return true;
+  }
+};
+
+template <>
+struct ListPageTraits<GetBucketObjectVersionsReq, GetBucketObjectVersionsResp> {
+  static bool Advance(const GetBucketObjectVersionsResp& resp,
+                      GetBucketObjectVersionsReq* req) {
+    if (!resp.IsTruncated()) {
+      return false;
+    }
+    const std::string key_marker = resp.GetNextKeyMarker();
+    const std::string version_id_marker = resp.GetNextVersionIdMarker();
+    // 截断但未返回下一页的marker时无法继续, 避免重复列出同一页
+    if (key_marker.empty() && version_id_marker.empty()) {
+      return false;
+    }
+    req->SetKeyMarker(key_marker);
+    req->SetVersionIdMarker(version_id_marker);
+    return true;
+  }
+};
+
+template <>
+struct ListPageTraits<ListMultipartUploadReq, ListMultipartUploadResp> {
+  static bool Advance(const ListMultipartUploadResp& resp,
+                      ListMultipartUploadReq* req) {
+    if (!resp.IsTruncated()) {
+      return false;
+    }
+    const std::string key_marker = resp.GetNextKeyMarker();
+    const std::string upload_id_marker = resp.GetNextUploadIdMarker();
+    // 同上, 没有下一页的marker时结束列出
+    if (key_marker.empty() && upload_id_marker.empty()) {
+      return false;
+    }
+    req->SetKeyMarker(key_marker);
+    req->SetUploadIdMarker(upload_id_marker);
+    return true;
+  }
+};
+
+/// \brief 分页列出结果的迭代器, 调用方处理当前页时后台线程预取后续页面
+/// 预取的页面数不超过prefetch_pages, 失败的请求由list_func负责重试;
+/// 析构时取消预取并等待正在进行的请求结束
+///
+/// 用法:
+///   while (pager->Next(&page)) { ... }
+///   或 for (const GetBucketResp& page : *pager) { ... }
+///   结束后通过GetResult判断是否因失败提前结束
+template <typename ReqT, typename RespT>
+class ListPager : private NonCopyable {
+ public:
+  /// \brief 执行一次列出请求
+  typedef std::function<CosResult(const ReqT& req, RespT* resp)> ListFunc;
+
+  /// \brief 按页遍历的输入迭代器
+  class PageIterator {
+   public:
+    PageIterator() : m_pager(nullptr) {}
+    explicit PageIterator(ListPager* pager) : m_pager(pager) { ++*this; }
+
+    const RespT& operator*() const { return m_page; }
+    const RespT* operator->() const { return &m_page; }
+
+    PageIterator& operator++() {
+      if (!m_pager->Next(&m_page)) {
+        m_pager = nullptr;
+      }
+      return *this;
+    }
+
+    bool operator==(const PageIterator& other) const {
+      return m_pager == other.m_pager;
+    }
+    bool operator!=(const PageIterator& other) const {
+      return m_pager != other.m_pager;
+    }
+
+   private:
+    ListPager* m_pager;
+    RespT m_page;
+  };
+
+  /// \param list_func      执行列出请求的函数
+  /// \param req            第一页的请求, 后续页面在其基础上设置marker
+  /// \param prefetch_pages 最多预取并缓存的页面数, 至少为1
+  ListPager(const ListFunc& list_func, const ReqT& req, unsigned prefetch_pages)
+      : m_list_func(list_func),
+        m_req(req),
+        m_max_pages(prefetch_pages < 1 ? 1 : prefetch_pages),
+        m_finished(false),
+        m_cancelled(false) {
+    m_result.SetSucc();
+    m_thread = std::thread(&ListPager::PrefetchLoop, this);
+  }
+
+  ~ListPager() {
+    Cancel();
+    m_thread.join();
+  }
+
+  /// \brief 取出下一页, 需要时阻塞等待预取完成
+  /// \return 没有更多页面、列出失败或已取消时返回false
+  bool Next(RespT* page) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cond.wait(lock, [this]() {
+      return !m_pages.empty() || m_finished || m_cancelled;
+    });
+    if (m_cancelled || m_pages.empty()) {
+      return false;
+    }
+    *page = std::move(m_pages.front());
+    m_pages.pop_front();
+    m_cond.notify_all();
+    return true;
+  }
+
+  /// \brief 停止预取并丢弃已缓存的页面, 正在进行的请求结束后不再发起新请求
+  void Cancel() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_cancelled = true;
+      m_pages.clear();
+    }
+    m_cond.notify_all();
+  }
+
+  /// \brief 列出失败时返回失败请求的结果, 否则返回成功
+  CosResult GetResult() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_result;
+  }
+
+  PageIterator begin() { return PageIterator(this); }
+  PageIterator end() { return PageIterator(); }
+
+ private:
+  void PrefetchLoop() {
+    ReqT req = m_req;
+    bool has_more = true;
+    while (has_more) {
+      RespT page;
+      CosResult result = m_list_func(req, &page);
+      has_more =
+          result.IsSucc() && ListPageTraits<ReqT, RespT>::Advance(page, &req);
+
+      std::unique_lock<std::mutex> lock(m_mutex);
+      if (!result.IsSucc()) {
+        m_result = result;
+        break;
+      }
+      // 缓存已满时等待调用方取走页面
+      m_cond.wait(lock, [this]() {
+        return m_cancelled || m_pages.size() < m_max_pages;
+      });
+      if (m_cancelled) {
+        break;
+      }
+      m_pages.push_back(std::move(page));
+      m_cond.notify_all();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_finished = true;
+    }
+    m_cond.notify_all();
+  }
+
+  ListFunc m_list_func;
+  ReqT m_req;
+  size_t m_max_pages;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  std::deque<RespT> m_pages;
+  bool m_finished;
+  bool m_cancelled;
+  CosResult m_result;
+  std::thread m_thread;
+};
+
+typedef ListPager<GetBucketReq, GetBucketResp> GetBucketPager;
+typedef ListPager<GetBucketObjectVersionsReq, GetBucketObjectVersionsResp>
+    GetBucketObjectVersionsPager;
+typedef ListPager<ListMultipartUploadReq, ListMultipartUploadResp>
+    ListMultipartUploadPager;
+
+typedef std::shared_ptr<GetBucketPager> SharedGetBucketPager;
+typedef std::shared_ptr<GetBucketObjectVersionsPager>
+    SharedGetBucketObjectVersionsPager;
+typedef std::shared_ptr<ListMultipartUploadPager> SharedListMultipartUploadPager;
+
+}  // namespace qcloud_cos
+#endif  // COS_CPP_SDK_V5_INCLUDE_OP_LIST_PAGER_H_
@@ -16,6 +16,7 @@
 #include "response/data_process_resp.h"
 #include "response/object_resp.h"
 #include "response/auditing_resp.h"
+#include "util/select_event_decoder.h"
 
 
 namespace qcloud_cos {
@@ -32,6 +33,17 @@ public:
   }
 };
 
+/// \brief 断点下载的分片完成情况, 记录在断点下载任务文件中
+class ResumableDownloadSlices {
+public:
+  uint64_t slice_size;
+  std::vector<bool> done;       // 各分片是否已下载完成
+  std::vector<uint64_t> crc64;  // 各分片的CRC64, 未完成的分片为0
+
+public:
+  ResumableDownloadSlices() : slice_size(0) {}
+};
+
 class FileUploadTask;
 class FileCopyTask;
 
@@ -296,6 +308,13 @@ class ObjectOp : public BaseOp {
                                 SelectObjectContentResp* resp,
                                 bool change_backup_domain = false);
 
+  /// \brief 流式SELECT, 响应边接收边解码, 每个事件校验CRC后立即回调handler,
+  ///        不缓存响应正文; 已回调过事件的请求失败后不再重试
+  CosResult SelectObjectContent(const SelectObjectContentReq& req,
+                                SelectEventHandler* handler,
+                                SelectObjectContentResp* resp,
+                                bool change_backup_domain = false);
+
   CosResult AppendObject(const AppendObjectReq& req, AppendObjectResp* resp);
 
   /// \brief 创建推流通道
@@ -459,7 +478,7 @@ class ObjectOp : public BaseOp {
                       const std::string& path, unsigned char* file_content_buf,
                       uint64_t len, uint64_t part_number,
                       FileUploadTask* task_ptr, bool sign_header_host,
-                      bool check_crc64);
+                      bool check_crc64, bool calc_crc64);
 
   void FillCopyTask(const std::string& upload_id, const std::string& host,
                     const std::string& path, uint64_t part_number,
@@ -471,23 +490,22 @@ class ObjectOp : public BaseOp {
                     FileCopyTask* task, bool sign_header_host);
 
   /// \brief 检查是否可以走断点下载
-  /// \param req  PutObjectByFile请求
-  /// \param head_resp  HeadObjectResp响应结果
-  /// \param last_offset 返回的上一次下载偏移量
+  /// \param json_file  json文件名
+  /// \param element_map  需要与对象当前属性一致的元素映射
+  /// \param slices 返回上一次下载的分片大小、已完成的分片及其CRC64
   /// \return true可以走断点下载,false表示不可以
   bool CheckResumableDownloadTask(
       const std::string& json_file,
       const std::map<std::string, std::string>& element_map,
-      uint64_t* resume_offset);
+      ResumableDownloadSlices* slices);
   /// \brief 更新断点下载json文件
   /// \param json_file  json文件名
   /// \param element_map  检查的元素映射
-  /// \param last_offset 返回的上一次下载偏移量
-  /// \return true文件检查成功, 否则失败
+  /// \param slices 分片大小、已完成的分片及其CRC64
   void UpdateResumableDownloadTaskFile(
       const std::string& json_file,
       const std::map<std::string, std::string>& element_map,
-      uint64_t resume_offset);
+      const ResumableDownloadSlices& slices);
   void SetResultAndLogError(CosResult& result, const std::string& err_msg);
 
   /// \brief 获取有效的 checkpoint 目录
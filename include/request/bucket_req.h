@@ -126,6 +126,58 @@ class GetBucketReq : public BucketReq {
   }
 };
 
+/// \brief 并行列出时的结果回调, 每次传入一批对象, 返回false时停止列出
+using ListContentsCallback = std::function<bool(const std::vector<Content>& contents)>;
+
+/// \brief 并行列出Bucket下指定前缀的全部对象
+/// 先不带delimiter列出一页, 对象较少时直接返回; 否则以"/"为delimiter拆分出子前缀,
+/// 各子前缀并发列出, 并按同样的方式递归拆分较大的子前缀
+class ParallelGetBucketReq {
+ public:
+  ParallelGetBucketReq(const std::string& bucket_name, const std::string& prefix)
+      : m_bucket_name(bucket_name), m_prefix(prefix),
+        m_concurrency(kDefaultParallelListConcurrency), m_ordered(false),
+        m_max_buffered_keys(kDefaultParallelListMaxBufferedKeys) {
+    if (!IllegalIntercept::CheckBucket(bucket_name)) {
+      throw std::invalid_argument("Invalid bucket_name argument :" + bucket_name);
+    }
+  }
+  virtual ~ParallelGetBucketReq() {}
+
+  std::string GetBucketName() const { return m_bucket_name; }
+
+  std::string GetPrefix() const { return m_prefix; }
+
+  /// \brief 设置同时进行的列出请求数, 默认8
+  void SetConcurrency(unsigned concurrency) {
+    m_concurrency = concurrency < 1 ? 1 : concurrency;
+  }
+
+  unsigned GetConcurrency() const { return m_concurrency; }
+
+  /// \brief 设置是否按key的字典序回调结果, 默认false
+  /// 有序输出时需要缓存尚未轮到回调的子前缀结果, 内存占用高于无序输出
+  void SetOrdered(bool ordered) { m_ordered = ordered; }
+
+  bool IsOrdered() const { return m_ordered; }
+
+  /// \brief 设置有序输出时最多缓存的尚未回调的对象数, 默认100000
+  /// 超过后暂停列出后面的子前缀, 等回调消费后再继续; 正在回调的前缀不受限制,
+  /// 实际缓存最多再多出concurrency页及当前回调路径上每层前缀各一页
+  void SetMaxBufferedKeys(uint64_t max_buffered_keys) {
+    m_max_buffered_keys = max_buffered_keys < 1 ? 1 : max_buffered_keys;
+  }
+
+  uint64_t GetMaxBufferedKeys() const { return m_max_buffered_keys; }
+
+ private:
+  std::string m_bucket_name;
+  std::string m_prefix;
+  unsigned m_concurrency;
+  bool m_ordered;
+  uint64_t m_max_buffered_keys;
+};
+
 class ListMultipartUploadReq : public BucketReq {
  public:
   explicit ListMultipartUploadReq(const std::string& bucket_name)
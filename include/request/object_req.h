@@ -31,7 +31,7 @@ class ObjectReq : public BaseReq {
     SetObjectName(object_name);
   }
 
-  ObjectReq() {}
+  ObjectReq() : m_progress_cb(NULL), m_done_cb(NULL), m_user_data(NULL) {}
 
   virtual ~ObjectReq() {}
 
@@ -1859,7 +1859,8 @@ class PutObjectsByDirectoryReq : public PutObjectReq {
   PutObjectsByDirectoryReq(const std::string& bucket_name,
                            const std::string& directory_name)
       : m_bucket_name(bucket_name), m_directory_name(directory_name),
-        m_cos_path("") {
+        m_cos_path(""), m_concurrency(1),
+        m_multi_upload_threshold(kDefaultMultiUploadThreshold) {
     if (!IllegalIntercept::CheckBucket(bucket_name)) {
       throw std::invalid_argument("Invalid bucket_name argument :" + bucket_name);
     }
@@ -1870,7 +1871,8 @@ class PutObjectsByDirectoryReq : public PutObjectReq {
                            const std::string& directory_name,
                            const std::string& cos_path)
       : m_bucket_name(bucket_name), m_directory_name(directory_name),
-        m_cos_path(cos_path) {
+        m_cos_path(cos_path), m_concurrency(1),
+        m_multi_upload_threshold(kDefaultMultiUploadThreshold) {
     if (!IllegalIntercept::CheckBucket(bucket_name)) {
       throw std::invalid_argument("Invalid bucket_name argument :" + bucket_name);
     }
@@ -1894,12 +1896,31 @@ class PutObjectsByDirectoryReq : public PutObjectReq {
 
   bool ShouldComputeContentMd5() const { return m_need_compute_contentmd5; }
 
+  /// \brief 设置同时上传的文件数, 默认1
+  void SetConcurrency(unsigned concurrency) {
+    m_concurrency = concurrency < 1 ? 1 : concurrency;
+  }
+
+  unsigned GetConcurrency() const { return m_concurrency; }
+
+  /// \brief 设置使用分块上传的文件大小阈值, 不小于该大小的文件使用分块上传,
+  ///        默认16MB
+  void SetMultiUploadThreshold(uint64_t threshold) {
+    m_multi_upload_threshold = threshold;
+  }
+
+  uint64_t GetMultiUploadThreshold() const { return m_multi_upload_threshold; }
+
+  // SetTransferProgressCallback设置的进度回调汇总整个目录, 传入的是所有文件的累计大小
+
  private:
   // TODO 支持前缀和后缀
   std::string m_bucket_name;
   std::string m_directory_name;
   std::string m_cos_path;
   bool m_need_compute_contentmd5;
+  unsigned m_concurrency;
+  uint64_t m_multi_upload_threshold;
 };
 
 class PutDirectoryReq : public PutObjectReq {
@@ -1940,7 +1961,9 @@ class DeleteObjectsByPrefixReq {
  public:
   DeleteObjectsByPrefixReq(const std::string& bucket_name,
                            const std::string& prefix)
-      : m_bucket_name(bucket_name), m_prefix(prefix) {
+      : m_bucket_name(bucket_name), m_prefix(prefix),
+        m_batch_size(kMaxDeleteObjectsBatchSize),
+        m_concurrency(kDefaultDeleteObjectsConcurrency) {
         if (!IllegalIntercept::CheckBucket(bucket_name)) {
           throw std::invalid_argument("Invalid bucket_name argument :" + bucket_name);
         }
@@ -1951,9 +1974,167 @@ class DeleteObjectsByPrefixReq {
 
   std::string GetPrefix() const { return m_prefix; }
 
+  /// \brief 设置每个批量删除请求包含的对象数, 取值1~1000, 默认1000
+  void SetBatchSize(unsigned batch_size) {
+    if (batch_size < 1) {
+      batch_size = 1;
+    } else if (batch_size > kMaxDeleteObjectsBatchSize) {
+      batch_size = kMaxDeleteObjectsBatchSize;
+    }
+    m_batch_size = batch_size;
+  }
+
+  unsigned GetBatchSize() const { return m_batch_size; }
+
+  /// \brief 设置同时进行的批量删除请求数, 默认4
+  void SetConcurrency(unsigned concurrency) {
+    m_concurrency = concurrency < 1 ? 1 : concurrency;
+  }
+
+  unsigned GetConcurrency() const { return m_concurrency; }
+
+ private:
+  std::string m_bucket_name;
+  std::string m_prefix;
+  unsigned m_batch_size;
+  unsigned m_concurrency;
+};
+
+class GetObjectsByPrefixReq {
+ public:
+  /// \param prefix 对象前缀, 对象下载到local_dir下去掉前缀后的相对路径
+  GetObjectsByPrefixReq(const std::string& bucket_name,
+                        const std::string& prefix,
+                        const std::string& local_dir)
+      : m_bucket_name(bucket_name), m_prefix(prefix), m_local_dir(local_dir),
+        m_concurrency(kDefaultGetObjectsConcurrency),
+        m_multi_download_threshold(kDefaultMultiDownloadThreshold),
+        m_skip_identical(false), m_progress_cb(NULL), m_done_cb(NULL),
+        m_user_data(NULL) {
+    if (!IllegalIntercept::CheckBucket(bucket_name)) {
+      throw std::invalid_argument("Invalid bucket_name argument :" + bucket_name);
+    }
+  }
+  virtual ~GetObjectsByPrefixReq() {}
+
+  std::string GetBucketName() const { return m_bucket_name; }
+
+  std::string GetPrefix() const { return m_prefix; }
+
+  std::string GetLocalDir() const { return m_local_dir; }
+
+  /// \brief 设置同时下载的对象数, 默认4
+  void SetConcurrency(unsigned concurrency) {
+    m_concurrency = concurrency < 1 ? 1 : concurrency;
+  }
+
+  unsigned GetConcurrency() const { return m_concurrency; }
+
+  /// \brief 设置使用多线程下载的对象大小阈值, 不小于该大小的对象使用多线程下载,
+  ///        默认16MB
+  void SetMultiDownloadThreshold(uint64_t threshold) {
+    m_multi_download_threshold = threshold;
+  }
+
+  uint64_t GetMultiDownloadThreshold() const {
+    return m_multi_download_threshold;
+  }
+
+  /// \brief 本地文件与对象大小相同且ETag(MD5)或CRC64一致时跳过下载, 默认关闭
+  void SetSkipIdentical(bool skip_identical) { m_skip_identical = skip_identical; }
+
+  bool IsSkipIdentical() const { return m_skip_identical; }
+
+  /// @brief  设置进度回调函数, 传入的是所有对象的累计大小
+  void SetTransferProgressCallback(const TransferProgressCallback& process_cb) {
+    m_progress_cb = process_cb;
+  }
+  /// @brief  设置完成回调函数, 所有对象处理完成后回调一次
+  void SetDoneCallback(const DoneCallback& done_cb) { m_done_cb = done_cb; }
+  /// @brief 设置回调私有数据
+  void SetUserData(void* user_data) { m_user_data = user_data; }
+
+  TransferProgressCallback GetTransferProgressCallback() const {
+    return m_progress_cb;
+  }
+  DoneCallback GetDoneCallback() const { return m_done_cb; }
+  void* GetUserData() const { return m_user_data; }
+
  private:
   std::string m_bucket_name;
   std::string m_prefix;
+  std::string m_local_dir;
+  unsigned m_concurrency;
+  uint64_t m_multi_download_threshold;
+  bool m_skip_identical;
+  TransferProgressCallback m_progress_cb;  // 进度回调
+  DoneCallback m_done_cb;                  // 完成回调
+  void* m_user_data;                       // 私有数据
+};
+
+class SyncDirectoryReq {
+ public:
+  /// \param cos_prefix 本地文件上传到cos_prefix下的相对路径,
+  ///        非空且不以'/'结尾时自动补充'/'
+  SyncDirectoryReq(const std::string& bucket_name,
+                   const std::string& local_dir,
+                   const std::string& cos_prefix)
+      : m_bucket_name(bucket_name), m_local_dir(local_dir),
+        m_cos_prefix(cos_prefix), m_manifest_file(""),
+        m_delete_remote(false),
+        m_concurrency(kDefaultSyncDirectoryConcurrency),
+        m_multi_upload_threshold(kDefaultMultiUploadThreshold) {
+    if (!IllegalIntercept::CheckBucket(bucket_name)) {
+      throw std::invalid_argument("Invalid bucket_name argument :" + bucket_name);
+    }
+    if (!m_cos_prefix.empty() &&
+        m_cos_prefix[m_cos_prefix.size() - 1] != '/') {
+      m_cos_prefix += "/";
+    }
+  }
+  virtual ~SyncDirectoryReq() {}
+
+  std::string GetBucketName() const { return m_bucket_name; }
+
+  std::string GetLocalDir() const { return m_local_dir; }
+
+  std::string GetCosPrefix() const { return m_cos_prefix; }
+
+  /// \brief 设置manifest文件路径, 记录本地文件的大小、修改时间和CRC64,
+  ///        再次同步时未变化的文件无需重新计算CRC64. 为空时不使用manifest
+  void SetManifestFile(const std::string& manifest_file) {
+    m_manifest_file = manifest_file;
+  }
+
+  std::string GetManifestFile() const { return m_manifest_file; }
+
+  /// \brief 是否删除cos上存在但本地已不存在的对象, 默认不删除
+  void SetDeleteRemote(bool delete_remote) { m_delete_remote = delete_remote; }
+
+  bool IsDeleteRemote() const { return m_delete_remote; }
+
+  /// \brief 设置同时处理的文件数, 默认4
+  void SetConcurrency(unsigned concurrency) {
+    m_concurrency = concurrency < 1 ? 1 : concurrency;
+  }
+
+  unsigned GetConcurrency() const { return m_concurrency; }
+
+  /// \brief 设置使用分块上传的文件大小阈值, 默认16MB
+  void SetMultiUploadThreshold(uint64_t threshold) {
+    m_multi_upload_threshold = threshold;
+  }
+
+  uint64_t GetMultiUploadThreshold() const { return m_multi_upload_threshold; }
+
+ private:
+  std::string m_bucket_name;
+  std::string m_local_dir;
+  std::string m_cos_prefix;
+  std::string m_manifest_file;
+  bool m_delete_remote;
+  unsigned m_concurrency;
+  uint64_t m_multi_upload_threshold;
 };
 
 }  // namespace qcloud_cos
\ No newline at end of file
@@ -39,6 +39,9 @@ class BaseResp {
     return *this;
   }
 
+  BaseResp(BaseResp&& rhs) = default;
+  BaseResp& operator=(BaseResp&& rhs) = default;
+
   virtual ~BaseResp() {}
 
   // debug使用
@@ -17,6 +17,7 @@
 #include "rapidxml/1.13/rapidxml_print.hpp"
 #include "rapidxml/1.13/rapidxml_utils.hpp"
 #include "response/base_resp.h"
+#include "util/compact_list_result.h"
 
 namespace qcloud_cos {
 
@@ -35,6 +36,10 @@ class HeadBucketResp : public BaseResp {
 class GetBucketResp : public BaseResp {
  public:
   GetBucketResp() {}
+  GetBucketResp(const GetBucketResp&) = default;
+  GetBucketResp(GetBucketResp&&) = default;
+  GetBucketResp& operator=(const GetBucketResp&) = default;
+  GetBucketResp& operator=(GetBucketResp&&) = default;
   virtual ~GetBucketResp() {}
 
   virtual bool ParseFromXmlString(const std::string& body);
@@ -71,6 +76,14 @@ class GetBucketResp : public BaseResp {
     return m_common_prefixes;
   }
 
+  /// \brief 将本页的Object元信息及Common Prefix追加到紧凑的列出结果中
+  void AppendTo(CompactListResult* result) const {
+    result->AppendContents(m_contents);
+    for (size_t i = 0; i < m_common_prefixes.size(); ++i) {
+      result->AppendCommonPrefix(m_common_prefixes[i]);
+    }
+  }
+
  private:
   std::vector<Content> m_contents;
   std::string m_name;
@@ -185,6 +198,10 @@ class GetBucketACLResp : public BaseResp {
 class ListMultipartUploadResp : public BaseResp {
  public:
   ListMultipartUploadResp() {}
+  ListMultipartUploadResp(const ListMultipartUploadResp&) = default;
+  ListMultipartUploadResp(ListMultipartUploadResp&&) = default;
+  ListMultipartUploadResp& operator=(const ListMultipartUploadResp&) = default;
+  ListMultipartUploadResp& operator=(ListMultipartUploadResp&&) = default;
   virtual ~ListMultipartUploadResp() {}
 
   virtual bool ParseFromXmlString(const std::string& body);
@@ -304,6 +321,10 @@ class GetBucketLocationResp : public BaseResp {
 class GetBucketObjectVersionsResp : public BaseResp {
  public:
   GetBucketObjectVersionsResp() {}
+  GetBucketObjectVersionsResp(const GetBucketObjectVersionsResp&) = default;
+  GetBucketObjectVersionsResp(GetBucketObjectVersionsResp&&) = default;
+  GetBucketObjectVersionsResp& operator=(const GetBucketObjectVersionsResp&) = default;
+  GetBucketObjectVersionsResp& operator=(GetBucketObjectVersionsResp&&) = default;
   virtual ~GetBucketObjectVersionsResp() {}
 
   /// \brief 编码格式
@@ -327,10 +348,18 @@ class GetBucketObjectVersionsResp : public BaseResp {
 
   std::string GetVersionIdMarker() const { return m_version_id_marker; }
 
+  /// \brief 假如返回条目被截断，则返回 NextVersionIdMarker 与 NextKeyMarker 共同指定下一个条目的起点
+  std::string GetNextVersionIdMarker() const { return m_next_version_id_marker; }
+
   std::vector<COSVersionSummary> GetVersionSummary() const {
     return m_summaries;
   }
 
+  /// \brief 将本页的多版本信息追加到紧凑的列出结果中
+  void AppendTo(CompactListResult* result) const {
+    result->AppendVersionSummaries(m_summaries);
+  }
+
   virtual bool ParseFromXmlString(const std::string& body);
 
  private:
@@ -513,6 +513,11 @@ class SelectObjectContentResp : public BaseResp {
   /// \brief 打印最终结果至终端
   void PrintResult() const;
 
+  /// \brief 获取按顺序解析出的事件消息
+  const std::vector<SelectMessage>& GetSelectMessages() const {
+    return resp_data;
+  }
+
  private:
   // void ParseStatsEvent(const std::string& stat_str);
   // void ParseProgressEvent(const std::string& prog_str);
@@ -736,8 +741,20 @@ class PutObjectsByDirectoryResp {
     std::string m_object_name;  // 对象名
     BaseResp m_cos_resp;        // cos返回的响应
   };
+  class PutFailResp {
+   public:
+    PutFailResp() : m_http_status(-1) {}
+    virtual ~PutFailResp() {}
+    std::string m_file_name;    // 本地文件名
+    std::string m_object_name;  // 对象名
+    int m_http_status;          // http状态码, 网络错误时小于0
+    std::string m_err_code;     // cos返回的错误码
+    std::string m_err_msg;      // 错误信息
+  };
   // 成功上传的对象
   std::vector<PutResp> m_succ_put_objs;
+  // 上传失败的文件
+  std::vector<PutFailResp> m_fail_put_objs;
 };
 
 class PutDirectoryResp : public PutObjectResp {
@@ -757,6 +774,47 @@ class DeleteObjectsByPrefixResp {
   DeleteObjectsByPrefixResp() {}
   virtual ~DeleteObjectsByPrefixResp() {}
   std::vector<std::string> m_succ_del_objs;  // 成功删除的对象
+  std::vector<ErrorInfo> m_fail_del_objs;    // 删除失败的对象及原因
+};
+
+class GetObjectsByPrefixResp {
+ public:
+  GetObjectsByPrefixResp() {}
+  virtual ~GetObjectsByPrefixResp() {}
+
+ public:
+  class GetResp {
+   public:
+    GetResp() : m_skipped(false) {}
+    virtual ~GetResp() {}
+    std::string m_object_name;  // 对象名
+    std::string m_file_name;    // 本地文件名
+    bool m_skipped;             // 本地文件与对象一致, 未重新下载
+  };
+  class GetFailResp {
+   public:
+    GetFailResp() : m_http_status(-1) {}
+    virtual ~GetFailResp() {}
+    std::string m_object_name;  // 对象名
+    std::string m_file_name;    // 本地文件名
+    int m_http_status;          // http状态码, 网络错误时小于0
+    std::string m_err_code;     // cos返回的错误码
+    std::string m_err_msg;      // 错误信息
+  };
+  // 成功下载或跳过的对象
+  std::vector<GetResp> m_succ_get_objs;
+  // 下载失败的对象
+  std::vector<GetFailResp> m_fail_get_objs;
+};
+
+class SyncDirectoryResp {
+ public:
+  SyncDirectoryResp() {}
+  virtual ~SyncDirectoryResp() {}
+  std::vector<std::string> m_uploaded_objs;   // 新增或变化后上传的对象
+  std::vector<std::string> m_unchanged_objs;  // 未变化而跳过的对象
+  std::vector<std::string> m_deleted_objs;    // 本地已不存在而删除的对象
+  std::vector<ErrorInfo> m_fail_objs;         // 上传或删除失败的对象及原因
 };
 
 }  // namespace qcloud_cos
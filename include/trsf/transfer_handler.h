@@ -208,6 +208,12 @@ class HandleStreamCopier {
                                           const char *buf, size_t buf_len,
                                           std::ostream& ostr,
                                           std::size_t bufferSize = 8192);
+
+  // 直接读取到调用方提供的缓冲区, 最多读取buf_len字节
+  static std::streamsize handleCopyStream(const SharedTransferHandler& handler,
+                                          std::istream& istr,
+                                          char *buf, size_t buf_len,
+                                          std::size_t bufferSize = 8192);
 };
 
 class UserCancelException : public std::exception {
@@ -216,6 +222,11 @@ class UserCancelException : public std::exception {
   ~UserCancelException() throw() {}
 };
 
+/// @brief 批量传输时创建单个文件的handler, 文件的累计进度转换为增量后交给
+/// report汇总, report在handler的进度锁内调用
+SharedTransferHandler NewFileProgressHandler(
+    uint64_t file_size, const std::function<void(uint64_t delta)>& report);
+
 }  // namespace qcloud_cos
 
 #endif  // COS_CPP_SDK_V5_INCLUDE_TRSF_TRANSFER_HANDLER_H_
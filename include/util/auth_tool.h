@@ -59,25 +59,6 @@ class AuthTool : private NonCopyable {
                               const std::string& channel,
                               const std::map<std::string, std::string>& params,
                               uint64_t expire);
-
- private:
-  /// \brief 把params中的数据，转小写，正排,key放在param_list
-  /// key=value放param_value_list \param params 参数 \param key_encode
-  /// key是否进行uri编码 \param value_encode value是否进行uri编码 \param
-  /// value_lower value是否小写 \param param_list 参数名列表，以;分隔 \param
-  /// param_value_list 参数键值对列表,以&分隔 \retval     无
-  static void FillMap(const std::map<std::string, std::string>& params,
-                      bool key_encode, bool value_encode, bool value_lower,
-                      std::string* param_list, std::string* param_value_list);
-
-  /// \brief 找出需要鉴权的头部，并设置,目前host conent-type 还有x开头的都要鉴权
-  /// \param hedaers 头部的kv对
-  /// \param filted_req_headers 需要鉴权的头部
-  /// \retval 无
-  static void FilterAndSetSignHeader(
-      const std::map<std::string, std::string>& headers,
-      std::map<std::string, std::string>* filted_req_headers,
-      const std::unordered_set<std::string>& not_sign_headers);
 };
 
 }  // namespace qcloud_cos
@@ -0,0 +1,72 @@
+#ifndef COS_CPP_SDK_V5_INCLUDE_UTIL_BUFFER_POOL_H_
+#define COS_CPP_SDK_V5_INCLUDE_UTIL_BUFFER_POOL_H_
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "util/noncopyable.h"
+
+namespace qcloud_cos {
+
+/// \brief 分块/分片缓冲区池, 线程安全
+/// 申请大小按规格向上取整(每个2的幂区间分4档), 按页对齐分配, 释放后按规格缓存复用
+/// max_cached_bytes为池内保留内存(使用中+缓存)的上限, 超过上限时释放的缓冲区直接归还系统;
+/// 申请不会因为上限阻塞或失败, 超限的申请计入over_limit_count
+class BufferPool : private NonCopyable {
+ public:
+  struct Stats {
+    uint64_t acquire_count;     // 申请次数
+    uint64_t reuse_count;       // 命中缓存的申请次数
+    uint64_t over_limit_count;  // 申请后使用中内存超过上限的次数
+    uint64_t bytes_in_use;      // 使用中的内存
+    uint64_t bytes_cached;      // 缓存中的内存
+    uint64_t peak_bytes_in_use;  // 使用中内存的峰值
+  };
+
+  /// \param max_cached_bytes 池内保留内存上限, 0表示不缓存
+  /// \param use_huge_page 大缓冲区按2M对齐并建议内核使用透明大页
+  BufferPool(uint64_t max_cached_bytes, bool use_huge_page);
+  ~BufferPool();
+
+  /// \brief 申请至少size字节的缓冲区, 分配失败时返回nullptr
+  unsigned char* Acquire(size_t size);
+
+  /// \brief 归还Acquire得到的缓冲区, nullptr直接忽略
+  void Release(unsigned char* buf);
+
+  /// \brief 释放所有缓存的缓冲区
+  void Trim();
+
+  Stats GetStats();
+
+  void SetMaxCachedBytes(uint64_t max_cached_bytes);
+  void SetUseHugePage(bool use_huge_page);
+
+  /// \brief 获取size所属的规格大小
+  static size_t GetSizeClass(size_t size);
+
+ private:
+  static unsigned char* Allocate(size_t size_class, bool huge_page);
+  static void Free(unsigned char* buf);
+  // 缓存超过上限时淘汰最大规格的缓冲区, 需持有m_mutex
+  void ShrinkLocked(std::vector<unsigned char*>* freed);
+
+  std::mutex m_mutex;
+  uint64_t m_max_cached_bytes;
+  bool m_use_huge_page;
+  std::map<size_t, std::vector<unsigned char*>> m_free_lists;
+  // 池分配的所有缓冲区(使用中及缓存中)及其规格
+  std::unordered_map<unsigned char*, size_t> m_buffers;
+  Stats m_stats;
+};
+
+/// \brief 全局缓冲区池, 参数取自CosSysConfig
+BufferPool& GetGlobalBufferPool();
+
+}  // namespace qcloud_cos
+#endif  // COS_CPP_SDK_V5_INCLUDE_UTIL_BUFFER_POOL_H_
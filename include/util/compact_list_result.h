@@ -0,0 +1,181 @@
+#ifndef COS_CPP_SDK_V5_INCLUDE_UTIL_COMPACT_LIST_RESULT_H_
+#define COS_CPP_SDK_V5_INCLUDE_UTIL_COMPACT_LIST_RESULT_H_
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cos_defines.h"
+#include "util/list_xml_parser.h"
+
+namespace qcloud_cos {
+
+/// \brief 紧凑的列出结果, 用于保存数量巨大(千万级)的列出条目
+/// key/ETag/VersionId按条目顺序存放在同一块连续内存中, 32位十六进制的ETag
+/// 按16字节二进制存放; StorageClass、Owner等重复度高的字段去重后只保存下标;
+/// 大小和修改时间保存为数值. 每个条目的固定开销约40字节, 需要时再转换为
+/// Content/COSVersionSummary
+///
+/// 可以作为ListXmlHandler直接接收StreamGetBucket的解析结果, 也可以追加
+/// GetBucketResp/GetBucketObjectVersionsResp以及ParallelGetBucket回调的结果
+class CompactListResult : public ListXmlHandler {
+ public:
+  CompactListResult();
+  virtual ~CompactListResult() {}
+
+  /// \brief 条目数量
+  size_t Size() const { return m_sizes.size(); }
+
+  bool Empty() const { return m_sizes.empty(); }
+
+  void Clear();
+
+  /// \brief 预留entry_num个条目及arena_bytes字节的字符串空间, 避免扩容时的拷贝
+  void Reserve(size_t entry_num, size_t arena_bytes);
+
+  /// \brief 释放预留的多余空间
+  void ShrinkToFit();
+
+  /// \brief 当前占用的内存字节数(按容量估算)
+  size_t MemoryUsage() const;
+
+  void Append(const ListEntry& entry);
+  void Append(const Content& content);
+  void Append(const COSVersionSummary& summary);
+  void AppendContents(const std::vector<Content>& contents);
+  void AppendVersionSummaries(const std::vector<COSVersionSummary>& summaries);
+  void AppendCommonPrefix(const std::string& prefix);
+
+  /// \brief 只保留前entry_num个条目
+  void Truncate(size_t entry_num);
+
+  /// \brief 确认当前页的条目, 之后OnReset只丢弃新追加的条目
+  void CommitPage();
+
+  // ListXmlHandler, 请求重试时丢弃未确认页面的条目
+  void OnReset() override;
+  void OnEntry(const ListEntry& entry) override { Append(entry); }
+  void OnCommonPrefix(const std::string& prefix) override {
+    AppendCommonPrefix(prefix);
+  }
+
+  std::string GetKey(size_t index) const;
+  std::string GetETag(size_t index) const;
+  std::string GetVersionId(size_t index) const;
+  uint64_t GetSize(size_t index) const { return m_sizes[index]; }
+  /// \brief UTC毫秒时间戳
+  int64_t GetLastModifiedMs(size_t index) const {
+    return m_last_modified_ms[index];
+  }
+  /// \brief "2017-06-23T12:33:27.000Z"格式的修改时间
+  std::string GetLastModified(size_t index) const;
+  const std::string& GetStorageClass(size_t index) const {
+    return m_attrs.Get(m_attr_ids[index]).storage_class;
+  }
+  const std::string& GetStorageTier(size_t index) const {
+    return m_attrs.Get(m_attr_ids[index]).storage_tier;
+  }
+  const std::string& GetRestoreStatus(size_t index) const {
+    return m_attrs.Get(m_attr_ids[index]).restore_status;
+  }
+  const std::string& GetOwnerId(size_t index) const {
+    return m_owners.Get(m_owner_ids[index]).m_id;
+  }
+  const std::string& GetOwnerDisplayName(size_t index) const {
+    return m_owners.Get(m_owner_ids[index]).m_display_name;
+  }
+  bool IsLatest(size_t index) const {
+    return (m_flags[index] & kFlagLatest) != 0;
+  }
+  bool IsDeleteMarker(size_t index) const {
+    return (m_flags[index] & kFlagDeleteMarker) != 0;
+  }
+
+  /// \brief 转换为GetBucket结果的Content
+  void GetContent(size_t index, Content* content) const;
+
+  /// \brief 转换为GetBucketObjectVersions结果的COSVersionSummary
+  void GetVersionSummary(size_t index, COSVersionSummary* summary) const;
+
+  const std::vector<std::string>& GetCommonPrefixes() const {
+    return m_common_prefixes;
+  }
+
+ private:
+  enum EntryFlag {
+    kFlagLatest = 0x01,
+    kFlagDeleteMarker = 0x02,
+    kFlagETagPacked = 0x04,  // ETag按二进制存放
+  };
+
+  /// \brief 存储类型相关的字段, 组合后去重
+  struct StorageAttr {
+    std::string storage_class;
+    std::string storage_tier;
+    std::string restore_status;
+  };
+
+  /// \brief 去重表, 相同key的取值只保存一份, 下标0为空值
+  template <typename T>
+  class InternTable {
+   public:
+    InternTable() { Clear(); }
+
+    uint32_t Intern(const std::string& key, const T& value) {
+      typename std::unordered_map<std::string, uint32_t>::const_iterator itr =
+          m_index.find(key);
+      if (itr != m_index.end()) {
+        return itr->second;
+      }
+      uint32_t id = static_cast<uint32_t>(m_values.size());
+      m_values.push_back(value);
+      m_index[key] = id;
+      return id;
+    }
+
+    const T& Get(uint32_t id) const { return m_values[id]; }
+
+    void Clear() {
+      m_values.assign(1, T());
+      m_index.clear();
+    }
+
+    size_t Count() const { return m_values.size(); }
+
+   private:
+    std::vector<T> m_values;
+    std::unordered_map<std::string, uint32_t> m_index;
+  };
+
+  void AppendEntry(const std::string& key, const std::string& etag,
+                   const std::string& version_id, uint64_t size,
+                   int64_t last_modified_ms, const std::string& storage_class,
+                   const std::string& storage_tier,
+                   const std::string& restore_status,
+                   const std::string& owner_id,
+                   const std::string& owner_display_name, uint8_t flags);
+
+  // 第i个条目的key、ETag、VersionId依次存放在m_arena[m_offsets[i], m_offsets[i+1])
+  std::string m_arena;
+  std::vector<uint64_t> m_offsets;
+  std::vector<uint32_t> m_key_lens;
+  std::vector<uint16_t> m_etag_lens;
+  std::vector<uint64_t> m_sizes;
+  std::vector<int64_t> m_last_modified_ms;
+  std::vector<uint8_t> m_flags;
+  std::vector<uint32_t> m_attr_ids;
+  std::vector<uint32_t> m_owner_ids;
+
+  InternTable<StorageAttr> m_attrs;
+  InternTable<Owner> m_owners;
+
+  std::vector<std::string> m_common_prefixes;
+  size_t m_page_begin;         // 未确认页面的第一个条目
+  size_t m_page_prefix_begin;  // 未确认页面的第一个CommonPrefix
+};
+
+}  // namespace qcloud_cos
+#endif  // COS_CPP_SDK_V5_INCLUDE_UTIL_COMPACT_LIST_RESULT_H_
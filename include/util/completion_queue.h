@@ -0,0 +1,52 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+// 多生产者单消费者的任务完成队列，用于滑动窗口调度
+// 任务线程完成后推入自己的槽位下标，调度线程按完成顺序逐个取出并立即复用该槽位，
+// 无需唤醒后扫描所有槽位
+class CompletionQueue {
+public:
+    CompletionQueue() {}
+
+    // 任务线程调用，推入已完成任务的槽位下标
+    void push(unsigned slot) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            slots_.push_back(slot);
+        }
+        condition_.notify_one();
+    }
+
+    // 调度线程调用，阻塞直到有任务完成
+    unsigned pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this]() { return !slots_.empty(); });
+        unsigned slot = slots_.front();
+        slots_.pop_front();
+        return slot;
+    }
+
+    // 调度线程调用，没有已完成的任务时立即返回false
+    bool try_pop(unsigned* slot) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (slots_.empty()) {
+            return false;
+        }
+        *slot = slots_.front();
+        slots_.pop_front();
+        return true;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return slots_.size();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<unsigned> slots_;
+};
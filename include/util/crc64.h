@@ -2,6 +2,8 @@
 #include <stdint.h>
 
 #include <cstddef>
+#include <map>
+#include <utility>
 
 namespace qcloud_cos {
 class CRC64 {
@@ -9,5 +11,45 @@ class CRC64 {
   static uint64_t CalcCRC(uint64_t crc, void *buf, size_t len);
   static uint64_t CombineCRC(uint64_t crc1, uint64_t crc2, uintmax_t len2);
   static uint64_t CalcCRC(uint64_t crc, void *buf, size_t len, bool little);
+  // 当前CPU是否使用了硬件加速(PCLMULQDQ)计算CRC64
+  static bool IsHardwareAccelerated();
+};
+
+/// \brief 把乱序完成的分片CRC64按offset顺序合并成整段数据的CRC64, 无需重新读取数据
+class Crc64SliceCombiner {
+ public:
+  /// \brief offset之前的数据已经合并, 其CRC64为crc64
+  explicit Crc64SliceCombiner(uint64_t offset = 0, uint64_t crc64 = 0)
+      : m_offset(offset), m_crc64(crc64) {}
+
+  /// \brief 加入[offset, offset + len)的分片CRC64, 与已合并的数据连续时立即合并,
+  ///        否则缓存到前面的分片到达
+  void AddSlice(uint64_t offset, uint64_t crc64, uint64_t len) {
+    m_pending[offset] = std::make_pair(crc64, len);
+    std::map<uint64_t, std::pair<uint64_t, uint64_t> >::iterator it =
+        m_pending.begin();
+    while (it != m_pending.end() && it->first == m_offset) {
+      m_crc64 = CRC64::CombineCRC(m_crc64, it->second.first,
+                                  static_cast<uintmax_t>(it->second.second));
+      m_offset += it->second.second;
+      m_pending.erase(it);
+      it = m_pending.begin();
+    }
+  }
+
+  /// \brief 已连续合并到的offset
+  uint64_t GetOffset() const { return m_offset; }
+
+  /// \brief [0, GetOffset())的CRC64
+  uint64_t GetCrc64() const { return m_crc64; }
+
+  /// \brief 是否有因前面缺少分片而未合并的分片
+  bool HasPending() const { return !m_pending.empty(); }
+
+ private:
+  uint64_t m_offset;
+  uint64_t m_crc64;
+  // key=分片起始offset, value=(crc64, len)
+  std::map<uint64_t, std::pair<uint64_t, uint64_t> > m_pending;
 };
 }  // namespace qcloud_cos
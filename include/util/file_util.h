@@ -17,14 +17,25 @@ class FileUtil {
   static bool IsDirectoryExists(const std::string& path);
   static bool IsDirectory(const std::string& path);
   static std::string GetDirectory(const std::string& path);
-  // 获取文件CRC64
-  static uint64_t GetFileCrc64(const std::string& file);
+  // 获取文件CRC64, 文件按范围切分后由thread_num个线程并发计算再合并,
+  // thread_num为0时根据CPU核数自动选择
+  static uint64_t GetFileCrc64(const std::string& file, unsigned thread_num = 0);
 #if defined(_WIN32)
   static uint64_t GetFileLen(const std::wstring& path);
-  static uint64_t GetFileCrc64(const std::wstring& file);
+  static uint64_t GetFileCrc64(const std::wstring& file, unsigned thread_num = 0);
   static std::wstring GetWideCharFilePath(const std::string file_path);
 #endif
   static std::string GetFileMd5(const std::string& file);
+  // 将数据写入文件指定偏移处, 不改变文件偏移, 可由多个线程并发调用
+  // 失败时err_msg中返回错误原因
+  static bool WriteFileAt(int fd, const unsigned char* buf, size_t len,
+                          uint64_t offset, std::string* err_msg);
+  // 为文件预分配size字节的磁盘空间, 平台不支持时返回false
+  static bool PreallocateFile(int fd, uint64_t size);
+  // 规范化对象key转换得到的本地相对路径, 去掉空段及"."段, 分隔符统一为'/'
+  // 包含".."段、以反斜杠或盘符开头等可能写到目标目录之外的路径返回false
+  static bool NormalizeRelativePath(const std::string& path,
+                                    std::string* normalized);
 };
 }  // namespace qcloud_cos
 
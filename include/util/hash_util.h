@@ -0,0 +1,109 @@
+#ifndef COS_CPP_SDK_V5_INCLUDE_UTIL_HASH_UTIL_H_
+#define COS_CPP_SDK_V5_INCLUDE_UTIL_HASH_UTIL_H_
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <istream>
+#include <string>
+
+#include <openssl/evp.h>
+
+#include "Poco/DigestEngine.h"
+#include "Poco/MD5Engine.h"
+#include "cos_defines.h"
+#include "util/sha1.h"
+
+namespace qcloud_cos {
+
+typedef enum hash_algorithm { HASH_MD5 = 0, HASH_SHA1 } HASH_ALGORITHM;
+
+/// \brief MD5/SHA1的增量计算, 默认使用CosSysConfig::GetHashBackend()指定的实现,
+/// OpenSSL不可用(如FIPS模式禁用MD5)时退回SDK自带的实现.
+/// 继承Poco::DigestEngine, 可以直接用于Poco::DigestOutputStream
+class HashEngine : public Poco::DigestEngine {
+ public:
+  explicit HashEngine(HASH_ALGORITHM algorithm);
+  HashEngine(HASH_ALGORITHM algorithm, HASH_BACKEND backend);
+  ~HashEngine();
+
+  std::size_t digestLength() const override;
+
+  void reset() override;
+
+  /// \brief 返回二进制摘要, 之后重新开始计算
+  const Digest& digest() override;
+
+  /// \brief 返回十六进制(小写)摘要, 之后重新开始计算
+  std::string HexDigest();
+
+  /// \brief 实际使用的实现
+  HASH_BACKEND GetBackend() const { return m_backend; }
+
+ protected:
+  void updateImpl(const void* data, std::size_t length) override;
+
+ private:
+  void Init();
+
+  HASH_ALGORITHM m_algorithm;
+  HASH_BACKEND m_backend;
+  EVP_MD_CTX* m_ctx;      // OpenSSL
+  Poco::MD5Engine m_md5;  // SDK自带的MD5
+  SHA_INFO m_sha;         // SDK自带的SHA1
+  Digest m_digest;
+};
+
+/// \brief 一次性计算MD5/SHA1/HMAC-SHA1
+class HashUtil {
+ public:
+  /// \brief 二进制的MD5, 用于Content-MD5
+  static std::string Md5(const void* data, size_t len);
+
+  static std::string Md5Hex(const void* data, size_t len);
+
+  /// \brief 从is的当前位置读到结尾计算MD5, 调用方负责恢复流的状态及位置
+  static std::string Md5Hex(std::istream& is);
+
+  static std::string Sha1Hex(const void* data, size_t len);
+
+  /// \brief 二进制的HMAC-SHA1
+  static std::string HmacSha1(const std::string& plain_text,
+                              const std::string& key);
+
+  static std::string HmacSha1Hex(const std::string& plain_text,
+                                 const std::string& key);
+
+  /// \brief 一次遍历同时计算MD5及CRC64, md5_hex为nullptr时只计算CRC64
+  static void Md5Crc64(const void* data, size_t len, std::string* md5_hex,
+                       uint64_t* crc64);
+
+  /// \brief 从is的当前位置读到结尾, 一次遍历同时计算MD5及CRC64,
+  ///        调用方负责恢复流的状态及位置
+  static void Md5Crc64(std::istream& is, std::string* md5_hex,
+                       uint64_t* crc64);
+};
+
+/// \brief 单次遍历同时计算MD5及CRC64(ECMA)
+/// 数据按块处理, 每块先算MD5再算CRC64, 算CRC64时数据仍在L1/L2缓存中,
+/// 整段数据只从内存读取一次. 用于上传时分块既要校验ETag又要合并整个文件的CRC64
+class Md5Crc64Engine {
+ public:
+  /// \brief crc64为初始值, 用于接着之前的数据继续计算
+  explicit Md5Crc64Engine(uint64_t crc64 = 0);
+
+  void Update(const void* data, size_t len);
+
+  /// \brief 返回十六进制(小写)MD5, 之后重新开始计算MD5
+  std::string Md5Hex() { return m_md5.HexDigest(); }
+
+  uint64_t GetCrc64() const { return m_crc64; }
+
+ private:
+  HashEngine m_md5;
+  uint64_t m_crc64;
+};
+
+}  // namespace qcloud_cos
+#endif  // COS_CPP_SDK_V5_INCLUDE_UTIL_HASH_UTIL_H_
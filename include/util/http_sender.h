@@ -92,6 +92,26 @@ class HttpSender {
                          const std::string& ca_location = "",
                          const SSLCtxCallback& ssl_ctx_cb = nullptr,
                          void *user_data = nullptr);
+
+  // 响应正文直接写入调用方提供的缓冲区, 避免中间拷贝, 用于分片下载
+  // Content-Length 超过缓冲区大小或实际接收长度与 Content-Length 不一致时返回 kHttpStatusNetError
+  static int SendRequest(const SharedTransferHandler& handler,
+                         const std::string& http_method,
+                         const std::string& url_str,
+                         const std::map<std::string, std::string>& req_params,
+                         const std::map<std::string, std::string>& req_headers,
+                         uint64_t conn_timeout_in_ms,
+                         uint64_t recv_timeout_in_ms,
+                         std::map<std::string, std::string>* resp_headers,
+                         std::string* xml_err_str,  // 响应返回非 2xx 错误码时, 传输报错响应信息
+                         char* resp_buf,  // 接收响应正文的缓冲区
+                         size_t resp_buf_len,  // 缓冲区大小
+                         std::string* err_msg,
+                         uint64_t* real_byte,  // 实际接收字节数
+                         bool is_verify_cert = true,
+                         const std::string& ca_location = "",
+                         const SSLCtxCallback& ssl_ctx_cb = nullptr,
+                         void *user_data = nullptr);
 };
 
 }  // namespace qcloud_cos
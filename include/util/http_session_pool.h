@@ -0,0 +1,90 @@
+#ifndef COS_CPP_SDK_V5_INCLUDE_UTIL_HTTP_SESSION_POOL_H_
+#define COS_CPP_SDK_V5_INCLUDE_UTIL_HTTP_SESSION_POOL_H_
+#pragma once
+
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "Poco/Net/HTTPClientSession.h"
+#include "util/noncopyable.h"
+
+namespace qcloud_cos {
+
+/// \brief 按host维护的空闲长连接池, 线程安全
+/// 同一个key(scheme://host:port及SSL参数)下的连接可以互相复用,
+/// 请求完整结束且服务端允许keep-alive时才会归还到池中.
+/// 每次Acquire占用该key的一个活跃连接名额, 必须调用一次Release归还,
+/// 连接不可复用时传入空指针
+class HttpSessionPool : private NonCopyable {
+ public:
+  typedef std::unique_ptr<Poco::Net::HTTPClientSession> SessionPtr;
+
+  /// \param max_idle_per_host 每个key最多保留的空闲连接数
+  /// \param idle_timeout_in_s 空闲连接超过该时间后被淘汰
+  /// \param max_active_per_host 每个key同时取出的连接数上限, 0表示不限制
+  HttpSessionPool(unsigned max_idle_per_host, int64_t idle_timeout_in_s,
+                  unsigned max_active_per_host = 0);
+  ~HttpSessionPool();
+
+  /// \brief 占用一个活跃连接名额并取出可用的空闲连接,
+  /// 该key的活跃连接数达到上限时阻塞等待其他连接归还;
+  /// 没有可用的空闲连接时返回空指针, 由调用方新建连接
+  SessionPtr Acquire(const std::string& key);
+
+  /// \brief 归还Acquire占用的名额, session非空时放入空闲队列,
+  /// 超过单host空闲上限时丢弃最老的连接
+  void Release(const std::string& key, SessionPtr session);
+
+  /// \brief 关闭并清空所有空闲连接
+  void Clear();
+
+  /// \brief 获取当前空闲连接总数
+  size_t GetIdleCount();
+
+  /// \brief 获取指定key的空闲连接数
+  size_t GetIdleCount(const std::string& key);
+
+  /// \brief 获取指定key已取出尚未归还的连接数
+  size_t GetActiveCount(const std::string& key);
+
+  void SetMaxIdlePerHost(unsigned max_idle_per_host);
+  /// \brief 设置每个key同时取出的连接数上限, 0表示不限制
+  void SetMaxActivePerHost(unsigned max_active_per_host);
+  void SetIdleTimeout(int64_t idle_timeout_in_s);
+
+ private:
+  struct IdleSession {
+    SessionPtr session;
+    std::chrono::steady_clock::time_point idle_since;
+  };
+  typedef std::deque<IdleSession> IdleQueue;
+
+  // 检查连接是否仍可用: 已连接且对端没有关闭/发送多余数据
+  static bool IsHealthy(Poco::Net::HTTPClientSession* session);
+
+  // 淘汰过期连接, 需持有m_mutex, 被淘汰的连接放入expired中在锁外析构
+  void EvictExpiredLocked(const std::chrono::steady_clock::time_point& now,
+                          std::deque<SessionPtr>* expired);
+
+  std::mutex m_mutex;
+  std::condition_variable m_active_cond;
+  std::map<std::string, IdleQueue> m_idle_sessions;
+  std::map<std::string, size_t> m_active_counts;
+  unsigned m_max_idle_per_host;
+  unsigned m_max_active_per_host;
+  int64_t m_idle_timeout_in_s;
+  std::chrono::steady_clock::time_point m_last_evict_ts;
+};
+
+/// \brief 全局连接池, 连接池参数取自CosSysConfig
+HttpSessionPool& GetGlobalHttpSessionPool();
+
+}  // namespace qcloud_cos
+#endif  // COS_CPP_SDK_V5_INCLUDE_UTIL_HTTP_SESSION_POOL_H_
@@ -0,0 +1,150 @@
+#ifndef COS_CPP_SDK_V5_INCLUDE_UTIL_LIST_XML_PARSER_H_
+#define COS_CPP_SDK_V5_INCLUDE_UTIL_LIST_XML_PARSER_H_
+#pragma once
+
+#include <stdint.h>
+
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "cos_defines.h"
+
+namespace qcloud_cos {
+
+/// \brief 列出结果中的一个条目(Contents/Version/DeleteMarker), 大小和时间已解析为数值
+struct ListEntry {
+  ListEntry() { Clear(); }
+
+  void Clear() {
+    key.clear();
+    etag.clear();
+    version_id.clear();
+    storage_class.clear();
+    storage_tier.clear();
+    restore_status.clear();
+    owner_id.clear();
+    owner_display_name.clear();
+    size = 0;
+    last_modified_ms = 0;
+    is_latest = false;
+    is_delete_marker = false;
+  }
+
+  /// \brief 转换为GetBucket结果的Content
+  void ToContent(Content* content) const;
+
+  /// \brief 转换为GetBucketObjectVersions结果的COSVersionSummary
+  void ToVersionSummary(COSVersionSummary* summary) const;
+
+  std::string key;
+  std::string etag;  // 已去掉引号
+  std::string version_id;
+  std::string storage_class;
+  std::string storage_tier;
+  std::string restore_status;
+  std::string owner_id;
+  std::string owner_display_name;
+  uint64_t size;
+  int64_t last_modified_ms;  // UTC毫秒时间戳
+  bool is_latest;
+  bool is_delete_marker;
+};
+
+/// \brief 列出结果的翻页信息
+struct ListPageInfo {
+  ListPageInfo() : is_truncated(false) {}
+
+  bool is_truncated;
+  std::string next_marker;             // GetBucket
+  std::string next_key_marker;         // GetBucketObjectVersions
+  std::string next_version_id_marker;  // GetBucketObjectVersions
+};
+
+/// \brief 流式解析的结果回调
+class ListXmlHandler {
+ public:
+  virtual ~ListXmlHandler() {}
+
+  /// \brief 请求重试导致重新解析时调用, 需丢弃之前收到的条目
+  virtual void OnReset() {}
+
+  /// \brief 每解析完一个条目调用一次, entry在回调返回后会被复用
+  virtual void OnEntry(const ListEntry& entry) = 0;
+
+  virtual void OnCommonPrefix(const std::string& prefix) { (void)prefix; }
+};
+
+/// \brief GetBucket/GetBucketObjectVersions响应的增量解析器
+/// 数据可以分多次以任意长度输入, 每解析完一个条目立即回调, 不缓存整个响应正文,
+/// 也不构建DOM; 只识别列出结果用到的元素, 其他元素忽略
+class ListXmlParser {
+ public:
+  explicit ListXmlParser(ListXmlHandler* handler);
+
+  /// \brief 输入一段数据, 响应格式错误时返回false, 之后的输入被忽略
+  bool Feed(const char* data, size_t len);
+
+  /// \brief 输入结束, 检查响应是否完整
+  bool Finish();
+
+  /// \brief 丢弃已解析的状态, 从头开始解析, 并通知handler
+  void Reset();
+
+  const ListPageInfo& GetPageInfo() const { return m_page_info; }
+
+  const std::string& GetErrorMsg() const { return m_err_msg; }
+
+  /// \brief 解析"2017-06-23T12:33:27.000Z"格式的时间, 失败时返回false
+  static bool ParseIso8601Ms(const std::string& str, int64_t* ms);
+
+  /// \brief 毫秒时间戳格式化为"2017-06-23T12:33:27.000Z"
+  static std::string FormatIso8601Ms(int64_t ms);
+
+ private:
+  enum State {
+    kStateText,    // 元素之间的文本
+    kStateEntity,  // 文本中的实体引用, 如&amp;
+    kStateTag,     // <与>之间的内容
+  };
+
+  void SetError(const std::string& err_msg);
+  bool HandleTag();
+  void HandleStartElement(int element);
+  void HandleEndElement(int element);
+  bool DecodeEntity();
+
+  ListXmlHandler* m_handler;
+  State m_state;
+  bool m_failed;
+  bool m_root_closed;  // 根元素已结束
+  std::string m_err_msg;
+  std::string m_tag;
+  std::string m_text;
+  std::string m_entity;
+  std::vector<int> m_elements;  // 当前打开的元素
+  ListEntry m_entry;
+  ListPageInfo m_page_info;
+};
+
+/// \brief 把写入的数据交给ListXmlParser的输出流缓冲区, 用于直接解析下载流
+/// 请求重试时下载流会seek到起点, 此时重置解析器
+class ListXmlStreamBuf : public std::streambuf {
+ public:
+  explicit ListXmlStreamBuf(ListXmlParser* parser)
+      : m_parser(parser), m_pos(0) {}
+
+ protected:
+  int_type overflow(int_type ch) override;
+  std::streamsize xsputn(const char* data, std::streamsize len) override;
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override;
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+ private:
+  ListXmlParser* m_parser;
+  std::streamsize m_pos;  // 已写入的字节数
+};
+
+}  // namespace qcloud_cos
+#endif  // COS_CPP_SDK_V5_INCLUDE_UTIL_LIST_XML_PARSER_H_
@@ -56,6 +56,12 @@ class LruCache {
     return m_entry_map.size();
   }
 
+  void Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entry_map.clear();
+    m_entry_list.clear();
+  }
+
  private:
   std::list<KeyValuePair> m_entry_list;
   std::unordered_map<KeyType, ListIterator> m_entry_map;
@@ -0,0 +1,126 @@
+#ifndef COS_CPP_SDK_V5_INCLUDE_UTIL_SELECT_EVENT_DECODER_H_
+#define COS_CPP_SDK_V5_INCLUDE_UTIL_SELECT_EVENT_DECODER_H_
+#pragma once
+
+#include <stdint.h>
+
+#include <streambuf>
+#include <string>
+
+#include "Poco/Checksum.h"
+
+namespace qcloud_cos {
+
+/// \brief SelectObjectContent的Progress/Stats事件
+struct SelectProgress {
+  SelectProgress() : bytes_scanned(0), bytes_processed(0), bytes_returned(0) {}
+
+  uint64_t bytes_scanned;    // 已扫描的字节数
+  uint64_t bytes_processed;  // 已处理的字节数(解压后)
+  uint64_t bytes_returned;   // 已返回的字节数
+  std::string payload;       // 事件的原始XML
+  std::string content_type;  // 消息头部的:content-type
+};
+
+/// \brief SelectObjectContent事件回调, 每收到并校验完一条消息立即回调
+class SelectEventHandler {
+ public:
+  virtual ~SelectEventHandler() {}
+
+  /// \brief Records事件, 返回false时停止接收
+  /// \param content_type 消息头部的:content-type
+  virtual bool OnRecords(const char* data, size_t len,
+                         const std::string& content_type) = 0;
+
+  virtual void OnProgress(const SelectProgress& progress) { (void)progress; }
+
+  virtual void OnStats(const SelectProgress& stats) { (void)stats; }
+
+  /// \brief End事件, 表示结果已完整返回
+  virtual void OnEnd() {}
+};
+
+/// \brief SelectObjectContent响应(event stream)的增量解码器
+/// 数据可以分多次以任意长度输入, 只缓存当前消息, 消息CRC随数据到达增量计算,
+/// 校验通过后立即回调
+///
+/// 消息格式:
+///   message = prelude + headers + payload + CRC32(prelude + headers + payload)
+///   prelude = total_byte_len(4 byte) + header_byte_len(4 byte) +
+///             CRC32(total_byte_len + header_byte_len)(4 byte)
+class SelectEventDecoder {
+ public:
+  explicit SelectEventDecoder(SelectEventHandler* handler);
+
+  /// \brief 输入一段数据, 解码失败、收到错误消息或回调要求停止时返回false,
+  ///        之后的输入被忽略; 收到End事件后的数据直接丢弃
+  bool Feed(const char* data, size_t len);
+
+  /// \brief 丢弃未完成的消息, 从头开始解码
+  void Reset();
+
+  /// \brief 已收到End事件
+  bool IsEnd() const { return m_end; }
+
+  /// \brief 解码失败或收到服务端的错误消息
+  bool IsFailed() const { return m_failed; }
+
+  /// \brief 回调要求停止接收
+  bool IsStopped() const { return m_stopped; }
+
+  /// \brief 是否有未接收完整的消息
+  bool InMessage() const { return !m_message.empty(); }
+
+  /// \brief 是否已回调过事件, 之后不能再从头解码
+  bool HasDelivered() const { return m_delivered; }
+
+  const std::string& GetErrorMsg() const { return m_err_msg; }
+
+  /// \brief 服务端错误消息中的错误码及错误信息, 解码失败时为空
+  const std::string& GetServerErrorCode() const { return m_error_code; }
+  const std::string& GetServerErrorMessage() const { return m_error_message; }
+
+ private:
+  bool ParsePrelude();
+  bool HandleMessage();
+  bool HandleEvent(const std::string& event_type,
+                   const std::string& content_type, const char* payload,
+                   size_t payload_len);
+  void SetError(const std::string& err_msg);
+
+  SelectEventHandler* m_handler;
+  std::string m_message;  // 当前消息已收到的数据
+  uint32_t m_total_len;   // 当前消息的总长度, 解析prelude前为0
+  uint32_t m_header_len;
+  Poco::Checksum m_message_crc;
+  size_t m_crc_pos;  // 已计入CRC的字节数
+  bool m_end;
+  bool m_failed;
+  bool m_stopped;
+  bool m_delivered;
+  std::string m_err_msg;
+  std::string m_error_code;
+  std::string m_error_message;
+};
+
+/// \brief 把写入的数据交给SelectEventDecoder的输出流缓冲区, 用于直接解码响应流
+/// 只有尚未回调过事件时才能seek到起点重新解码, 否则seek失败, 请求不能重试
+class SelectEventStreamBuf : public std::streambuf {
+ public:
+  explicit SelectEventStreamBuf(SelectEventDecoder* decoder)
+      : m_decoder(decoder), m_pos(0) {}
+
+ protected:
+  int_type overflow(int_type ch) override;
+  std::streamsize xsputn(const char* data, std::streamsize len) override;
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override;
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+ private:
+  SelectEventDecoder* m_decoder;
+  std::streamsize m_pos;  // 已写入的字节数
+};
+
+}  // namespace qcloud_cos
+#endif  // COS_CPP_SDK_V5_INCLUDE_UTIL_SELECT_EVENT_DECODER_H_
@@ -0,0 +1,66 @@
+#ifndef COS_CPP_SDK_V5_INCLUDE_UTIL_SSL_CONTEXT_CACHE_H_
+#define COS_CPP_SDK_V5_INCLUDE_UTIL_SSL_CONTEXT_CACHE_H_
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "Poco/Net/Context.h"
+#include "Poco/Net/Session.h"
+#include "cos_defines.h"
+#include "lru_cache.h"
+#include "util/noncopyable.h"
+
+namespace qcloud_cos {
+
+/// \brief 缓存HTTPS请求使用的SSL Context及TLS会话, 线程安全
+/// Context按(校验模式, ca_location, ssl_ctx_cb, user_data)复用, CA证书只加载一次,
+/// ssl_ctx_cb也只在创建Context时执行一次; ssl_ctx_cb为lambda/仿函数时无法区分
+/// 其捕获的状态, 此时不缓存, 每次请求都新建Context并执行回调;
+/// TLS会话按(host:port, Context)保存, 后续连接可通过会话复用跳过完整握手
+class SslContextCache : private NonCopyable {
+ public:
+  using SharedSessionCache =
+      std::shared_ptr<LruCache<std::string, Poco::Net::Session::Ptr>>;
+
+  SslContextCache(unsigned max_context_size, unsigned max_session_size);
+  ~SslContextCache();
+
+  /// \brief 生成Context的缓存key, ssl_ctx_cb不是普通函数时返回空串, 表示不可缓存
+  static std::string BuildContextKey(bool is_verify_cert,
+                                     const std::string& ca_location,
+                                     const SSLCtxCallback& ssl_ctx_cb,
+                                     void* user_data);
+
+  /// \brief 获取缓存的Context, 不存在时创建
+  /// context_key为空或ssl_ctx_cb返回非0时不缓存, 返回空指针, 回调返回值通过cb_ret返回
+  Poco::Net::Context::Ptr GetContext(const std::string& context_key,
+                                     bool is_verify_cert,
+                                     const std::string& ca_location,
+                                     const SSLCtxCallback& ssl_ctx_cb,
+                                     void* user_data, int* cb_ret);
+
+  /// \brief 获取可复用的TLS会话, 不存在时返回空指针
+  Poco::Net::Session::Ptr GetSession(const std::string& session_key);
+
+  /// \brief 保存握手完成后的TLS会话
+  void SaveSession(const std::string& session_key,
+                   Poco::Net::Session::Ptr session);
+
+  /// \brief 清空缓存的Context与TLS会话
+  void Clear();
+
+ private:
+  std::mutex m_mutex;
+  // 按LRU淘汰, 避免每个请求传入不同user_data时无限增长
+  LruCache<std::string, Poco::Net::Context::Ptr> m_contexts;
+  unsigned m_max_session_size;
+  SharedSessionCache m_sessions;
+};
+
+/// \brief 全局SSL Context缓存
+SslContextCache& GetGlobalSslContextCache();
+
+}  // namespace qcloud_cos
+#endif  // COS_CPP_SDK_V5_INCLUDE_UTIL_SSL_CONTEXT_CACHE_H_
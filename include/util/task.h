@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 
 // 任务状态枚举
@@ -10,9 +11,10 @@ typedef enum {
 } TaskStatus;
 
 // 任务相关信息结构体
+// status由任务线程和调度线程共同读写，使用原子变量保证可见性
 class TaskInfo {
 public:
-  TaskStatus status;
+  std::atomic<TaskStatus> status;
   uint64_t sequence;
 
   TaskInfo() : status(TASK_IDLE), sequence(0) {}
@@ -0,0 +1,123 @@
+#ifndef COS_CPP_SDK_V5_INCLUDE_UTIL_TRANSFER_WORKER_POOL_H_
+#define COS_CPP_SDK_V5_INCLUDE_UTIL_TRANSFER_WORKER_POOL_H_
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Poco/Runnable.h"
+#include "op/cos_result.h"
+#include "util/noncopyable.h"
+
+namespace qcloud_cos {
+
+/// \brief 进程内共享的传输线程池, 线程按需创建并常驻, 总数不超过max_workers
+/// 每次传输通过Group提交任务, Group限制自身的并发数, 空闲线程在有待执行任务的
+/// Group之间轮转选取, 保证并发的多个传输公平分享线程
+class TransferWorkerPool : private NonCopyable {
+ public:
+  /// \brief 一次传输的任务组, 用法与Poco::ThreadPool的start/joinAll一致
+  /// 析构前会等待组内所有任务执行结束
+  class Group : private NonCopyable {
+   public:
+    /// \param max_concurrency 组内同时执行的任务数上限
+    Group(TransferWorkerPool& pool, unsigned max_concurrency);
+    ~Group();
+
+    /// \brief 提交任务, 不阻塞; runnable需在任务结束前保持有效
+    void Start(Poco::Runnable& runnable);
+
+    /// \brief 等待组内所有已提交的任务执行结束
+    void JoinAll();
+
+   private:
+    friend class TransferWorkerPool;
+
+    // 组内还能派发的任务数, 需持有pool的m_mutex
+    size_t DispatchableLocked() const;
+
+    TransferWorkerPool& m_pool;
+    unsigned m_max_concurrency;
+    std::deque<Poco::Runnable*> m_pending;
+    unsigned m_running;
+    std::condition_variable m_done_cond;
+  };
+
+  explicit TransferWorkerPool(unsigned max_workers);
+  ~TransferWorkerPool();
+
+  /// \brief 调整线程总数上限, 调小时多余线程在空闲时退出
+  void SetMaxWorkers(unsigned max_workers);
+  unsigned GetMaxWorkers();
+
+  /// \brief 获取当前已创建的线程数
+  size_t GetWorkerCount();
+
+ private:
+  void Register(Group* group);
+  void Unregister(Group* group);
+  void Submit(Group* group, Poco::Runnable* runnable);
+
+  // 按轮转顺序选取一个可派发任务的组, 需持有m_mutex
+  Group* PickGroupLocked();
+  // 回收已退出的线程, 需持有m_mutex
+  void ReapWorkersLocked();
+  // 可派发任务多于空闲线程时补充线程, 需持有m_mutex
+  void SpawnWorkersLocked();
+  void WorkerLoop();
+
+  std::mutex m_mutex;
+  std::condition_variable m_work_cond;
+  std::vector<Group*> m_groups;
+  size_t m_next_group;
+  std::vector<std::thread> m_workers;
+  // 因上限调小而退出, 尚未join的线程
+  std::vector<std::thread::id> m_exited_workers;
+  unsigned m_max_workers;
+  unsigned m_live_workers;
+  unsigned m_busy_workers;
+  bool m_stop;
+};
+
+/// \brief 全局传输线程池, 线程数上限取自CosSysConfig::GetTransferWorkerPoolSize
+TransferWorkerPool& GetGlobalTransferWorkerPool();
+
+/// \brief 按目录/前缀批量传输时, 用worker_num个线程并发处理count个文件,
+/// 每个线程依次领取下标调用fn, 调用线程也参与处理, 全部处理完后返回
+/// 大文件的分块/分片任务会在传输线程池中等待, 文件级任务使用独立线程,
+/// 避免占满传输线程池后互相等待
+void RunFileWorkers(size_t worker_num, size_t count,
+                    const std::function<void(size_t index)>& fn);
+
+/// \brief 批量传输的结果汇总, 单个文件失败不影响其他文件, 只保留第一个失败的结果
+class FileWorkerResult : private NonCopyable {
+ public:
+  FileWorkerResult() : m_fail_flag(false) {}
+
+  /// \brief 保护结果及调用方汇总的响应
+  std::mutex& GetMutex() { return m_mutex; }
+
+  /// \brief 记录失败的结果, 需持有GetMutex()
+  void SetFailLocked(const CosResult& result) {
+    if (!m_fail_flag) {
+      m_fail_result = result;
+      m_fail_flag = true;
+    }
+  }
+
+  /// \brief 以下接口在RunFileWorkers返回后调用
+  bool IsFailed() const { return m_fail_flag; }
+  const CosResult& GetFailResult() const { return m_fail_result; }
+
+ private:
+  std::mutex m_mutex;
+  bool m_fail_flag;
+  CosResult m_fail_result;
+};
+
+}  // namespace qcloud_cos
+#endif  // COS_CPP_SDK_V5_INCLUDE_UTIL_TRANSFER_WORKER_POOL_H_
@@ -1,11 +1,33 @@
 ﻿#include "cos_api.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+
+#include "Poco/Exception.h"
+#include "Poco/File.h"
+#include "Poco/JSON/Array.h"
+#include "Poco/JSON/Object.h"
+#include "Poco/JSON/Parser.h"
+#include "Poco/JSON/Stringifier.h"
 #include "Poco/Net/HTTPSStreamFactory.h"
 #include "Poco/Net/HTTPStreamFactory.h"
 #include "Poco/Net/SSLManager.h"
+#include "Poco/Path.h"
+#include "Poco/RecursiveDirectoryIterator.h"
 #include "Poco/TaskManager.h"
 #include "cos_sys_config.h"
 #include "trsf/async_context.h"
 #include "trsf/async_task.h"
+#include "util/file_util.h"
+#include "util/http_sender.h"
+#include "util/json_util.h"
+#include "util/completion_queue.h"
+#include "util/transfer_worker_pool.h"
 
 namespace qcloud_cos {
 
@@ -14,6 +36,243 @@ bool CosAPI::s_poco_init = false;
 int CosAPI::s_cos_obj_num = 0;
 std::mutex g_init_lock;
 
+namespace {
+
+// 按前缀删除时的一个批量删除请求, 在传输线程池中执行
+class DeleteObjectsBatchTask : public Poco::Runnable {
+ public:
+  DeleteObjectsBatchTask(ObjectOp& object_op, const std::string& bucket_name,
+                         CompletionQueue* done_queue, unsigned slot)
+      : m_object_op(object_op),
+        m_bucket_name(bucket_name),
+        m_done_queue(done_queue),
+        m_slot(slot) {}
+
+  void run() override {
+    DeleteObjectsReq del_req(m_bucket_name);
+    del_req.SetQuiet();
+    for (const std::string& key : m_keys) {
+      del_req.AddObject(key);
+    }
+    m_resp = DeleteObjectsResp();
+    m_result = m_object_op.DeleteObjects(del_req, &m_resp);
+    m_done_queue->push(m_slot);
+  }
+
+  // 取走keys中的内容
+  void SetKeys(std::vector<std::string>* keys) { m_keys.swap(*keys); }
+
+  const std::vector<std::string>& GetKeys() const { return m_keys; }
+  const CosResult& GetResult() const { return m_result; }
+  const DeleteObjectsResp& GetResp() const { return m_resp; }
+
+ private:
+  ObjectOp& m_object_op;
+  std::string m_bucket_name;
+  CompletionQueue* m_done_queue;
+  unsigned m_slot;
+  std::vector<std::string> m_keys;
+  CosResult m_result;
+  DeleteObjectsResp m_resp;
+};
+
+// 按前缀下载的汇总handler, 进度和完成回调取自req
+SharedTransferHandler NewGetObjectsHandler(const GetObjectsByPrefixReq& req) {
+  SharedTransferHandler handler(new TransferHandler());
+  handler->SetBucketName(req.GetBucketName());
+  handler->SetObjectName(req.GetPrefix());
+  handler->SetLocalFilePath(req.GetLocalDir());
+  handler->SetTransferProgressCallback(req.GetTransferProgressCallback());
+  handler->SetDoneCallback(req.GetDoneCallback());
+  handler->SetUserData(req.GetUserData());
+  return handler;
+}
+
+// 目录同步manifest中一个文件的记录
+struct SyncManifestEntry {
+  uint64_t size;
+  int64_t mtime;     // 修改时间, 微秒
+  uint64_t crc64;    // 文件的CRC64
+  std::string etag;  // 上次同步后对象的ETag
+};
+typedef std::map<std::string, SyncManifestEntry> SyncManifest;
+
+// 加载manifest, 文件不存在、损坏或不属于同一bucket和前缀时返回false
+bool LoadSyncManifest(const std::string& manifest_file,
+                      const std::string& bucket_name,
+                      const std::string& prefix, SyncManifest* manifest) {
+  std::ifstream ifs(manifest_file);
+  if (!ifs.good()) {
+    SDK_LOG_INFO("Sync manifest not found: %s", manifest_file.c_str());
+    return false;
+  }
+  Poco::JSON::Parser parser;
+  Poco::Dynamic::Var parse_result;
+  try {
+    parse_result = parser.parse(ifs);
+  } catch (Poco::Exception& e) {
+    SDK_LOG_WARN("Failed to parse sync manifest: %s, error: %s",
+                 manifest_file.c_str(), e.message().c_str());
+    return false;
+  }
+  if (parse_result.type() != typeid(Poco::JSON::Object::Ptr)) {
+    SDK_LOG_WARN("Invalid sync manifest format: %s", manifest_file.c_str());
+    return false;
+  }
+  Poco::JSON::Object::Ptr object =
+      parse_result.extract<Poco::JSON::Object::Ptr>();
+  std::string manifest_bucket;
+  std::string manifest_prefix;
+  if (!JsonUtil::GetStringValue(object, kSyncManifestBucket, &manifest_bucket) ||
+      !JsonUtil::GetStringValue(object, kSyncManifestPrefix, &manifest_prefix) ||
+      manifest_bucket != bucket_name || manifest_prefix != prefix) {
+    SDK_LOG_WARN("Sync manifest %s does not match bucket %s prefix %s",
+                 manifest_file.c_str(), bucket_name.c_str(), prefix.c_str());
+    return false;
+  }
+  Poco::JSON::Array::Ptr files = object->getArray(kSyncManifestFiles);
+  if (files.isNull()) {
+    return false;
+  }
+  for (size_t i = 0; i < files->size(); ++i) {
+    Poco::JSON::Object::Ptr file = files->getObject(i);
+    if (file.isNull()) {
+      continue;
+    }
+    std::string path, size, mtime, crc64, etag;
+    if (!JsonUtil::GetStringValue(file, kSyncManifestPath, &path) ||
+        !JsonUtil::GetStringValue(file, kSyncManifestSize, &size) ||
+        !JsonUtil::GetStringValue(file, kSyncManifestMtime, &mtime) ||
+        !JsonUtil::GetStringValue(file, kSyncManifestCrc64ecma, &crc64) ||
+        !JsonUtil::GetStringValue(file, kSyncManifestEtag, &etag)) {
+      continue;
+    }
+    SyncManifestEntry entry;
+    entry.size = StringUtil::StringToUint64(size);
+    entry.mtime = static_cast<int64_t>(StringUtil::StringToUint64(mtime));
+    entry.crc64 = StringUtil::StringToUint64(crc64);
+    entry.etag = etag;
+    (*manifest)[path] = entry;
+  }
+  return true;
+}
+
+// 保存manifest, 先写临时文件再原子替换
+void SaveSyncManifest(const std::string& manifest_file,
+                      const std::string& bucket_name,
+                      const std::string& prefix, const SyncManifest& manifest) {
+  Poco::JSON::Object::Ptr json_root =
+      new Poco::JSON::Object(Poco::JSON_PRESERVE_KEY_ORDER);
+  json_root->set(kSyncManifestOpType, std::string("SyncDirectory"));
+  json_root->set(kSyncManifestBucket, bucket_name);
+  json_root->set(kSyncManifestPrefix, prefix);
+  Poco::JSON::Array::Ptr files = new Poco::JSON::Array();
+  for (const auto& item : manifest) {
+    Poco::JSON::Object::Ptr file =
+        new Poco::JSON::Object(Poco::JSON_PRESERVE_KEY_ORDER);
+    file->set(kSyncManifestPath, item.first);
+    file->set(kSyncManifestSize, std::to_string(item.second.size));
+    file->set(kSyncManifestMtime, std::to_string(item.second.mtime));
+    file->set(kSyncManifestCrc64ecma, std::to_string(item.second.crc64));
+    file->set(kSyncManifestEtag, item.second.etag);
+    files->add(file);
+  }
+  json_root->set(kSyncManifestFiles, files);
+
+  std::string tmp_file = manifest_file + ".tmp";
+  std::ofstream ofs(tmp_file, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!ofs.is_open()) {
+    SDK_LOG_ERR("Failed to save sync manifest: %s", tmp_file.c_str());
+    return;
+  }
+  Poco::JSON::Stringifier::stringify(json_root, ofs);
+  ofs.close();
+  if (std::rename(tmp_file.c_str(), manifest_file.c_str()) != 0) {
+    SDK_LOG_ERR("Failed to rename sync manifest: %s -> %s", tmp_file.c_str(),
+                manifest_file.c_str());
+  }
+}
+
+// 列出请求失败时切换备用域名再试一次, 用于分页迭代器
+template <typename ReqT, typename RespT>
+std::function<CosResult(const ReqT&, RespT*)> ListWithBackupDomain(
+    BucketOp* bucket_op,
+    CosResult (BucketOp::*list)(const ReqT&, RespT*, bool)) {
+  return [bucket_op, list](const ReqT& req, RespT* resp) {
+    CosResult result = (bucket_op->*list)(req, resp, false);
+    if (!result.IsSucc()) {
+      *resp = RespT();
+      result = (bucket_op->*list)(req, resp, COS_CHANGE_BACKUP_DOMAIN);
+    }
+    return result;
+  };
+}
+
+// 根据流式列出的翻页信息设置下一页的marker, 没有下一页时返回false
+bool AdvanceStreamPage(const ListPageInfo& page_info,
+                       const CompactListResult& result, size_t page_begin,
+                       GetBucketReq* req) {
+  if (!page_info.is_truncated) {
+    return false;
+  }
+  std::string marker = page_info.next_marker;
+  if (marker.empty()) {
+    if (result.Size() == page_begin) {
+      return false;
+    }
+    marker = result.GetKey(result.Size() - 1);
+  }
+  req->SetMarker(marker);
+  return true;
+}
+
+bool AdvanceStreamPage(const ListPageInfo& page_info,
+                       const CompactListResult& result, size_t page_begin,
+                       GetBucketObjectVersionsReq* req) {
+  (void)result;
+  (void)page_begin;
+  if (!page_info.is_truncated) {
+    return false;
+  }
+  req->SetKeyMarker(page_info.next_key_marker);
+  req->SetVersionIdMarker(page_info.next_version_id_marker);
+  return true;
+}
+
+// 逐页流式列出到CompactListResult, 失败时切换备用域名再试一次
+template <typename ReqT>
+CosResult StreamListAll(BucketOp* bucket_op,
+                        CosResult (BucketOp::*stream_list)(const ReqT&,
+                                                           ListXmlHandler*,
+                                                           ListPageInfo*, bool),
+                        const ReqT& first_req, CompactListResult* result) {
+  ReqT req = first_req;
+  CosResult list_result;
+  result->CommitPage();
+  while (true) {
+    size_t page_begin = result->Size();
+    ListPageInfo page_info;
+    list_result = (bucket_op->*stream_list)(req, result, &page_info, false);
+    if (!list_result.IsSucc()) {
+      result->OnReset();
+      page_info = ListPageInfo();
+      list_result = (bucket_op->*stream_list)(req, result, &page_info,
+                                              COS_CHANGE_BACKUP_DOMAIN);
+    }
+    if (!list_result.IsSucc()) {
+      result->OnReset();
+      break;
+    }
+    result->CommitPage();
+    if (!AdvanceStreamPage(page_info, *result, page_begin, &req)) {
+      break;
+    }
+  }
+  return list_result;
+}
+
+}  // namespace
+
 Poco::TaskManager& GetGlobalTaskManager() {
   static Poco::ThreadPool async_thread_pool("aysnc_pool", 2, CosSysConfig::GetAsynThreadPoolSize());
   static Poco::TaskManager task_manager(async_thread_pool);
@@ -118,6 +377,58 @@ CosResult CosAPI::ListMultipartUpload(const ListMultipartUploadReq& req,
   return m_bucket_op.ListMultipartUpload(req, resp);
 }
 
+CosResult CosAPI::ParallelGetBucket(const ParallelGetBucketReq& req,
+                                    const ListContentsCallback& callback) {
+  return m_bucket_op.ParallelGetBucket(req, callback);
+}
+
+SharedGetBucketPager CosAPI::NewGetBucketPager(const GetBucketReq& req,
+                                               unsigned prefetch_pages) {
+  return std::make_shared<GetBucketPager>(
+      ListWithBackupDomain(&m_bucket_op, &BucketOp::GetBucket), req,
+      prefetch_pages);
+}
+
+CosResult CosAPI::StreamGetBucket(const GetBucketReq& req,
+                                  ListXmlHandler* handler,
+                                  ListPageInfo* page_info) {
+  return m_bucket_op.StreamGetBucket(req, handler, page_info);
+}
+
+CosResult CosAPI::StreamGetBucketObjectVersions(
+    const GetBucketObjectVersionsReq& req, ListXmlHandler* handler,
+    ListPageInfo* page_info) {
+  return m_bucket_op.StreamGetBucketObjectVersions(req, handler, page_info);
+}
+
+CosResult CosAPI::GetBucketCompact(const GetBucketReq& req,
+                                   CompactListResult* result) {
+  return StreamListAll(&m_bucket_op, &BucketOp::StreamGetBucket, req, result);
+}
+
+CosResult CosAPI::GetBucketObjectVersionsCompact(
+    const GetBucketObjectVersionsReq& req, CompactListResult* result) {
+  return StreamListAll(&m_bucket_op, &BucketOp::StreamGetBucketObjectVersions,
+                       req, result);
+}
+
+CosResult CosAPI::ParallelGetBucket(const ParallelGetBucketReq& req,
+                                    CompactListResult* result) {
+  // 回调总是串行调用, 无序模式下在持锁时调用
+  return m_bucket_op.ParallelGetBucket(
+      req, [result](const std::vector<Content>& contents) {
+        result->AppendContents(contents);
+        return true;
+      });
+}
+
+SharedListMultipartUploadPager CosAPI::NewListMultipartUploadPager(
+    const ListMultipartUploadReq& req, unsigned prefetch_pages) {
+  return std::make_shared<ListMultipartUploadPager>(
+      ListWithBackupDomain(&m_bucket_op, &BucketOp::ListMultipartUpload), req,
+      prefetch_pages);
+}
+
 CosResult CosAPI::DeleteBucket(const DeleteBucketReq& req,
                                DeleteBucketResp* resp) {
   return m_bucket_op.DeleteBucket(req, resp);
@@ -289,6 +600,13 @@ CosResult CosAPI::GetBucketObjectVersions(const GetBucketObjectVersionsReq& req,
   return m_bucket_op.GetBucketObjectVersions(req, resp);
 }
 
+SharedGetBucketObjectVersionsPager CosAPI::NewGetBucketObjectVersionsPager(
+    const GetBucketObjectVersionsReq& req, unsigned prefetch_pages) {
+  return std::make_shared<GetBucketObjectVersionsPager>(
+      ListWithBackupDomain(&m_bucket_op, &BucketOp::GetBucketObjectVersions),
+      req, prefetch_pages);
+}
+
 CosResult CosAPI::PutObject(const PutObjectByFileReq& req,
                             PutObjectByFileResp* resp) {
   return m_object_op.PutObject(req, resp);
@@ -443,6 +761,12 @@ CosResult CosAPI::SelectObjectContent(const SelectObjectContentReq& req,
   return m_object_op.SelectObjectContent(req, resp);
 }
 
+CosResult CosAPI::SelectObjectContent(const SelectObjectContentReq& req,
+                                      SelectEventHandler* handler,
+                                      SelectObjectContentResp* resp) {
+  return m_object_op.SelectObjectContent(req, handler, resp);
+}
+
 CosResult CosAPI::AppendObject(const AppendObjectReq& req,
                                AppendObjectResp* resp) {
   return m_object_op.AppendObject(req, resp);
@@ -697,36 +1021,555 @@ CosResult CosAPI::PutDirectory(const PutDirectoryReq& req,
 
 CosResult CosAPI::DeleteObjects(const DeleteObjectsByPrefixReq& req,
                                 DeleteObjectsByPrefixResp* resp) {
-  CosResult get_bucket_result;
+  const unsigned concurrency = req.GetConcurrency();
+  const unsigned batch_size = req.GetBatchSize();
+  TransferWorkerPool::Group group(GetGlobalTransferWorkerPool(), concurrency);
+  CompletionQueue done_queue;
+  std::vector<std::unique_ptr<DeleteObjectsBatchTask>> tasks;
+  std::vector<unsigned> idle_slots;
+  for (unsigned i = 0; i < concurrency; ++i) {
+    tasks.emplace_back(new DeleteObjectsBatchTask(
+        m_object_op, req.GetBucketName(), &done_queue, i));
+    idle_slots.push_back(concurrency - 1 - i);
+  }
+  unsigned active_tasks = 0;
+  bool del_fail_flag = false;
+  CosResult del_fail_result;
+
+  // 汇总一个批次的结果, quiet模式下响应只包含删除失败的对象
+  auto process_completed_task = [&](unsigned i) {
+    DeleteObjectsBatchTask* task = tasks[i].get();
+    const std::vector<std::string>& keys = task->GetKeys();
+    const CosResult& del_result = task->GetResult();
+    if (!del_result.IsSucc()) {
+      SDK_LOG_ERR("delete objects batch fail, bucket=%s, key_num=%zu, msg=%s",
+                  req.GetBucketName().c_str(), keys.size(),
+                  del_result.GetErrorMsg().c_str());
+      if (!del_fail_flag) {
+        del_fail_result = del_result;
+        del_fail_flag = true;
+      }
+      for (const std::string& key : keys) {
+        ErrorInfo info;
+        info.m_key = key;
+        info.m_code = del_result.GetErrorCode();
+        info.m_message = del_result.GetErrorMsg();
+        resp->m_fail_del_objs.push_back(info);
+      }
+    } else {
+      std::set<std::string> fail_keys;
+      const std::vector<ErrorInfo> error_infos = task->GetResp().GetErrorMsgs();
+      for (const ErrorInfo& info : error_infos) {
+        fail_keys.insert(info.m_key);
+        resp->m_fail_del_objs.push_back(info);
+      }
+      for (const std::string& key : keys) {
+        if (fail_keys.find(key) == fail_keys.end()) {
+          resp->m_succ_del_objs.push_back(key);
+        }
+      }
+    }
+    idle_slots.push_back(i);
+  };
+
+  // 提交一个批次, 没有空闲槽位时等待任意一个批次完成
+  std::vector<std::string> batch_keys;
+  auto submit_batch = [&]() {
+    if (idle_slots.empty()) {
+      process_completed_task(done_queue.pop());
+      --active_tasks;
+    }
+    unsigned i = idle_slots.back();
+    idle_slots.pop_back();
+    tasks[i]->SetKeys(&batch_keys);
+    batch_keys.clear();
+    ++active_tasks;
+    group.Start(*tasks[i]);
+  };
+
   GetBucketReq get_bucket_req(req.GetBucketName());
   get_bucket_req.SetPrefix(req.GetPrefix());
-  bool is_truncated = false;
-
-  do {
-    GetBucketResp get_bucket_resp;
-    get_bucket_result = m_bucket_op.GetBucket(get_bucket_req, &get_bucket_resp);
-    if (get_bucket_result.IsSucc()) {
-      std::vector<Content> contents = get_bucket_resp.GetContents();
-      for (auto& content : contents) {
-        DeleteObjectReq del_req(req.GetBucketName(), content.m_key);
-        DeleteObjectResp del_resp;
-        CosResult del_result = DeleteObject(del_req, &del_resp);
-        if (del_result.IsSucc()) {
-          resp->m_succ_del_objs.push_back(content.m_key);
-        } else {
-          return del_result;
+  SharedGetBucketPager pager = NewGetBucketPager(get_bucket_req);
+
+  // 批量删除在线程池中执行, 后续页面由分页迭代器在后台预取
+  GetBucketResp get_bucket_resp;
+  while (pager->Next(&get_bucket_resp)) {
+    const std::vector<Content>& contents = get_bucket_resp.GetContents();
+    for (const Content& content : contents) {
+      batch_keys.push_back(content.m_key);
+      if (batch_keys.size() >= batch_size) {
+        submit_batch();
+      }
+    }
+  }
+
+  CosResult get_bucket_result = pager->GetResult();
+  if (get_bucket_result.IsSucc() && !batch_keys.empty()) {
+    submit_batch();
+  }
+
+  // 等待所有批次完成
+  while (active_tasks > 0) {
+    process_completed_task(done_queue.pop());
+    --active_tasks;
+  }
+  group.JoinAll();
+
+  if (!get_bucket_result.IsSucc()) {
+    return get_bucket_result;
+  }
+  if (del_fail_flag) {
+    return del_fail_result;
+  }
+  return get_bucket_result;
+}
+
+CosResult CosAPI::GetObjects(const GetObjectsByPrefixReq& req,
+                             GetObjectsByPrefixResp* resp) {
+  SharedTransferHandler handler;
+  if (req.GetTransferProgressCallback() || req.GetDoneCallback()) {
+    handler = NewGetObjectsHandler(req);
+  }
+  return GetObjectsByPrefix(req, resp, handler);
+}
+
+SharedAsyncContext CosAPI::AsyncGetObjects(const GetObjectsByPrefixReq& req) {
+  SharedTransferHandler handler = NewGetObjectsHandler(req);
+  TaskFunc fn = [=]() {
+    GetObjectsByPrefixResp resp;
+    GetObjectsByPrefix(req, &resp, handler);
+  };
+  GetGlobalTaskManager().start(new AsyncTask(std::move(fn)));
+  SharedAsyncContext context(new AsyncContext(handler));
+  return context;
+}
+
+CosResult CosAPI::GetObjectsByPrefix(const GetObjectsByPrefixReq& req,
+                                     GetObjectsByPrefixResp* resp,
+                                     const SharedTransferHandler& handler) {
+  // 1. 列出前缀下的所有对象, 得到本地路径及总大小
+  struct GetEntry {
+    std::string object_name;
+    std::string file_name;
+    uint64_t size;
+    std::string etag;
+  };
+  std::vector<GetEntry> entries;
+  uint64_t total_size = 0;
+  FileWorkerResult worker_result;
+  const std::string prefix = req.GetPrefix();
+  std::string local_dir = req.GetLocalDir();
+  if (!local_dir.empty() && !StringUtil::StringEndsWith(local_dir, "/")) {
+    local_dir += "/";
+  }
+
+  GetBucketReq get_bucket_req(req.GetBucketName());
+  get_bucket_req.SetPrefix(prefix);
+  SharedGetBucketPager pager = NewGetBucketPager(get_bucket_req);
+  GetBucketResp get_bucket_resp;
+  while (pager->Next(&get_bucket_resp)) {
+    const std::vector<Content>& contents = get_bucket_resp.GetContents();
+    for (const Content& content : contents) {
+      GetEntry entry;
+      entry.object_name = content.m_key;
+      std::string relative_name =
+          StringUtil::StringRemovePrefix(content.m_key, prefix);
+      if (relative_name.empty()) {
+        // 前缀即对象名时使用对象名的最后一段
+        relative_name = content.m_key.substr(content.m_key.rfind('/') + 1);
+      }
+      // 对象key由bucket的写入方决定, 可能写到local_dir之外的key不下载
+      std::string normalized_name;
+      if (!FileUtil::NormalizeRelativePath(relative_name, &normalized_name)) {
+        CosResult reject_result;
+        reject_result.SetErrorMsg("object key " + content.m_key +
+                                  " resolves outside local dir " + local_dir);
+        SDK_LOG_ERR("%s", reject_result.GetErrorMsg().c_str());
+        GetObjectsByPrefixResp::GetFailResp fail_r;
+        fail_r.m_object_name = content.m_key;
+        fail_r.m_err_msg = reject_result.GetErrorMsg();
+        resp->m_fail_get_objs.push_back(fail_r);
+        std::lock_guard<std::mutex> lock(worker_result.GetMutex());
+        worker_result.SetFailLocked(reject_result);
+        continue;
+      }
+      entry.file_name = local_dir + normalized_name;
+      entry.size = StringUtil::StringToUint64(content.m_size);
+      entry.etag = content.m_etag;
+      total_size += entry.size;
+      entries.push_back(entry);
+    }
+  }
+  CosResult result = pager->GetResult();
+  if (!result.IsSucc()) {
+    if (handler) {
+      handler->UpdateStatus(TransferStatus::FAILED, result);
+    }
+    return result;
+  }
+
+  if (handler) {
+    handler->SetTotalSize(total_size);
+    handler->UpdateStatus(TransferStatus::IN_PROGRESS);
+  }
+
+  // 2. 本地文件与对象一致时跳过下载
+  auto is_identical = [&](const GetEntry& entry) -> bool {
+    try {
+      Poco::File local_file(entry.file_name);
+      if (!local_file.exists() || !local_file.isFile() ||
+          local_file.getSize() != entry.size) {
+        return false;
+      }
+    } catch (const Poco::Exception&) {
+      return false;
+    }
+    if (!StringUtil::IsV4ETag(entry.etag)) {
+      // 简单上传的ETag为对象的MD5
+      return FileUtil::GetFileMd5(entry.file_name) == entry.etag;
+    }
+    HeadObjectReq head_req(req.GetBucketName(), entry.object_name);
+    HeadObjectResp head_resp;
+    CosResult head_result = m_object_op.HeadObject(head_req, &head_resp);
+    if (!head_result.IsSucc() || head_resp.GetXCosHashCrc64Ecma().empty()) {
+      return false;
+    }
+    return FileUtil::GetFileCrc64(entry.file_name) ==
+           StringUtil::StringToUint64(head_resp.GetXCosHashCrc64Ecma());
+  };
+
+  // 3. 下载单个对象, 大对象使用多线程下载
+  const uint64_t multi_download_threshold = req.GetMultiDownloadThreshold();
+  auto get_entry = [&](const GetEntry& entry,
+                       GetObjectsByPrefixResp::GetResp* r) -> CosResult {
+    CosResult get_result;
+    const bool is_dir = StringUtil::StringEndsWith(entry.object_name, "/");
+    std::string dir_name = entry.file_name;
+    if (!is_dir) {
+      size_t pos = entry.file_name.find_last_of("/\\");
+      dir_name = pos == std::string::npos ? "" : entry.file_name.substr(0, pos);
+    }
+    try {
+      if (!dir_name.empty()) {
+        Poco::File(dir_name).createDirectories();
+      }
+    } catch (const Poco::Exception& ex) {
+      get_result.SetErrorMsg("create directory " + dir_name +
+                             " fail: " + ex.displayText());
+      return get_result;
+    }
+    if (is_dir) {
+      get_result.SetSucc();
+      return get_result;
+    }
+
+    if (req.IsSkipIdentical() && is_identical(entry)) {
+      SDK_LOG_DBG("skip identical object: %s", entry.object_name.c_str());
+      r->m_skipped = true;
+      if (handler) {
+        handler->UpdateProgress(entry.size);
+      }
+      get_result.SetSucc();
+      return get_result;
+    }
+
+    GetObjectByFileReq get_req(req.GetBucketName(), entry.object_name,
+                               entry.file_name);
+    GetObjectByFileResp get_resp;
+    SharedTransferHandler file_handler;
+    if (handler) {
+      file_handler = NewFileProgressHandler(
+          entry.size, [handler](uint64_t delta) { handler->UpdateProgress(delta); });
+    }
+    SDK_LOG_DBG("start to download %s to %s, size=%" PRIu64,
+                entry.object_name.c_str(), entry.file_name.c_str(), entry.size);
+    if (entry.size >= multi_download_threshold) {
+      get_result = m_object_op.MultiThreadDownload(get_req, &get_resp,
+                                                   file_handler);
+    } else {
+      get_result = m_object_op.GetObject(get_req, &get_resp, file_handler);
+    }
+    return get_result;
+  };
+
+  // 4. 多个对象并发下载, 单个对象失败不影响其他对象
+  bool cancel_flag = false;
+  RunFileWorkers(req.GetConcurrency(), entries.size(), [&](size_t index) {
+    if (handler && !handler->ShouldContinue()) {
+      std::lock_guard<std::mutex> lock(worker_result.GetMutex());
+      cancel_flag = true;
+      return;
+    }
+    const GetEntry& entry = entries[index];
+    GetObjectsByPrefixResp::GetResp r;
+    r.m_object_name = entry.object_name;
+    r.m_file_name = entry.file_name;
+    CosResult get_result = get_entry(entry, &r);
+
+    std::lock_guard<std::mutex> lock(worker_result.GetMutex());
+    if (get_result.IsSucc()) {
+      resp->m_succ_get_objs.push_back(r);
+      return;
+    }
+    SDK_LOG_ERR("failed to download object: %s to %s, msg=%s",
+                entry.object_name.c_str(), entry.file_name.c_str(),
+                get_result.GetErrorMsg().c_str());
+    GetObjectsByPrefixResp::GetFailResp fail_r;
+    fail_r.m_object_name = entry.object_name;
+    fail_r.m_file_name = entry.file_name;
+    fail_r.m_http_status = get_result.GetHttpStatus();
+    fail_r.m_err_code = get_result.GetErrorCode();
+    fail_r.m_err_msg = get_result.GetErrorMsg();
+    resp->m_fail_get_objs.push_back(fail_r);
+    worker_result.SetFailLocked(get_result);
+  });
+
+  if (cancel_flag) {
+    result.SetFail();
+    result.SetHttpStatus(kHttpStatusUserCancel);
+    result.SetErrorMsg("Request canceled by user");
+    SDK_LOG_ERR("get objects by prefix %s canceled by user", prefix.c_str());
+    handler->UpdateStatus(TransferStatus::CANCELED, result);
+    return result;
+  }
+  if (worker_result.IsFailed()) {
+    if (handler) {
+      handler->UpdateStatus(TransferStatus::FAILED,
+                            worker_result.GetFailResult());
+    }
+    return worker_result.GetFailResult();
+  }
+  if (handler) {
+    handler->UpdateStatus(TransferStatus::COMPLETED, result);
+  }
+  return result;
+}
+
+CosResult CosAPI::SyncDirectory(const SyncDirectoryReq& req,
+                                SyncDirectoryResp* resp) {
+  CosResult result;
+  const std::string local_dir = req.GetLocalDir();
+  if (local_dir.empty() || !FileUtil::IsDirectoryExists(local_dir)) {
+    std::string err_msg = "directory :" + local_dir + " not exists";
+    SDK_LOG_ERR("%s", err_msg.c_str());
+    result.SetErrorMsg(err_msg);
+    return result;
+  }
+  const std::string bucket_name = req.GetBucketName();
+  const std::string cos_prefix = req.GetCosPrefix();
+  const std::string manifest_file = req.GetManifestFile();
+
+  // 1. 遍历本地目录, manifest文件本身不同步
+  struct SyncLocalFile {
+    std::string file_name;
+    std::string object_name;
+    std::string relative_name;
+    uint64_t size;
+    int64_t mtime;
+  };
+  std::vector<SyncLocalFile> local_files;
+  std::set<std::string> local_objects;
+  try {
+    std::string manifest_path;
+    if (!manifest_file.empty()) {
+      manifest_path = Poco::Path(manifest_file).absolute().toString();
+    }
+    Poco::SimpleRecursiveDirectoryIterator it((Poco::Path(local_dir)));
+    Poco::SimpleRecursiveDirectoryIterator end;
+    for (; it != end; ++it) {
+      if (!it->isFile()) {
+        continue;
+      }
+      SyncLocalFile local_file;
+      local_file.file_name = it->path();
+      if (!manifest_path.empty()) {
+        std::string path = Poco::Path(local_file.file_name).absolute().toString();
+        if (path == manifest_path || path == manifest_path + ".tmp") {
+          continue;
         }
       }
+      std::string relative_name =
+          StringUtil::StringRemovePrefix(local_file.file_name, local_dir);
+      std::replace(relative_name.begin(), relative_name.end(), '\\', '/');
+      while (StringUtil::StringStartsWith(relative_name, "/")) {
+        relative_name = relative_name.substr(1);
+      }
+      local_file.relative_name = relative_name;
+      local_file.object_name = cos_prefix + relative_name;
+      local_file.size = it->getSize();
+      local_file.mtime = it->getLastModified().epochMicroseconds();
+      local_objects.insert(local_file.object_name);
+      local_files.push_back(local_file);
+    }
+  } catch (const Poco::Exception& ex) {
+    std::string err_msg =
+        "walk directory " + local_dir + " fail: " + ex.displayText();
+    SDK_LOG_ERR("%s", err_msg.c_str());
+    result.SetErrorMsg(err_msg);
+    return result;
+  }
+
+  // 2. 列出cos前缀下的对象
+  struct SyncRemoteObject {
+    uint64_t size;
+    std::string etag;
+  };
+  std::map<std::string, SyncRemoteObject> remote_objects;
+  GetBucketReq get_bucket_req(bucket_name);
+  get_bucket_req.SetPrefix(cos_prefix);
+  SharedGetBucketPager pager = NewGetBucketPager(get_bucket_req);
+  GetBucketResp get_bucket_resp;
+  while (pager->Next(&get_bucket_resp)) {
+    const std::vector<Content>& contents = get_bucket_resp.GetContents();
+    for (const Content& content : contents) {
+      SyncRemoteObject remote;
+      remote.size = StringUtil::StringToUint64(content.m_size);
+      remote.etag = content.m_etag;
+      remote_objects[content.m_key] = remote;
+    }
+  }
+  result = pager->GetResult();
+  if (!result.IsSucc()) {
+    return result;
+  }
+
+  // 3. 加载上次同步的manifest
+  SyncManifest old_manifest;
+  if (!manifest_file.empty()) {
+    LoadSyncManifest(manifest_file, bucket_name, cos_prefix, &old_manifest);
+  }
+
+  // 4. 比较并上传变化的文件, 单个文件失败不影响其他文件
+  SyncManifest new_manifest;
+  FileWorkerResult worker_result;
+  auto record_fail = [&](const std::string& object_name,
+                         const CosResult& fail) {
+    ErrorInfo info;
+    info.m_key = object_name;
+    info.m_code = fail.GetErrorCode();
+    info.m_message = fail.GetErrorMsg();
+    resp->m_fail_objs.push_back(info);
+    worker_result.SetFailLocked(fail);
+  };
+
+  const uint64_t multi_upload_threshold = req.GetMultiUploadThreshold();
+  auto sync_file = [&](const SyncLocalFile& local_file) {
+    SyncManifestEntry entry;
+    entry.size = local_file.size;
+    entry.mtime = local_file.mtime;
+
+    // 大小和修改时间未变化时复用manifest中的CRC64
+    auto old_it = old_manifest.find(local_file.relative_name);
+    bool manifest_hit = old_it != old_manifest.end() &&
+                        old_it->second.size == local_file.size &&
+                        old_it->second.mtime == local_file.mtime;
+    entry.crc64 = manifest_hit ? old_it->second.crc64
+                               : FileUtil::GetFileCrc64(local_file.file_name);
+
+    bool unchanged = false;
+    auto remote_it = remote_objects.find(local_file.object_name);
+    if (remote_it != remote_objects.end() &&
+        remote_it->second.size == local_file.size) {
+      if (manifest_hit && old_it->second.etag == remote_it->second.etag) {
+        // 本地文件和对象在上次同步后都未变化
+        unchanged = true;
+      } else {
+        HeadObjectReq head_req(bucket_name, local_file.object_name);
+        HeadObjectResp head_resp;
+        CosResult head_result = m_object_op.HeadObject(head_req, &head_resp);
+        unchanged = head_result.IsSucc() &&
+                    !head_resp.GetXCosHashCrc64Ecma().empty() &&
+                    StringUtil::StringToUint64(
+                        head_resp.GetXCosHashCrc64Ecma()) == entry.crc64;
+      }
+      entry.etag = remote_it->second.etag;
+    }
 
-      get_bucket_req.SetMarker(get_bucket_resp.GetNextMarker());
-      is_truncated = get_bucket_resp.IsTruncated();
+    if (unchanged) {
+      std::lock_guard<std::mutex> lock(worker_result.GetMutex());
+      resp->m_unchanged_objs.push_back(local_file.object_name);
+      new_manifest[local_file.relative_name] = entry;
+      return;
+    }
+
+    SDK_LOG_DBG("sync upload %s to %s, size=%" PRIu64,
+                local_file.file_name.c_str(), local_file.object_name.c_str(),
+                local_file.size);
+    PutObjectByFileReq put_req(bucket_name, local_file.object_name,
+                               local_file.file_name);
+    CosResult put_result;
+    if (local_file.size >= multi_upload_threshold) {
+      MultiPutObjectResp put_resp;
+      put_result = m_object_op.MultiUploadObject(put_req, &put_resp, nullptr);
+      entry.etag = put_resp.GetEtag();
     } else {
-      get_bucket_result = m_bucket_op.GetBucket(get_bucket_req, &get_bucket_resp, COS_CHANGE_BACKUP_DOMAIN);
+      PutObjectByFileResp put_resp;
+      put_result = m_object_op.PutObject(put_req, &put_resp);
+      entry.etag = put_resp.GetEtag();
     }
-  } while (get_bucket_result.IsSucc() && is_truncated);
 
-  return get_bucket_result;
-};
+    std::lock_guard<std::mutex> lock(worker_result.GetMutex());
+    if (!put_result.IsSucc()) {
+      SDK_LOG_ERR("sync upload %s fail, msg=%s", local_file.file_name.c_str(),
+                  put_result.GetErrorMsg().c_str());
+      record_fail(local_file.object_name, put_result);
+      return;
+    }
+    resp->m_uploaded_objs.push_back(local_file.object_name);
+    new_manifest[local_file.relative_name] = entry;
+  };
+
+  RunFileWorkers(req.GetConcurrency(), local_files.size(),
+                 [&](size_t index) { sync_file(local_files[index]); });
+
+  // 5. 删除本地已不存在的对象, 目录对象保留
+  if (req.IsDeleteRemote()) {
+    std::vector<std::string> delete_keys;
+    for (const auto& remote : remote_objects) {
+      if (local_objects.find(remote.first) == local_objects.end() &&
+          !StringUtil::StringEndsWith(remote.first, "/")) {
+        delete_keys.push_back(remote.first);
+      }
+    }
+    for (size_t begin = 0; begin < delete_keys.size();
+         begin += kMaxDeleteObjectsBatchSize) {
+      size_t end = std::min(delete_keys.size(),
+                            begin + static_cast<size_t>(kMaxDeleteObjectsBatchSize));
+      DeleteObjectsReq del_req(bucket_name);
+      del_req.SetQuiet();
+      for (size_t i = begin; i < end; ++i) {
+        del_req.AddObject(delete_keys[i]);
+      }
+      DeleteObjectsResp del_resp;
+      CosResult del_result = m_object_op.DeleteObjects(del_req, &del_resp);
+      std::set<std::string> fail_keys;
+      if (del_result.IsSucc()) {
+        const std::vector<ErrorInfo> error_infos = del_resp.GetErrorMsgs();
+        for (const ErrorInfo& info : error_infos) {
+          fail_keys.insert(info.m_key);
+          resp->m_fail_objs.push_back(info);
+        }
+      }
+      for (size_t i = begin; i < end; ++i) {
+        if (!del_result.IsSucc()) {
+          record_fail(delete_keys[i], del_result);
+        } else if (fail_keys.find(delete_keys[i]) == fail_keys.end()) {
+          resp->m_deleted_objs.push_back(delete_keys[i]);
+        }
+      }
+    }
+  }
+
+  // 6. 保存manifest, 失败的文件不记录, 下次同步时重新比较
+  if (!manifest_file.empty()) {
+    SaveSyncManifest(manifest_file, bucket_name, cos_prefix, new_manifest);
+  }
+
+  if (worker_result.IsFailed()) {
+    return worker_result.GetFailResult();
+  }
+  return result;
+}
 
 CosResult CosAPI::MoveObject(const MoveObjectReq& req) {
   return m_object_op.MoveObject(req);
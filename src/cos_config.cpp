@@ -139,6 +139,17 @@ bool CosConfig::InitConf(const std::string& config_file) {
     CosSysConfig::SetUploadThreadPoolSize((unsigned)integer_value);
   }
 
+  //设置分块上传的预读分块数及读线程数
+  if (JsonObjectGetIntegerValue(object, "UploadReadAheadDepth",
+                                &integer_value)) {
+    CosSysConfig::SetUploadReadAheadDepth((unsigned)integer_value);
+  }
+
+  if (JsonObjectGetIntegerValue(object, "UploadReaderThreadNum",
+                                &integer_value)) {
+    CosSysConfig::SetUploadReaderThreadNum((unsigned)integer_value);
+  }
+
   //异步上传下载的线程池大小
   if (JsonObjectGetIntegerValue(object, "AsynThreadPoolSize", &integer_value)) {
     CosSysConfig::SetAsynThreadPoolSize((unsigned)integer_value);
@@ -163,19 +174,49 @@ bool CosConfig::InitConf(const std::string& config_file) {
     CosSysConfig::SetDownSliceSize((unsigned)integer_value);
   }
 
+  //设置全局传输线程池的线程数上限
+  if (JsonObjectGetIntegerValue(object, "TransferWorkerPoolSize",
+                                &integer_value)) {
+    CosSysConfig::SetTransferWorkerPoolSize((unsigned)integer_value);
+  }
+
+  //设置MD5/SHA1/HMAC-SHA1的实现,0:OpenSSL, 1:SDK自带,默认:0
+  if (JsonObjectGetIntegerValue(object, "HashBackend", &integer_value)) {
+    CosSysConfig::SetHashBackend((HASH_BACKEND)integer_value);
+  }
+
+  //设置分块/分片缓冲区池保留内存的上限,单位:字节
+  if (JsonObjectGetIntegerValue(object, "BufferPoolMaxBytes", &integer_value)) {
+    CosSysConfig::SetBufferPoolMaxBytes(integer_value);
+  }
+
   bool bool_value;
-// 长连接相关
-#if 0
-    if (JsonObjectGetBoolValue(object, "keepalive_mode", &bool_value)) {
-        CosSysConfig::SetKeepAlive(bool_value);
-    }
-    if (JsonObjectGetIntegerValue(object, "keepalive_idle_time", &integer_value)) {
-        CosSysConfig::SetKeepIdle(integer_value);
-    }
-    if (JsonObjectGetIntegerValue(object, "keepalive_interval_time", &integer_value)) {
-        CosSysConfig::SetKeepIntvl(integer_value);
-    }
-#endif
+  if (JsonObjectGetBoolValue(object, "DownloadFilePreallocate", &bool_value)) {
+    CosSysConfig::SetDownFilePreallocate(bool_value);
+  }
+  if (JsonObjectGetBoolValue(object, "BufferPoolUseHugePage", &bool_value)) {
+    CosSysConfig::SetBufferPoolUseHugePage(bool_value);
+  }
+
+  // 长连接相关
+  if (JsonObjectGetBoolValue(object, "keepalive_mode", &bool_value)) {
+    CosSysConfig::SetKeepAlive(bool_value);
+  }
+  if (JsonObjectGetIntegerValue(object, "keepalive_idle_time", &integer_value)) {
+    CosSysConfig::SetKeepIdle(integer_value);
+  }
+  if (JsonObjectGetIntegerValue(object, "keepalive_interval_time", &integer_value)) {
+    CosSysConfig::SetKeepIntvl(integer_value);
+  }
+  if (JsonObjectGetIntegerValue(object, "MaxIdleSessionsPerHost", &integer_value)) {
+    CosSysConfig::SetMaxIdleSessionsPerHost((unsigned)integer_value);
+  }
+  if (JsonObjectGetIntegerValue(object, "MaxSessionsPerHost", &integer_value)) {
+    CosSysConfig::SetMaxSessionsPerHost((unsigned)integer_value);
+  }
+  if (JsonObjectGetIntegerValue(object, "SessionIdleTimeout", &integer_value)) {
+    CosSysConfig::SetSessionIdleTimeout(integer_value);
+  }
   if (JsonObjectGetBoolValue(object, "IsCheckMd5", &bool_value)) {
     CosSysConfig::SetCheckMd5(bool_value);
   }
@@ -6,6 +6,9 @@
 #include <mutex>
 
 #include "cos_defines.h"
+#include "util/buffer_pool.h"
+#include "util/http_session_pool.h"
+#include "util/transfer_worker_pool.h"
 #include "util/string_util.h"
 
 namespace qcloud_cos {
@@ -24,6 +27,9 @@ uint64_t CosSysConfig::m_recv_timeout_in_ms = 5 * 1000;
 
 unsigned CosSysConfig::m_threadpool_size = kDefaultThreadPoolSizeUploadPart;
 unsigned CosSysConfig::m_asyn_threadpool_size = kDefaultPoolSize;
+//分块上传预读分块数及读线程数
+unsigned CosSysConfig::m_upload_read_ahead_depth = 2;
+unsigned CosSysConfig::m_upload_reader_thread_num = 2;
 
 //日志输出
 LOG_OUT_TYPE CosSysConfig::m_log_outtype = COS_LOG_STDOUT;
@@ -33,11 +39,23 @@ LOG_LEVEL CosSysConfig::m_log_level = COS_LOG_DBG;
 unsigned CosSysConfig::m_down_thread_pool_size = 10;
 //下载文件到本地,每次下载字节数
 unsigned CosSysConfig::m_down_slice_size = 4 * 1024 * 1024;
+//下载文件到本地前是否预分配文件空间
+bool CosSysConfig::m_down_file_preallocate = false;
+//全局传输线程池的线程数上限
+unsigned CosSysConfig::m_transfer_worker_pool_size = 0;
+//缓冲区池保留内存上限及是否使用透明大页
+uint64_t CosSysConfig::m_buffer_pool_max_bytes = kPartSize1M * 256;
+bool CosSysConfig::m_buffer_pool_use_huge_page = false;
+// 摘要算法的实现
+HASH_BACKEND CosSysConfig::m_hash_backend = HASH_BACKEND_OPENSSL;
 
 // 长连接
 bool CosSysConfig::m_keep_alive = false;
 int64_t CosSysConfig::m_keep_idle = 20;
 int64_t CosSysConfig::m_keep_intvl = 5;
+unsigned CosSysConfig::m_max_idle_sessions_per_host = 16;
+unsigned CosSysConfig::m_max_sessions_per_host = 0;
+int64_t CosSysConfig::m_session_idle_timeout = 30;
 bool CosSysConfig::m_is_check_md5 = false;
 
 // 设置私有云host
@@ -76,10 +94,23 @@ void CosSysConfig::PrintValue() {
   std::cout << "recv_timeout_in_ms:" << m_recv_timeout_in_ms << std::endl;
   std::cout << "threadpool_size:" << m_threadpool_size << std::endl;
   std::cout << "asyn_threadpool_size:" << m_asyn_threadpool_size << std::endl;
+  std::cout << "upload_read_ahead_depth:" << m_upload_read_ahead_depth
+            << std::endl;
+  std::cout << "upload_reader_thread_num:" << m_upload_reader_thread_num
+            << std::endl;
   std::cout << "log_outtype:" << m_log_outtype << std::endl;
   std::cout << "log_level:" << m_log_level << std::endl;
   std::cout << "down_thread_pool_size:" << m_down_thread_pool_size << std::endl;
   std::cout << "down_slice_size:" << m_down_slice_size << std::endl;
+  std::cout << "down_file_preallocate:" << m_down_file_preallocate
+            << std::endl;
+  std::cout << "transfer_worker_pool_size:" << GetTransferWorkerPoolSize()
+            << std::endl;
+  std::cout << "buffer_pool_max_bytes:" << m_buffer_pool_max_bytes
+            << std::endl;
+  std::cout << "buffer_pool_use_huge_page:" << m_buffer_pool_use_huge_page
+            << std::endl;
+  std::cout << "hash_backend:" << m_hash_backend << std::endl;
   std::cout << "is_domain_same_to_host:" << m_is_domain_same_to_host
             << std::endl;
   std::cout << "dest_domain:" << m_dest_domain << std::endl;
@@ -88,9 +119,20 @@ void CosSysConfig::PrintValue() {
   std::cout << "keepalive:" << m_keep_alive << std::endl;
   std::cout << "keepidle:" << m_keep_idle << std::endl;
   std::cout << "keepintvl:" << m_keep_intvl << std::endl;
+  std::cout << "max_idle_sessions_per_host:" << m_max_idle_sessions_per_host
+            << std::endl;
+  std::cout << "max_sessions_per_host:" << m_max_sessions_per_host
+            << std::endl;
+  std::cout << "session_idle_timeout:" << m_session_idle_timeout << std::endl;
 }
 
-void CosSysConfig::SetKeepAlive(bool keep_alive) { m_keep_alive = keep_alive; }
+void CosSysConfig::SetKeepAlive(bool keep_alive) {
+  m_keep_alive = keep_alive;
+  if (!keep_alive) {
+    // 关闭长连接时释放池中已有的空闲连接
+    GetGlobalHttpSessionPool().Clear();
+  }
+}
 
 void CosSysConfig::SetKeepIdle(int64_t keep_idle) { m_keep_idle = keep_idle; }
 
@@ -98,6 +140,24 @@ void CosSysConfig::SetKeepIntvl(int64_t keep_intvl) {
   m_keep_intvl = keep_intvl;
 }
 
+void CosSysConfig::SetMaxIdleSessionsPerHost(unsigned max_idle_sessions) {
+  m_max_idle_sessions_per_host = max_idle_sessions;
+  GetGlobalHttpSessionPool().SetMaxIdlePerHost(max_idle_sessions);
+}
+
+void CosSysConfig::SetMaxSessionsPerHost(unsigned max_sessions) {
+  m_max_sessions_per_host = max_sessions;
+  GetGlobalHttpSessionPool().SetMaxActivePerHost(max_sessions);
+}
+
+void CosSysConfig::SetSessionIdleTimeout(int64_t idle_timeout_in_s) {
+  if (idle_timeout_in_s < 1) {
+    idle_timeout_in_s = 1;
+  }
+  m_session_idle_timeout = idle_timeout_in_s;
+  GetGlobalHttpSessionPool().SetIdleTimeout(idle_timeout_in_s);
+}
+
 void CosSysConfig::SetUploadPartSize(uint64_t part_size) {
   m_upload_part_size = part_size;
 }
@@ -114,6 +174,9 @@ void CosSysConfig::SetDownThreadPoolSize(unsigned size) {
   } else {
     m_down_thread_pool_size = size;
   }
+  if (m_transfer_worker_pool_size == 0) {
+    GetGlobalTransferWorkerPool().SetMaxWorkers(GetTransferWorkerPoolSize());
+  }
 }
 
 void CosSysConfig::SetDownSliceSize(unsigned slice_size) {
@@ -137,12 +200,64 @@ unsigned CosSysConfig::GetDownThreadPoolSize() {
 
 unsigned CosSysConfig::GetDownSliceSize() { return m_down_slice_size; }
 
+void CosSysConfig::SetDownFilePreallocate(bool preallocate) {
+  m_down_file_preallocate = preallocate;
+}
+
+bool CosSysConfig::GetDownFilePreallocate() { return m_down_file_preallocate; }
+
+void CosSysConfig::SetTransferWorkerPoolSize(unsigned size) {
+  m_transfer_worker_pool_size = size;
+  GetGlobalTransferWorkerPool().SetMaxWorkers(GetTransferWorkerPoolSize());
+}
+
+unsigned CosSysConfig::GetTransferWorkerPoolSize() {
+  if (m_transfer_worker_pool_size == 0) {
+    return m_threadpool_size + m_down_thread_pool_size;
+  }
+  return m_transfer_worker_pool_size;
+}
+
+void CosSysConfig::SetBufferPoolMaxBytes(uint64_t max_bytes) {
+  m_buffer_pool_max_bytes = max_bytes;
+  GetGlobalBufferPool().SetMaxCachedBytes(max_bytes);
+}
+
+uint64_t CosSysConfig::GetBufferPoolMaxBytes() {
+  return m_buffer_pool_max_bytes;
+}
+
+void CosSysConfig::SetBufferPoolUseHugePage(bool use_huge_page) {
+  m_buffer_pool_use_huge_page = use_huge_page;
+  GetGlobalBufferPool().SetUseHugePage(use_huge_page);
+}
+
+bool CosSysConfig::GetBufferPoolUseHugePage() {
+  return m_buffer_pool_use_huge_page;
+}
+
+void CosSysConfig::SetHashBackend(HASH_BACKEND backend) {
+  m_hash_backend = backend;
+}
+
+HASH_BACKEND CosSysConfig::GetHashBackend() { return m_hash_backend; }
+
 bool CosSysConfig::GetKeepAlive() { return m_keep_alive; }
 
 int64_t CosSysConfig::GetKeepIdle() { return m_keep_idle; }
 
 int64_t CosSysConfig::GetKeepIntvl() { return m_keep_intvl; }
 
+unsigned CosSysConfig::GetMaxIdleSessionsPerHost() {
+  return m_max_idle_sessions_per_host;
+}
+
+unsigned CosSysConfig::GetMaxSessionsPerHost() {
+  return m_max_sessions_per_host;
+}
+
+int64_t CosSysConfig::GetSessionIdleTimeout() { return m_session_idle_timeout; }
+
 void CosSysConfig::SetAuthExpiredTime(uint64_t time) {
   m_sign_expire_in_s = time;
 }
@@ -167,6 +282,9 @@ void CosSysConfig::SetUploadThreadPoolSize(unsigned size) {
   } else {
     m_threadpool_size = size;
   }
+  if (m_transfer_worker_pool_size == 0) {
+    GetGlobalTransferWorkerPool().SetMaxWorkers(GetTransferWorkerPoolSize());
+  }
 }
 
 void CosSysConfig::SetAsynThreadPoolSize(unsigned size) {
@@ -184,6 +302,28 @@ unsigned CosSysConfig::GetAsynThreadPoolSize() {
 
 unsigned CosSysConfig::GetUploadThreadPoolSize() { return m_threadpool_size; }
 
+void CosSysConfig::SetUploadReadAheadDepth(unsigned depth) {
+  m_upload_read_ahead_depth = depth < 1 ? 1 : depth;
+}
+
+unsigned CosSysConfig::GetUploadReadAheadDepth() {
+  return m_upload_read_ahead_depth;
+}
+
+void CosSysConfig::SetUploadReaderThreadNum(unsigned num) {
+  if (num < 1) {
+    m_upload_reader_thread_num = 1;
+  } else if (num > 8) {
+    m_upload_reader_thread_num = 8;
+  } else {
+    m_upload_reader_thread_num = num;
+  }
+}
+
+unsigned CosSysConfig::GetUploadReaderThreadNum() {
+  return m_upload_reader_thread_num;
+}
+
 void CosSysConfig::SetLogOutType(LOG_OUT_TYPE log) { m_log_outtype = log; }
 
 void CosSysConfig::SetLogLevel(LOG_LEVEL level) { m_log_level = level; }
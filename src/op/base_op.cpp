@@ -320,6 +320,121 @@ CosResult BaseOp::DownloadRequest(const std::string &host, const std::string &pa
   return result;
 }
 
+CosResult BaseOp::StreamAction(
+    const std::string& host, const std::string& path, const BaseReq& req,
+    const std::map<std::string, std::string>& additional_headers,
+    const std::map<std::string, std::string>& additional_params,
+    const std::string& req_body, BaseResp* resp, std::ostream& os) {
+  CosResult result;
+  if (!CheckConfigValidation()) {
+    std::string err_msg =
+        "Invalid access_key secret_key or region, please check your "
+        "configuration";
+    SDK_LOG_ERR("%s", err_msg.c_str());
+    result.SetErrorMsg(err_msg);
+    result.SetFail();
+    return result;
+  }
+
+  std::string domain = host;
+  for (uint32_t i = 0; ; i++) {
+    result = StreamRequest(domain, path, req, additional_headers,
+                           additional_params, req_body, resp, os, i);
+    if (i >= m_op_util.GetMaxRetryTimes() || m_op_util.NoNeedRetry(result)) {
+      return result;
+    }
+    // 已输出的数据无法撤回时不能重试
+    if (os.rdbuf()->pubseekpos(0, std::ios_base::out) ==
+        std::streampos(std::streamoff(-1))) {
+      SDK_LOG_WARN("Response stream can not rewind, give up retry");
+      return result;
+    }
+    os.clear();
+    if (m_op_util.ShouldChangeBackupDomain(result, i)) {
+      domain = BaseOpUtil::ChangeHostSuffix(domain);
+    }
+    m_op_util.SleepBeforeRetry(i);
+  }
+}
+
+CosResult BaseOp::StreamRequest(
+    const std::string& host, const std::string& path, const BaseReq& req,
+    const std::map<std::string, std::string>& additional_headers,
+    const std::map<std::string, std::string>& additional_params,
+    const std::string& req_body, BaseResp* resp, std::ostream& os,
+    const uint32_t& request_retry_num) {
+  CosResult result;
+  std::map<std::string, std::string> req_headers = req.GetHeaders();
+  std::map<std::string, std::string> req_params = req.GetParams();
+  req_headers.insert(additional_headers.begin(), additional_headers.end());
+  req_params.insert(additional_params.begin(), additional_params.end());
+  const std::string& tmp_token = m_config->GetTmpToken();
+  if (!tmp_token.empty()) {
+    req_headers["x-cos-security-token"] = tmp_token;
+  }
+
+  // 1. 获取host
+  if (!IsDomainSameToHost()) {
+    req_headers["Host"] = host;
+  } else {
+    req_headers["Host"] = GetDestDomain();
+  }
+
+  if (request_retry_num > 0) {
+    req_headers[kReqHeaderXCosSdkRetry] = "true";
+  }
+
+  std::unordered_set<std::string> not_sign_headers;
+  if (!req.SignHeaderHost()) {
+    not_sign_headers.insert("Host");
+  }
+  req_headers[kHttpHeaderContentLength] = std::to_string(req_body.length());
+
+  // 2. 计算签名
+  std::string auth_str = AuthTool::Sign(GetAccessKey(), GetSecretKey(), req.GetMethod(),
+                     req.GetPath(), req_headers, req_params, not_sign_headers);
+  if (auth_str.empty()) {
+    result.SetErrorMsg("Generate auth str fail, check your access_key/secret_key.");
+    return result;
+  }
+  req_headers["Authorization"] = auth_str;
+
+  // 3. 发送请求, 2xx的响应正文直接写入os
+  std::map<std::string, std::string> resp_headers;
+  std::string xml_err_str;
+
+  std::string dest_url = GetRealUrl(host, path, req.IsHttps());
+  std::string err_msg = "";
+  uint64_t real_byte = 0;
+  int http_code = HttpSender::SendRequest(
+      nullptr, req.GetMethod(), dest_url, req_params, req_headers, req_body,
+      req.GetConnTimeoutInms(), req.GetRecvTimeoutInms(), &resp_headers,
+      &xml_err_str, os, &err_msg, &real_byte, false, req.GetVerifyCert(),
+      req.GetCaLocation(), req.GetSSLCtxCallback(), req.GetSSLCtxCbData());
+  if (http_code < 0) {
+    result.SetHttpStatus(http_code);
+    result.SetErrorMsg(err_msg);
+    return result;
+  }
+
+  result.SetRealByte(real_byte);
+  // 4. 解析返回的xml字符串
+  result.SetHttpStatus(http_code);
+  if (http_code > 299 || http_code < 200) {
+    // 无法解析的错误, 填充到cos_result的error_info中
+    if (!result.ParseFromHttpResponse(resp_headers, xml_err_str)) {
+      result.SetErrorMsg(xml_err_str);
+    }
+    return result;
+  }
+
+  result.SetSucc();
+  resp->ParseFromHeaders(resp_headers);
+  // resp requestid to result
+  result.SetXCosRequestId(resp->GetXCosRequestId());
+  return result;
+}
+
 CosResult BaseOp::UploadAction(
     const std::string& host, const std::string& path, const BaseReq& req,
     const std::map<std::string, std::string>& additional_headers,
@@ -6,8 +6,18 @@
 // Description:
 
 #include "op/bucket_op.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
 #include "cos_defines.h"
 #include "util/codec_util.h"
+#include "util/transfer_worker_pool.h"
 
 namespace qcloud_cos {
 
@@ -59,6 +69,383 @@ CosResult BucketOp::ListMultipartUpload(const ListMultipartUploadReq& req,
   return NormalAction(host, path, req, "", false, resp);
 }
 
+namespace {
+
+// 并行列出时单次列出请求返回的最大条目数
+const uint64_t kParallelListMaxKeys = 1000;
+
+class ParallelBucketLister;
+
+// 一个前缀的列出任务, 有序输出时同时作为结果树的节点
+// 有序输出时缓存超过上限的任务会暂停并记录进度, 之后重新提交从断点继续
+class ListPrefixNode : public Poco::Runnable {
+ public:
+  // 有序输出时按key顺序缓存的条目, child非空时表示一个子前缀
+  struct Item {
+    Item() : child(nullptr) {}
+    Content content;
+    ListPrefixNode* child;
+  };
+
+  ListPrefixNode(ParallelBucketLister* lister, const std::string& prefix)
+      : m_lister(lister),
+        m_prefix(prefix),
+        m_split(false),
+        m_parked(false),
+        m_done(false) {}
+
+  void run() override;
+
+  ParallelBucketLister* m_lister;
+  std::string m_prefix;
+  // 以下字段由lister的m_mutex保护, 或只由本节点当前的任务访问
+  bool m_split;          // 已按"/"拆分, 从m_marker继续分页列出
+  std::string m_marker;
+  bool m_parked;         // 因缓存已满暂停, 等待重新提交
+  std::deque<Item> m_items;
+  bool m_done;
+};
+
+class ParallelBucketLister {
+ public:
+  ParallelBucketLister(BucketOp* bucket_op, const ParallelGetBucketReq& req,
+                       const ListContentsCallback& callback)
+      : m_bucket_op(bucket_op),
+        m_bucket_name(req.GetBucketName()),
+        m_ordered(req.IsOrdered()),
+        m_callback(callback),
+        m_stop(false),
+        m_failed(false),
+        m_max_buffered(req.GetMaxBufferedKeys()),
+        m_buffered(0),
+        m_emit_node(nullptr),
+        m_group(GetGlobalTransferWorkerPool(), req.GetConcurrency()) {}
+
+  CosResult Run(const std::string& prefix) {
+    ListPrefixNode* root = NewNode(prefix);
+    m_group.Start(*root);
+    if (m_ordered) {
+      EmitOrdered(root);
+    }
+    m_group.JoinAll();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_failed) {
+      return m_fail_result;
+    }
+    CosResult result;
+    result.SetSucc();
+    return result;
+  }
+
+  void ListPrefix(ListPrefixNode* node) {
+    if (!node->m_split) {
+      // 先不带delimiter列出一页, 对象不足一页的前缀无需拆分
+      if (!Admit(node)) {
+        return;
+      }
+      GetBucketReq req(m_bucket_name);
+      req.SetPrefix(node->m_prefix);
+      req.SetMaxKeys(kParallelListMaxKeys);
+      GetBucketResp resp;
+      if (m_stop || !GetBucket(req, &resp)) {
+        Finish(node);
+        return;
+      }
+      if (!resp.IsTruncated()) {
+        AddPage(node, resp.GetContents(), std::vector<std::string>());
+        Finish(node);
+        return;
+      }
+      node->m_split = true;
+    }
+
+    // 以"/"为delimiter分页列出, 直接位于该前缀下的对象随页输出,
+    // 子前缀交给新任务并发列出
+    while (!m_stop) {
+      if (!Admit(node)) {
+        return;
+      }
+      GetBucketReq req(m_bucket_name);
+      req.SetPrefix(node->m_prefix);
+      req.SetDelimiter("/");
+      req.SetMaxKeys(kParallelListMaxKeys);
+      if (!node->m_marker.empty()) {
+        req.SetMarker(node->m_marker);
+      }
+      GetBucketResp resp;
+      if (!GetBucket(req, &resp)) {
+        break;
+      }
+      AddPage(node, resp.GetContents(), resp.GetCommonPrefixes());
+      if (!resp.IsTruncated()) {
+        break;
+      }
+      node->m_marker = resp.GetNextMarker();
+    }
+    Finish(node);
+  }
+
+ private:
+  ListPrefixNode* NewNode(const std::string& prefix) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_nodes.emplace_back(new ListPrefixNode(this, prefix));
+    return m_nodes.back().get();
+  }
+
+  void Finish(ListPrefixNode* node) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      node->m_done = true;
+    }
+    m_done_cond.notify_all();
+  }
+
+  // 有序输出时缓存已满则暂停节点, 返回false后任务直接退出, 不能再访问node
+  // 正在输出的节点缓存为空时不暂停, 否则调用线程会一直等待
+  bool Admit(ListPrefixNode* node) {
+    if (!m_ordered) {
+      return true;
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_stop || m_buffered < m_max_buffered ||
+          (node == m_emit_node && node->m_items.empty())) {
+        return true;
+      }
+      node->m_parked = true;
+      m_parked.push_back(node);
+    }
+    m_done_cond.notify_all();
+    return false;
+  }
+
+  // 重新提交暂停的节点, 需持有m_mutex
+  void ResumeLocked(ListPrefixNode* node) {
+    node->m_parked = false;
+    m_parked.erase(std::find(m_parked.begin(), m_parked.end(), node));
+    m_group.Start(*node);
+  }
+
+  void ResumeAllLocked() {
+    for (size_t i = 0; i < m_parked.size(); ++i) {
+      m_parked[i]->m_parked = false;
+      m_group.Start(*m_parked[i]);
+    }
+    m_parked.clear();
+  }
+
+  void AddPage(ListPrefixNode* node, const std::vector<Content>& contents,
+               const std::vector<std::string>& prefixes) {
+    if (m_stop) {
+      return;
+    }
+    if (!m_ordered) {
+      for (size_t i = 0; i < prefixes.size(); ++i) {
+        m_group.Start(*NewNode(prefixes[i]));
+      }
+      Emit(contents);
+      return;
+    }
+
+    // 同一页的对象和子前缀各自有序, 归并后追加到节点, 跨页之间key递增
+    std::vector<ListPrefixNode::Item> items;
+    items.reserve(contents.size() + prefixes.size());
+    size_t i = 0;
+    size_t j = 0;
+    while (i < contents.size() || j < prefixes.size()) {
+      items.push_back(ListPrefixNode::Item());
+      if (j == prefixes.size() ||
+          (i < contents.size() && contents[i].m_key < prefixes[j])) {
+        items.back().content = contents[i++];
+      } else {
+        items.back().child = NewNode(prefixes[j++]);
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_buffered += items.size();
+      for (size_t k = 0; k < items.size(); ++k) {
+        node->m_items.push_back(items[k]);
+      }
+    }
+    m_done_cond.notify_all();
+    // 子前缀任务启动后先检查缓存, 已满时立即暂停
+    for (size_t k = 0; k < items.size(); ++k) {
+      if (items[k].child != nullptr) {
+        m_group.Start(*items[k].child);
+      }
+    }
+  }
+
+  void Emit(const std::vector<Content>& contents) {
+    if (contents.empty()) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(m_callback_mutex);
+    if (!m_stop && !m_callback(contents)) {
+      m_stop = true;
+    }
+  }
+
+  // 在调用线程中按key顺序深度优先输出, 节点的条目随列出分批输出
+  bool EmitOrdered(ListPrefixNode* node) {
+    while (true) {
+      std::deque<ListPrefixNode::Item> items;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_emit_node = node;
+        m_done_cond.wait(lock, [this, node]() {
+          return m_stop || !node->m_items.empty() || node->m_done ||
+                 node->m_parked;
+        });
+        if (m_stop) {
+          return false;
+        }
+        if (node->m_items.empty()) {
+          if (node->m_done) {
+            return true;
+          }
+          // 正在输出的节点因缓存已满暂停, 缓存为空时可以继续列出
+          ResumeLocked(node);
+          continue;
+        }
+        items.swap(node->m_items);
+      }
+
+      const size_t item_num = items.size();
+      std::vector<Content> batch;
+      for (size_t i = 0; i < item_num; ++i) {
+        ListPrefixNode::Item& item = items[i];
+        if (item.child == nullptr) {
+          batch.push_back(item.content);
+          if (batch.size() < kParallelListMaxKeys) {
+            continue;
+          }
+        }
+        if (!batch.empty()) {
+          if (!m_callback(batch)) {
+            m_stop = true;
+            return false;
+          }
+          batch.clear();
+        }
+        if (item.child != nullptr && !EmitOrdered(item.child)) {
+          return false;
+        }
+      }
+      if (!batch.empty() && !m_callback(batch)) {
+        m_stop = true;
+        return false;
+      }
+
+      // 已输出的条目不再保留, 缓存低于上限时恢复暂停的节点
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_buffered -= item_num;
+      if (m_buffered < m_max_buffered) {
+        ResumeAllLocked();
+      }
+    }
+  }
+
+  bool GetBucket(const GetBucketReq& req, GetBucketResp* resp) {
+    CosResult result = m_bucket_op->GetBucket(req, resp);
+    if (!result.IsSucc()) {
+      *resp = GetBucketResp();
+      result = m_bucket_op->GetBucket(req, resp, COS_CHANGE_BACKUP_DOMAIN);
+    }
+    if (result.IsSucc()) {
+      return true;
+    }
+
+    SDK_LOG_ERR("ParallelGetBucket: list bucket(%s) prefix(%s) fail",
+                m_bucket_name.c_str(), req.GetParam("prefix").c_str());
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_failed) {
+      m_failed = true;
+      m_fail_result = result;
+    }
+    m_stop = true;
+    return false;
+  }
+
+  BucketOp* m_bucket_op;
+  std::string m_bucket_name;
+  bool m_ordered;
+  ListContentsCallback m_callback;
+
+  std::atomic<bool> m_stop;
+  std::mutex m_mutex;
+  std::condition_variable m_done_cond;
+  bool m_failed;
+  CosResult m_fail_result;
+  std::deque<std::unique_ptr<ListPrefixNode>> m_nodes;
+  // 有序输出时已列出尚未回调的条目数及上限, 超过上限的节点暂停
+  const uint64_t m_max_buffered;
+  uint64_t m_buffered;
+  ListPrefixNode* m_emit_node;
+  std::vector<ListPrefixNode*> m_parked;
+  // 无序输出时串行化回调
+  std::mutex m_callback_mutex;
+  // 析构时先等待任务结束, 再释放m_nodes
+  TransferWorkerPool::Group m_group;
+};
+
+void ListPrefixNode::run() { m_lister->ListPrefix(this); }
+
+}  // namespace
+
+CosResult BucketOp::ParallelGetBucket(const ParallelGetBucketReq& req,
+                                      const ListContentsCallback& callback) {
+  ParallelBucketLister lister(this, req, callback);
+  return lister.Run(req.GetPrefix());
+}
+
+CosResult BucketOp::StreamGetBucket(const GetBucketReq& req,
+                                    ListXmlHandler* handler,
+                                    ListPageInfo* page_info,
+                                    bool change_backup_domain) {
+  std::string host = CosSysConfig::GetHost(GetAppId(), m_config->GetRegion(),
+                                           req.GetBucketName(), change_backup_domain);
+  // 列出结果的响应头中没有对应正文的ETag, 不做MD5校验
+  GetBucketReq list_req = req;
+  list_req.SetCheckMD5(false);
+  GetBucketResp resp;
+  return StreamListAction(host, list_req, &resp, handler, page_info);
+}
+
+CosResult BucketOp::StreamGetBucketObjectVersions(
+    const GetBucketObjectVersionsReq& req, ListXmlHandler* handler,
+    ListPageInfo* page_info, bool change_backup_domain) {
+  std::string host = CosSysConfig::GetHost(GetAppId(), m_config->GetRegion(),
+                                           req.GetBucketName(), change_backup_domain);
+  GetBucketObjectVersionsReq list_req = req;
+  list_req.SetCheckMD5(false);
+  GetBucketObjectVersionsResp resp;
+  return StreamListAction(host, list_req, &resp, handler, page_info);
+}
+
+CosResult BucketOp::StreamListAction(const std::string& host,
+                                     const BucketReq& req, BaseResp* resp,
+                                     ListXmlHandler* handler,
+                                     ListPageInfo* page_info) {
+  ListXmlParser parser(handler);
+  ListXmlStreamBuf stream_buf(&parser);
+  std::ostream os(&stream_buf);
+  // 重试时DownloadAction会把流seek到起点, 解析器随之重置
+  CosResult result = DownloadAction(host, req.GetPath(), req, resp, os);
+  if (!result.IsSucc()) {
+    return result;
+  }
+  if (!parser.Finish()) {
+    result.SetFail();
+    result.SetErrorMsg("Parse list result fail, " + parser.GetErrorMsg());
+    return result;
+  }
+  *page_info = parser.GetPageInfo();
+  return result;
+}
+
 CosResult BucketOp::DeleteBucket(const DeleteBucketReq& req,
                                  DeleteBucketResp* resp, bool change_backup_domain) {
   std::string host = CosSysConfig::GetHost(GetAppId(), m_config->GetRegion(),
@@ -4,8 +4,10 @@
 #include <iostream>
 #include <sstream>
 #include "cos_sys_config.h"
-#include "util/http_sender.h"
 #include "util/base_op_util.h"
+#include "util/crc64.h"
+#include "util/file_util.h"
+#include "util/http_sender.h"
 
 namespace qcloud_cos {
 
@@ -23,8 +25,7 @@ FileDownTask::FileDownTask(const std::string& host,
                            bool verify_cert,
                            const std::string& ca_lication,
                            SSLCtxCallback ssl_ctx_cb,
-                           void *user_data,
-                           Semaphore* semaphore)
+                           void *user_data)
     : m_host(host),
       m_path(path),
       m_is_https(is_https),
@@ -37,7 +38,11 @@ FileDownTask::FileDownTask(const std::string& host,
       m_offset(offset),
       m_data_buf_ptr(pbuf),
       m_data_len(data_len),
-      m_semaphore(semaphore),
+      m_completion_queue(nullptr),
+      m_slot(0),
+      m_write_fd(-1),
+      m_calc_crc64(false),
+      m_crc64(0),
       m_resp(""),
       m_is_task_success(false),
       m_task_info(),
@@ -51,12 +56,16 @@ FileDownTask::FileDownTask(const std::string& host,
 void FileDownTask::run() {
   m_resp = "";
   m_is_task_success = false;
+  m_crc64 = 0;
   m_task_info.status = TaskStatus::TASK_RUNNING;
   DownTask();
-  // 任务完成后标记状态, 最后自动通知信号量，释放资源槽位
+  if (m_is_task_success) {
+    WriteDownData();
+  }
+  // 任务完成后标记状态, 最后推入完成队列通知调度线程
   m_task_info.status = TaskStatus::TASK_COMPLETED;
-  if (m_semaphore != nullptr) {
-    m_semaphore->release();
+  if (m_completion_queue != nullptr) {
+    m_completion_queue->push(m_slot);
   }
 }
 
@@ -109,14 +118,34 @@ void FileDownTask::DownTask() {
     }
 }
 
+void FileDownTask::WriteDownData() {
+  if (m_calc_crc64) {
+    m_crc64 = CRC64::CalcCRC(0, m_data_buf_ptr, m_real_down_len);
+  }
+  if (m_write_fd < 0) {
+    return;
+  }
+  // 各任务写入互不重叠的区间, 无需调用方串行化
+  std::string write_err;
+  if (!FileUtil::WriteFileAt(m_write_fd, m_data_buf_ptr, m_real_down_len,
+                             m_offset, &write_err)) {
+    m_err_msg = "down data, " + write_err;
+    SDK_LOG_ERR("FileDownload: path(%s) %s", m_path.c_str(), m_err_msg.c_str());
+    m_http_status = kHttpStatusNetError;
+    m_is_task_success = false;
+  }
+}
+
 void FileDownTask::SendRequestOnce(std::string domain) {
   m_resp_headers.clear();
   m_resp = "";
 
   std::string full_url = m_op_util.GetRealUrl(domain, m_path, m_is_https);
-  m_http_status = HttpSender::SendRequest(m_handler, "GET", full_url, m_params, m_headers, "", m_conn_timeout_in_ms,
-      m_recv_timeout_in_ms, &m_resp_headers, &m_resp, &m_err_msg, false, m_verify_cert, m_ca_location, m_ssl_ctx_cb,
-      m_user_data);
+  // 响应正文直接写入分片缓冲区, 出错时m_resp保存错误响应
+  uint64_t real_byte = 0;
+  m_http_status = HttpSender::SendRequest(m_handler, "GET", full_url, m_params, m_headers, m_conn_timeout_in_ms,
+      m_recv_timeout_in_ms, &m_resp_headers, &m_resp, reinterpret_cast<char*>(m_data_buf_ptr), m_data_len,
+      &m_err_msg, &real_byte, m_verify_cert, m_ca_location, m_ssl_ctx_cb, m_user_data);
 
   // 当实际长度小于请求的数据长度时httpcode为206
   if (m_http_status != 200 && m_http_status != 206) {
@@ -125,12 +154,8 @@ void FileDownTask::SendRequestOnce(std::string domain) {
       return;
   }
 
-  size_t buf_max_size = m_data_len;
-  size_t len = std::min(m_resp.length(), buf_max_size);
-  memcpy(m_data_buf_ptr, m_resp.c_str(), len);
-  m_real_down_len = len;
+  m_real_down_len = static_cast<size_t>(real_byte);
   m_is_task_success = true;
-  m_resp = "";
 }
 
 }  // namespace qcloud_cos
@@ -0,0 +1,258 @@
+#include "op/file_part_reader.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+
+#include "cos_defines.h"
+#include "cos_sys_config.h"
+#include "util/buffer_pool.h"
+
+namespace qcloud_cos {
+
+FilePartReader::FilePartReader(uint64_t file_size, uint64_t part_size,
+                               unsigned max_in_use, unsigned depth,
+                               unsigned reader_num)
+    : m_file_size(file_size),
+      m_part_size(part_size),
+      m_part_count(0),
+      m_reader_num(std::max(reader_num, 1u)),
+      m_next_read_part(1),
+      m_next_deliver_part(1),
+      m_stopped(false),
+      m_failed(false),
+#if defined(_WIN32)
+      m_is_wide_path(false)
+#else
+      m_fd(-1)
+#endif
+{
+  if (m_part_size > 0) {
+    m_part_count = (m_file_size + m_part_size - 1) / m_part_size;
+  }
+  uint64_t buf_num = static_cast<uint64_t>(max_in_use) + std::max(depth, 1u);
+  // 缓冲区数量不超过分块数量, 小文件不必多分配
+  buf_num = std::max<uint64_t>(1, std::min<uint64_t>(buf_num, m_part_count));
+  m_reader_num = static_cast<unsigned>(
+      std::min<uint64_t>(m_reader_num, buf_num));
+  size_t buf_size = static_cast<size_t>(std::min(m_part_size, m_file_size));
+  for (uint64_t i = 0; i < buf_num; ++i) {
+    unsigned char* buf = GetGlobalBufferPool().Acquire(buf_size);
+    if (buf == nullptr) {
+      // 缓冲区少于调用方持有的分块数时会互相等待, 必须全部分配成功
+      m_err_msg = "allocate part buffer fail, size=" + std::to_string(buf_size);
+      ReleaseBuffers();
+      break;
+    }
+    m_buffers.push_back(buf);
+    m_free_buffers.push_back(buf);
+  }
+}
+
+void FilePartReader::ReleaseBuffers() {
+  for (size_t i = 0; i < m_buffers.size(); ++i) {
+    GetGlobalBufferPool().Release(m_buffers[i]);
+  }
+  m_buffers.clear();
+  m_free_buffers.clear();
+}
+
+FilePartReader::~FilePartReader() {
+  Stop();
+#if !defined(_WIN32)
+  if (m_fd >= 0) {
+    close(m_fd);
+    m_fd = -1;
+  }
+#endif
+  ReleaseBuffers();
+}
+
+bool FilePartReader::Start(const std::string& path) {
+  if (m_buffers.empty()) {
+    return false;
+  }
+#if defined(_WIN32)
+  m_path = path;
+  m_is_wide_path = false;
+  std::ifstream fin(path, std::ios::in | std::ios::binary);
+  if (!fin) {
+    m_err_msg = "Failed to open file " + path;
+    return false;
+  }
+#else
+  m_fd = open(path.c_str(), O_RDONLY);
+  if (m_fd < 0) {
+    m_err_msg = "Failed to open file " + path + ", errno=" + std::to_string(errno);
+    return false;
+  }
+#if defined(POSIX_FADV_SEQUENTIAL)
+  posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+#endif
+  return StartThreads();
+}
+
+#if defined(_WIN32)
+bool FilePartReader::Start(const std::wstring& path) {
+  if (m_buffers.empty()) {
+    return false;
+  }
+  m_wide_path = path;
+  m_is_wide_path = true;
+  std::ifstream fin(path, std::ios::in | std::ios::binary);
+  if (!fin) {
+    m_err_msg = "Failed to open wide char file";
+    return false;
+  }
+  return StartThreads();
+}
+#endif
+
+bool FilePartReader::StartThreads() {
+  for (unsigned i = 0; i < m_reader_num; ++i) {
+    m_readers.emplace_back(&FilePartReader::ReaderLoop, this);
+  }
+  return true;
+}
+
+bool FilePartReader::ReadPart(uint64_t offset, unsigned char* buf, size_t len,
+                              std::string* err_msg) {
+#if defined(_WIN32)
+  std::ifstream fin;
+  if (m_is_wide_path) {
+    fin.open(m_wide_path, std::ios::in | std::ios::binary);
+  } else {
+    fin.open(m_path, std::ios::in | std::ios::binary);
+  }
+  fin.seekg(offset, std::ios::beg);
+  fin.read(reinterpret_cast<char*>(buf), len);
+  if (static_cast<size_t>(fin.gcount()) != len) {
+    *err_msg = "read file fail, offset=" + std::to_string(offset) +
+               ", expect_len=" + std::to_string(len) +
+               ", read_len=" + std::to_string(fin.gcount());
+    return false;
+  }
+  return true;
+#else
+  size_t done = 0;
+  while (done < len) {
+    ssize_t n = pread(m_fd, buf + done, len - done,
+                      static_cast<off_t>(offset + done));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      // 文件被截断或读取出错, 避免上传残缺对象
+      *err_msg = "read file fail, offset=" + std::to_string(offset) +
+                 ", expect_len=" + std::to_string(len) +
+                 ", read_len=" + std::to_string(done) +
+                 ", errno=" + std::to_string(n < 0 ? errno : 0);
+      return false;
+    }
+    done += static_cast<size_t>(n);
+  }
+  return true;
+#endif
+}
+
+void FilePartReader::ReaderLoop() {
+  while (true) {
+    ReadAheadPart part;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_buffer_cond.wait(lock, [this]() {
+        return m_stopped || m_failed || m_next_read_part > m_part_count ||
+               !m_free_buffers.empty();
+      });
+      if (m_stopped || m_failed || m_next_read_part > m_part_count) {
+        return;
+      }
+      // 按顺序认领分块, 保证分块总是先于其后续分块获得缓冲区
+      part.part_number = m_next_read_part++;
+      part.offset = (part.part_number - 1) * m_part_size;
+      part.len = static_cast<size_t>(
+          std::min(m_part_size, m_file_size - part.offset));
+      part.buf = m_free_buffers.back();
+      m_free_buffers.pop_back();
+    }
+
+    std::string err_msg;
+    bool ok = ReadPart(part.offset, part.buf, part.len, &err_msg);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!ok) {
+      SDK_LOG_ERR("read ahead part %" PRIu64 " fail: %s", part.part_number,
+                  err_msg.c_str());
+      if (!m_failed) {
+        m_failed = true;
+        m_err_msg = err_msg;
+      }
+      m_free_buffers.push_back(part.buf);
+      m_ready_cond.notify_all();
+      m_buffer_cond.notify_all();
+      return;
+    }
+    m_ready_parts[part.part_number] = part;
+    m_ready_cond.notify_all();
+  }
+}
+
+bool FilePartReader::Next(ReadAheadPart* part) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (m_next_deliver_part > m_part_count) {
+    return false;
+  }
+  m_ready_cond.wait(lock, [this]() {
+    return m_stopped || m_failed ||
+           m_ready_parts.count(m_next_deliver_part) > 0;
+  });
+  auto it = m_ready_parts.find(m_next_deliver_part);
+  if (it == m_ready_parts.end()) {
+    return false;
+  }
+  *part = it->second;
+  m_ready_parts.erase(it);
+  ++m_next_deliver_part;
+  return true;
+}
+
+void FilePartReader::Release(const unsigned char* buf) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (size_t i = 0; i < m_buffers.size(); ++i) {
+    if (m_buffers[i] == buf) {
+      m_free_buffers.push_back(m_buffers[i]);
+      m_buffer_cond.notify_one();
+      return;
+    }
+  }
+}
+
+void FilePartReader::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopped = true;
+  }
+  m_buffer_cond.notify_all();
+  m_ready_cond.notify_all();
+  for (auto& reader : m_readers) {
+    if (reader.joinable()) {
+      reader.join();
+    }
+  }
+  m_readers.clear();
+}
+
+std::string FilePartReader::GetErrMsg() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_err_msg;
+}
+
+}  // namespace qcloud_cos
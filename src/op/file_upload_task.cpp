@@ -1,16 +1,11 @@
 #include "op/file_upload_task.h"
 #include <sstream>
-#include "Poco/DigestStream.h"
-#include "Poco/MD5Engine.h"
-#include "Poco/StreamCopier.h"
 #include "util/http_sender.h"
 #include "util/string_util.h"
 #include "util/codec_util.h"
 #include "util/crc64.h"
 #include "util/base_op_util.h"
-#ifdef USE_OPENSSL_MD5
-#include <openssl/md5.h>
-#endif
+#include "util/hash_util.h"
 
 namespace qcloud_cos {
 
@@ -42,8 +37,10 @@ FileUploadTask::FileUploadTask(const std::string& host,
       m_ssl_ctx_cb(ssl_ctx_cb),
       m_user_data(user_data),
       mb_check_crc64(false),
+      mb_calc_crc64(false),
       m_crc64_value(0),
-      m_semaphore(nullptr) {}
+      m_completion_queue(nullptr),
+      m_slot(0) {}
 
 
 FileUploadTask::FileUploadTask(
@@ -78,8 +75,10 @@ FileUploadTask::FileUploadTask(
       m_ssl_ctx_cb(ssl_ctx_cb),
       m_user_data(user_data),
       mb_check_crc64(false),
+      mb_calc_crc64(false),
       m_crc64_value(0),
-      m_semaphore(nullptr) {}
+      m_completion_queue(nullptr),
+      m_slot(0) {}
 
 
 FileUploadTask::FileUploadTask(
@@ -114,18 +113,20 @@ FileUploadTask::FileUploadTask(
       m_ssl_ctx_cb(ssl_ctx_cb),
       m_user_data(user_data),
       mb_check_crc64(false),
+      mb_calc_crc64(false),
       m_crc64_value(0),
-      m_semaphore(nullptr) {}
+      m_completion_queue(nullptr),
+      m_slot(0) {}
 
 void FileUploadTask::run() {
   m_resp = "";
   m_is_task_success = false;
   m_task_info.status = TaskStatus::TASK_RUNNING;
   UploadTask();
-  // 任务完成后标记状态，最后自动通知信号量，释放资源槽位
+  // 任务完成后标记状态，最后推入完成队列通知调度线程
   m_task_info.status = TaskStatus::TASK_COMPLETED;
-  if (m_semaphore != nullptr) {
-    m_semaphore->release();
+  if (m_completion_queue != nullptr) {
+    m_completion_queue->push(m_slot);
   }
 }
 
@@ -191,28 +192,20 @@ void FileUploadTask::SetSslCtxCb(SSLCtxCallback cb, void *data) {
 
 void FileUploadTask::UploadTask() {
   std::string md5_str;
+  m_crc64_value = 0;
   // 数据一致性校验采用crc64
   if (mb_check_crc64) {
-    m_crc64_value = 0;
     m_crc64_value = CRC64::CalcCRC(m_crc64_value, static_cast<void*>(m_data_buf_ptr), m_data_len);
     SDK_LOG_DBG("Part Crc64: %" PRIu64, m_crc64_value);
   }
-  // 没有crc64则默认走md5校验
+  // 没有crc64则默认走md5校验, 整个文件需要crc64时一次遍历同时算出
+  else if (mb_calc_crc64) {
+    HashUtil::Md5Crc64(m_data_buf_ptr, m_data_len, &md5_str, &m_crc64_value);
+    SDK_LOG_DBG("Part Md5: %s, Crc64: %" PRIu64, md5_str.c_str(), m_crc64_value);
+  }
   else {
-  #ifdef USE_OPENSSL_MD5
-    unsigned char digest[MD5_DIGEST_LENGTH];
-    MD5((const unsigned char *)m_data_buf_ptr, m_data_len, digest);
-    md5_str = CodecUtil::DigestToHex(digest, MD5_DIGEST_LENGTH);
-  #else
     // 计算上传的md5
-    Poco::MD5Engine md5;
-    std::string body((const char*)m_data_buf_ptr, m_data_len);
-    std::istringstream istr(body);
-    Poco::DigestOutputStream dos(md5);
-    Poco::StreamCopier::copyStream(istr, dos);
-    dos.close();
-    md5_str = Poco::DigestEngine::digestToHex(md5.digest());
-  #endif
+    md5_str = HashUtil::Md5Hex(m_data_buf_ptr, m_data_len);
     SDK_LOG_DBG("Part Md5: %s", md5_str.c_str());
   }
 
@@ -16,30 +16,30 @@
 #else
 #include <unistd.h>
 #endif
-#ifdef USE_OPENSSL_MD5
-#include <openssl/md5.h>
-#endif
 
-#include "Poco/DigestStream.h"
+#include <algorithm>
+#include <mutex>
+
 #include "Poco/JSON/Parser.h"
-#include "Poco/MD5Engine.h"
 #include "Poco/RecursiveDirectoryIterator.h"
 #include "Poco/SortedDirectoryIterator.h"
-#include "Poco/StreamCopier.h"
-#include "Poco/ThreadPool.h"
 #include "cos_config.h"
 #include "util/json_util.h"
 #include "cos_sys_config.h"
 #include "op/file_copy_task.h"
 #include "op/file_download_task.h"
+#include "op/file_part_reader.h"
 #include "op/file_upload_task.h"
 #include "request/bucket_req.h"
 #include "response/bucket_resp.h"
 #include "util/auth_tool.h"
+#include "util/buffer_pool.h"
 #include "util/codec_util.h"
 #include "util/crc64.h"
 #include "util/file_util.h"
+#include "util/hash_util.h"
 #include "util/string_util.h"
+#include "util/transfer_worker_pool.h"
 #include "util/illegal_intercept.h"
 #include "cos_params.h"
 
@@ -119,19 +119,9 @@ bool ObjectOp::CheckSinglePart(const PutObjectByFileReq& req, uint64_t offset,
   fin.seekg(0, fin.beg);
   fin.close();
 
-  // Print content:
-  std::istringstream stringStream(std::string(data, (size_t)local_part_size));
-
-  Poco::MD5Engine md5;
-  Poco::DigestOutputStream dos(md5);
-  Poco::StreamCopier::copyStream(stringStream, dos);
-
-  dos.flush();
-
-  std::string md5_str = Poco::DigestEngine::digestToHex(md5.digest());
+  std::string md5_str = HashUtil::Md5Hex(data, (size_t)local_part_size);
 
   delete[] data;
-  dos.close();
 
   if (md5_str != etag) {
     return false;
@@ -242,32 +232,57 @@ bool ObjectOp::CheckUploadPart(const PutObjectByFileReq& req,
 void ObjectOp::UpdateResumableDownloadTaskFile(
     const std::string& json_file,
     const std::map<std::string, std::string>& element_map,
-    uint64_t resume_offset) {
+    const ResumableDownloadSlices& slices) {
   SDK_LOG_INFO("update file: %s", json_file.c_str());
-  std::ofstream ofs(json_file,
-                    std::ios::out | std::ios::binary | std::ios::trunc);
-  if (!ofs.is_open()) {
-    SDK_LOG_ERR("failed to open file:%s", json_file.c_str());
-    return;
+
+  // 完成位图: 第i个分片对应第i/8字节的第i%8位(低位在前), 以十六进制保存;
+  // 已完成分片的CRC64按分片序号顺序以逗号分隔
+  std::string bitmap((slices.done.size() + 7) / 8, '\0');
+  std::string crc64_list;
+  for (size_t idx = 0; idx < slices.done.size(); ++idx) {
+    if (!slices.done[idx]) {
+      continue;
+    }
+    bitmap[idx / 8] = static_cast<char>(bitmap[idx / 8] | (1 << (idx % 8)));
+    if (!crc64_list.empty()) {
+      crc64_list += ",";
+    }
+    crc64_list += StringUtil::Uint64ToString(slices.crc64[idx]);
   }
 
   Poco::JSON::Object::Ptr json_root = new Poco::JSON::Object();
   for (auto& it : element_map) {
     json_root->set(it.first, it.second);
   }
-  if (resume_offset > 0) {
-    json_root->set(kResumableDownloadResumeOffset,
-                   std::to_string(resume_offset));
+  json_root->set(kResumableDownloadSliceSize,
+                 std::to_string(slices.slice_size));
+  json_root->set(kResumableDownloadSliceBitmap,
+                 CodecUtil::DigestToHex(
+                     reinterpret_cast<const unsigned char*>(bitmap.data()),
+                     bitmap.size()));
+  json_root->set(kResumableDownloadSliceCrc64, crc64_list);
+
+  std::string tmp_file = json_file + ".tmp";
+  std::ofstream ofs(tmp_file,
+                    std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!ofs.is_open()) {
+    SDK_LOG_ERR("failed to open file:%s", tmp_file.c_str());
+    return;
   }
   Poco::JSON::Stringifier::stringify(json_root, ofs);
   ofs.close();
+  // 原子替换，避免进程中断导致文件损坏
+  if (std::rename(tmp_file.c_str(), json_file.c_str()) != 0) {
+    SDK_LOG_ERR("failed to rename file: %s -> %s", tmp_file.c_str(),
+                json_file.c_str());
+  }
   return;
 }
 
 bool ObjectOp::CheckResumableDownloadTask(
     const std::string& json_file,
     const std::map<std::string, std::string>& element_map,
-    uint64_t* resume_offset) {
+    ResumableDownloadSlices* slices) {
   std::ifstream ifs(json_file);
   if (ifs.good()) {
     SDK_LOG_INFO("resumable task file: %s exists, try to parse",
@@ -304,23 +319,59 @@ bool ObjectOp::CheckResumableDownloadTask(
         return false;
       }
     }
-    // get last offset
-    std::string last_offset_str;
-    if (!JsonUtil::GetStringValue(object, kResumableDownloadResumeOffset,
-                                        &last_offset_str)) {
-      SDK_LOG_WARN("Checkpoint file missing or invalid field: %s", kResumableDownloadResumeOffset);
+    // get slice info
+    std::string slice_size_str;
+    std::string bitmap_hex;
+    std::string crc64_list;
+    if (!JsonUtil::GetStringValue(object, kResumableDownloadSliceSize,
+                                  &slice_size_str) ||
+        !JsonUtil::GetStringValue(object, kResumableDownloadSliceBitmap,
+                                  &bitmap_hex) ||
+        !JsonUtil::GetStringValue(object, kResumableDownloadSliceCrc64,
+                                  &crc64_list)) {
+      SDK_LOG_WARN("Checkpoint file missing or invalid slice fields");
+      return false;
+    }
+    uint64_t slice_size = StringUtil::StringToUint64(slice_size_str);
+    uint64_t content_length = StringUtil::StringToUint64(
+        element_map.at(kResumableDownloadTaskContentLength));
+    if (slice_size == 0 || slice_size > UINT32_MAX) {
+      SDK_LOG_WARN("invalid slice_size: %s", slice_size_str.c_str());
       return false;
     }
-    *resume_offset = StringUtil::StringToUint64(last_offset_str);
-    std::string content_length_str =
-        element_map.at(kResumableDownloadTaskContentLength);
-    if (*resume_offset <= 0 ||
-        *resume_offset > StringUtil::StringToUint64(content_length_str)) {
-      SDK_LOG_WARN("invalid resume_offset: %" PRIu64, *resume_offset);
+    uint64_t slice_num = (content_length + slice_size - 1) / slice_size;
+    std::string bitmap = CodecUtil::HexToBin(bitmap_hex);
+    if (bitmap.size() != (slice_num + 7) / 8 ||
+        bitmap_hex.size() != bitmap.size() * 2) {
+      SDK_LOG_WARN("invalid slice bitmap, slice_num: %" PRIu64, slice_num);
       return false;
     }
-    SDK_LOG_DBG("resume download task check passed, resume_offset: %" PRIu64,
-                *resume_offset);
+    std::vector<std::string> crc64_vec;
+    StringUtil::SplitString(crc64_list, ',', &crc64_vec);
+
+    slices->slice_size = slice_size;
+    slices->done.assign(slice_num, false);
+    slices->crc64.assign(slice_num, 0);
+    size_t done_num = 0;
+    for (uint64_t idx = 0; idx < slice_num; ++idx) {
+      if ((static_cast<unsigned char>(bitmap[idx / 8]) >> (idx % 8)) & 1) {
+        if (done_num >= crc64_vec.size()) {
+          SDK_LOG_WARN("slice crc64 list is shorter than slice bitmap");
+          return false;
+        }
+        slices->done[idx] = true;
+        slices->crc64[idx] = StringUtil::StringToUint64(crc64_vec[done_num]);
+        ++done_num;
+      }
+    }
+    if (done_num == 0 || done_num != crc64_vec.size()) {
+      SDK_LOG_WARN("invalid slice crc64 list, done_num: %zu, crc64_num: %zu",
+                   done_num, crc64_vec.size());
+      return false;
+    }
+    SDK_LOG_DBG("resume download task check passed, slice_size: %" PRIu64
+                ", done_num: %zu, slice_num: %" PRIu64,
+                slice_size, done_num, slice_num);
     return true;
   } else {
     SDK_LOG_INFO("failed to open resumable task file: %s", json_file.c_str());
@@ -365,14 +416,11 @@ std::string ObjectOp::GenUploadCheckpointFilePath(
     const std::string& object_name) {
   // 基于源文件路径和目标路径的MD5哈希生成唯一文件名
   // 注意：这里使用路径字符串的MD5，而非文件内容MD5，避免大文件计算耗时
-  Poco::MD5Engine md5_src;
-  md5_src.update(local_file_path);
-  std::string src_md5 = Poco::DigestEngine::digestToHex(md5_src.digest());
+  std::string src_md5 =
+      HashUtil::Md5Hex(local_file_path.data(), local_file_path.size());
 
   std::string dest_path = "cos://" + bucket_name + "/" + object_name;
-  Poco::MD5Engine md5_dest;
-  md5_dest.update(dest_path);
-  std::string dest_md5 = Poco::DigestEngine::digestToHex(md5_dest.digest());
+  std::string dest_md5 = HashUtil::Md5Hex(dest_path.data(), dest_path.size());
 
   std::string file_name = src_md5 + "--" + dest_md5 + kResumableUploadTaskFileSuffix;
 
@@ -408,9 +456,8 @@ void ObjectOp::SaveUploadCheckpointFile(
   // 先序列化（不含md5Sum），计算其MD5作为校验
   std::ostringstream json_ss;
   Poco::JSON::Stringifier::stringify(json_root, json_ss);
-  Poco::MD5Engine md5_engine;
-  md5_engine.update(json_ss.str());
-  std::string md5sum = Poco::DigestEngine::digestToHex(md5_engine.digest());
+  const std::string json_str = json_ss.str();
+  std::string md5sum = HashUtil::Md5Hex(json_str.data(), json_str.size());
   json_root->set(kResumableUploadCheckpointMd5Sum, md5sum);
 
   std::string tmp_file = checkpoint_file + ".tmp";
@@ -523,9 +570,9 @@ bool ObjectOp::LoadAndValidateUploadCheckpoint(
 
   std::ostringstream verify_ss;
   Poco::JSON::Stringifier::stringify(verify_obj, verify_ss);
-  Poco::MD5Engine md5_engine;
-  md5_engine.update(verify_ss.str());
-  std::string computed_md5 = Poco::DigestEngine::digestToHex(md5_engine.digest());
+  const std::string verify_str = verify_ss.str();
+  std::string computed_md5 =
+      HashUtil::Md5Hex(verify_str.data(), verify_str.size());
 
   if (computed_md5 != stored_md5) {
     SDK_LOG_WARN("Checkpoint file MD5 mismatch, file may be corrupted: %s",
@@ -772,18 +819,24 @@ CosResult ObjectOp::PutObject(const PutObjectByStreamReq& req,
   std::istream& is = req.GetStream();
 
   // 如果传递的header中没有Content-MD5则进行SDK进行MD5校验
+  // 同时需要crc64校验时, md5与crc64一次遍历算出
   bool need_check_etag = false;
   std::string md5_str = "";
-  if (req.GetHeader("Content-MD5").empty() && req.ShouldComputeContentMd5()) {
-    need_check_etag = true;
-    Poco::MD5Engine md5;
-    Poco::DigestOutputStream dos(md5);
+  uint64_t crc64 = 0;
+  bool need_calc_md5 =
+      req.GetHeader("Content-MD5").empty() && req.ShouldComputeContentMd5();
+  if (need_calc_md5 || req.CheckCRC64()) {
     std::streampos pos = is.tellg();
-    Poco::StreamCopier::copyStream(is, dos);
+    if (req.CheckCRC64()) {
+      HashUtil::Md5Crc64(is, need_calc_md5 ? &md5_str : nullptr, &crc64);
+    } else {
+      md5_str = HashUtil::Md5Hex(is);
+    }
     is.clear();
     is.seekg(pos);
-    dos.close();
-    md5_str = Poco::DigestEngine::digestToHex(md5.digest());
+  }
+  if (need_calc_md5) {
+    need_check_etag = true;
     std::string bin_str = CodecUtil::HexToBin(md5_str);
     std::string encode_str = CodecUtil::Base64Encode(bin_str);
     additional_headers.insert(std::make_pair("Content-MD5", encode_str));
@@ -810,6 +863,19 @@ CosResult ObjectOp::PutObject(const PutObjectByStreamReq& req,
         md5_str.c_str(), resp->GetEtag().c_str(),
         resp->GetXCosRequestId().c_str());
   }
+  // check crc64 if needed
+  if (result.IsSucc() && req.CheckCRC64() &&
+      !resp->GetXCosHashCrc64Ecma().empty()) {
+    uint64_t crc64_server_resp =
+        StringUtil::StringToUint64(resp->GetXCosHashCrc64Ecma());
+    if (crc64_server_resp != crc64) {
+      std::string err_msg =
+          "PutObject failed, crc64 check failed, crc64_origin: " +
+          std::to_string(crc64) +
+          ", crc64_server_resp: " + std::to_string(crc64_server_resp);
+      SetResultAndLogError(result, err_msg);
+    }
+  }
   if(result.IsSucc() && handler) {
     handler->UpdateStatus(TransferStatus::COMPLETED, result, resp->GetHeaders(),
                           resp->GetBody());
@@ -846,18 +912,24 @@ CosResult ObjectOp::PutObject(const PutObjectByFileReq& req,
   }
 
   // 如果传递的header中没有Content-MD5则进行SDK进行MD5校验
+  // 同时需要crc64校验时, md5与crc64一次遍历算出
   bool need_check_etag = false;
   std::string md5_str = "";
-  if (req.GetHeader("Content-MD5").empty() && req.ShouldComputeContentMd5()) {
-    need_check_etag = true;
-    Poco::MD5Engine md5;
-    Poco::DigestOutputStream dos(md5);
+  uint64_t crc64 = 0;
+  bool need_calc_md5 =
+      req.GetHeader("Content-MD5").empty() && req.ShouldComputeContentMd5();
+  if (need_calc_md5 || req.CheckCRC64()) {
     std::streampos pos = ifs.tellg();
-    Poco::StreamCopier::copyStream(ifs, dos);
+    if (req.CheckCRC64()) {
+      HashUtil::Md5Crc64(ifs, need_calc_md5 ? &md5_str : nullptr, &crc64);
+    } else {
+      md5_str = HashUtil::Md5Hex(ifs);
+    }
     ifs.clear();
     ifs.seekg(pos);
-    dos.close();
-    md5_str = Poco::DigestEngine::digestToHex(md5.digest());
+  }
+  if (need_calc_md5) {
+    need_check_etag = true;
     std::string bin_str = CodecUtil::HexToBin(md5_str);
     std::string encode_str = CodecUtil::Base64Encode(bin_str);
     additional_headers.insert(std::make_pair("Content-MD5", encode_str));
@@ -875,6 +947,19 @@ CosResult ObjectOp::PutObject(const PutObjectByFileReq& req,
         md5_str.c_str(), resp->GetEtag().c_str(),
         resp->GetXCosRequestId().c_str());
   }
+  // check crc64 if needed
+  if (result.IsSucc() && req.CheckCRC64() &&
+      !resp->GetXCosHashCrc64Ecma().empty()) {
+    uint64_t crc64_server_resp =
+        StringUtil::StringToUint64(resp->GetXCosHashCrc64Ecma());
+    if (crc64_server_resp != crc64) {
+      std::string err_msg =
+          "PutObject failed, crc64 check failed, crc64_origin: " +
+          std::to_string(crc64) +
+          ", crc64_server_resp: " + std::to_string(crc64_server_resp);
+      SetResultAndLogError(result, err_msg);
+    }
+  }
 
   ifs.close();
 
@@ -1335,18 +1420,21 @@ CosResult ObjectOp::UploadPartData(const UploadPartDataReq& req,
   }
 
   // 如果传递的header中没有Content-MD5则SDK进行MD5校验
-  bool is_check_md5 = false;
+  // 同时需要crc64校验时, md5与crc64一次遍历算出
+  bool is_check_md5 = req.GetHeader("Content-MD5").empty();
   std::string md5_str = "";
-  if (req.GetHeader("Content-MD5").empty()) {
-    Poco::MD5Engine md5;
-    Poco::DigestOutputStream dos(md5);
+  uint64_t crc64 = 0;
+  if (is_check_md5 || req.CheckCRC64()) {
     std::streampos pos = is.tellg();
-    Poco::StreamCopier::copyStream(is, dos);
+    if (req.CheckCRC64()) {
+      HashUtil::Md5Crc64(is, is_check_md5 ? &md5_str : nullptr, &crc64);
+    } else {
+      md5_str = HashUtil::Md5Hex(is);
+    }
     is.clear();
     is.seekg(pos);
-    dos.close();
-    md5_str = Poco::DigestEngine::digestToHex(md5.digest());
-    is_check_md5 = true;
+  }
+  if (is_check_md5) {
     // 默认开启MD5校验
     if (req.ShouldComputeContentMd5()) {
       std::string bin_str = CodecUtil::HexToBin(md5_str);
@@ -1371,6 +1459,19 @@ CosResult ObjectOp::UploadPartData(const UploadPartDataReq& req,
         md5_str.c_str(), resp->GetEtag().c_str(),
         resp->GetXCosRequestId().c_str());
   }
+  // check crc64 if needed
+  if (result.IsSucc() && req.CheckCRC64() &&
+      !resp->GetXCosHashCrc64Ecma().empty()) {
+    uint64_t crc64_server_resp =
+        StringUtil::StringToUint64(resp->GetXCosHashCrc64Ecma());
+    if (crc64_server_resp != crc64) {
+      std::string err_msg =
+          "UploadPartData failed, crc64 check failed, crc64_origin: " +
+          std::to_string(crc64) +
+          ", crc64_server_resp: " + std::to_string(crc64_server_resp);
+      SetResultAndLogError(result, err_msg);
+    }
+  }
 
   return result;
 }
@@ -1661,7 +1762,7 @@ CosResult ObjectOp::Copy(const CopyReq& req, CopyResp* resp, bool change_backup_
       pool_size = max_task_num;
     }
 
-    Poco::ThreadPool tp(pool_size);
+    TransferWorkerPool::Group tp(GetGlobalTransferWorkerPool(), pool_size);
     std::string path = "/" + req.GetObjectName();
     std::string host = CosSysConfig::GetHost(GetAppId(), m_config->GetRegion(),
                                              req.GetBucketName(), change_backup_domain);
@@ -1691,7 +1792,7 @@ CosResult ObjectOp::Copy(const CopyReq& req, CopyResp* resp, bool change_backup_
                      req.GetVerifyCert(), req.GetCaLocation(),
                      req.GetSSLCtxCallback(), req.GetSSLCtxCbData(),
                      ptask, req.SignHeaderHost());
-        tp.start(*ptask);
+        tp.Start(*ptask);
         part_numbers.push_back(part_number);
         ++part_number;
         offset = end + 1;
@@ -1699,7 +1800,7 @@ CosResult ObjectOp::Copy(const CopyReq& req, CopyResp* resp, bool change_backup_
 
       unsigned task_num = task_index;
 
-      tp.joinAll();
+      tp.JoinAll();
 
       for (task_index = 0; task_index < task_num; ++task_index) {
         FileCopyTask* ptask = pptaskArr[task_index];
@@ -1840,6 +1941,13 @@ ObjectOp::MultiThreadDownload(const GetObjectByFileReq& req,
         head_req.SetCaLocation(req.GetCaLocation());
         head_req.SetSSLCtxCallback(req.GetSSLCtxCallback(), req.GetSSLCtxCbData());
   }
+  // 下载指定版本时, 长度及CRC64需取自同一版本
+  const std::map<std::string, std::string>& req_params = req.GetParams();
+  std::map<std::string, std::string>::const_iterator version_itr =
+      req_params.find("versionId");
+  if (version_itr != req_params.end()) {
+    head_req.AddParam("versionId", version_itr->second);
+  }
   HeadObjectResp head_resp;
   head_result = HeadObject(head_req, &head_resp, change_backup_domain);
   if (!head_result.IsSucc()) {
@@ -1914,6 +2022,16 @@ ObjectOp::MultiThreadDownload(const GetObjectByFileReq& req,
     handler->UpdateStatus(TransferStatus::IN_PROGRESS);
   }
 
+  if (CosSysConfig::GetDownFilePreallocate() &&
+      !FileUtil::PreallocateFile(fd, file_size)) {
+    SDK_LOG_WARN("preallocate file(%s) fail, size=%" PRIu64,
+                 local_path.c_str(), file_size);
+  }
+
+  // HeadObject返回了对象的CRC64时, 用各分片的CRC64合并出整个文件的CRC64做校验
+  const std::string crc64_server = head_resp.GetXCosHashCrc64Ecma();
+  bool check_crc64 = !crc64_server.empty();
+
   unsigned pool_size = CosSysConfig::GetDownThreadPoolSize();
   unsigned slice_size = CosSysConfig::GetDownSliceSize();
   unsigned max_task_num = file_size / slice_size + 1;
@@ -1921,20 +2039,41 @@ ObjectOp::MultiThreadDownload(const GetObjectByFileReq& req,
     pool_size = max_task_num;
   }
 
+  // 分片缓冲区从全局缓冲区池申请, 下载结束后归还复用
   unsigned char** file_content_buf = new unsigned char*[pool_size];
+  bool buf_alloc_fail = false;
   for (unsigned i = 0; i < pool_size; ++i) {
-    file_content_buf[i] = new unsigned char[slice_size];
+    file_content_buf[i] = GetGlobalBufferPool().Acquire(slice_size);
+    if (file_content_buf[i] == nullptr) {
+      buf_alloc_fail = true;
+    }
+  }
+  if (buf_alloc_fail) {
+    for (unsigned i = 0; i < pool_size; ++i) {
+      GetGlobalBufferPool().Release(file_content_buf[i]);
+    }
+    delete[] file_content_buf;
+    close(fd);
+    SetResultAndLogError(result, "allocate slice buffer fail, size=" +
+                                     StringUtil::Uint64ToString(slice_size));
+    if (handler) {
+      handler->UpdateStatus(TransferStatus::FAILED, result);
+    }
+    return result;
   }
 
-  // 创建共享信号量，初始计数为pool_size，任务完成时notify，主线程wait
-  Semaphore semaphore(pool_size);
+  // 任务完成时推入自己的槽位下标，主线程按完成顺序取出并立即复用该槽位
+  CompletionQueue done_queue;
 
   FileDownTask** pptaskArr = new FileDownTask*[pool_size];
   for (unsigned i = 0; i < pool_size; ++i) {
     pptaskArr[i] =
         new FileDownTask(host, path, req.IsHttps(), m_op_util, headers, params, req.GetConnTimeoutInms(),
                          req.GetRecvTimeoutInms(), handler);
-    pptaskArr[i]->SetSemaphore(&semaphore);
+    pptaskArr[i]->SetCompletionQueue(&done_queue, i);
+    // 任务线程下载完成后计算分片CRC64并直接写入文件的对应偏移处
+    pptaskArr[i]->SetWriteFd(fd);
+    pptaskArr[i]->SetCalcCrc64(check_crc64);
   }
 
   SDK_LOG_INFO("download data,host=%s, path=%s, poolsize=%u, slice_size=%u, file_size=%" PRIu64, host.c_str(),
@@ -1943,85 +2082,72 @@ ObjectOp::MultiThreadDownload(const GetObjectByFileReq& req,
   std::vector<uint64_t> vec_offset;
   vec_offset.resize(pool_size);
 
-  Poco::ThreadPool task_pool(pool_size, pool_size+1);
+  // 任务提交到全局传输线程池, 本次传输最多同时占用pool_size个线程
+  TransferWorkerPool::Group task_pool(GetGlobalTransferWorkerPool(), pool_size);
   uint64_t offset = 0;
   bool task_fail_flag = false;
   unsigned down_sequence = 0;
   bool is_header_set = false;
-  // TODO(jackyding) 暂时不校验md5或crc,分块上传的文件etag不是md5
-  // Poco::MD5Engine md5_engine;
-
-  // 处理所有已完成（TASK_COMPLETED）的任务槽，写入文件并重置为IDLE
-  auto process_completed_tasks = [&]() {
-    for (unsigned i = 0; i < pool_size && !task_fail_flag; ++i) {
-      FileDownTask* ptask = pptaskArr[i];
-      if (ptask->GetTaskStatus() != TASK_COMPLETED) {
-        continue;
-      }
+  // 滑动窗口中任务完成顺序不确定，分片CRC64按offset顺序合并
+  Crc64SliceCombiner crc64_combiner;
 
-      SDK_LOG_DBG("[sliding window] check %" PRIu64 "th task, index=%d, status=%d", ptask->GetSequence(), i, ptask->GetTaskStatus());
-      if (ptask->IsTaskSuccess()) {
-        // 写入数据到文件
-        if (!SeekFile(fd, vec_offset[i], result)) {
-          task_fail_flag = true;
-          break;
-        }
-
-        if (-1 == write(fd, file_content_buf[i], ptask->GetDownLoadLen())) {
-            std::string err_msg = "down data, write failed, ret=" + StringUtil::IntToString(errno) +
-                                  ", len=" + StringUtil::Uint64ToString(ptask->GetDownLoadLen());
-            SetResultAndLogError(result, err_msg);
-            task_fail_flag = true;
-            break;
-        }
+  // 空闲任务槽，只由主线程访问
+  std::vector<unsigned> idle_slots;
+  for (unsigned i = pool_size; i > 0; --i) {
+    idle_slots.push_back(i - 1);
+  }
+  unsigned active_tasks = 0;
 
-        if (!is_header_set) {
-          std::map<std::string, std::string> resp_headers = ptask->GetRespHeaders();
-          resp->ParseFromHeaders(resp_headers);
-          result.SetXCosRequestId(resp->GetXCosRequestId());
-          result.SetHttpStatus(ptask->GetHttpStatus());
-          is_header_set = true;
-        }
+  // 处理一个已完成（TASK_COMPLETED）的任务槽并重置为IDLE, 数据已由任务线程写入文件
+  auto process_completed_task = [&](unsigned i) {
+    FileDownTask* ptask = pptaskArr[i];
+    SDK_LOG_DBG("[sliding window] check %" PRIu64 "th task, index=%d, status=%d", ptask->GetSequence(), i, ptask->GetTaskStatus());
+    if (ptask->IsTaskSuccess()) {
+      if (!is_header_set) {
+        std::map<std::string, std::string> resp_headers = ptask->GetRespHeaders();
+        resp->ParseFromHeaders(resp_headers);
+        result.SetXCosRequestId(resp->GetXCosRequestId());
+        result.SetHttpStatus(ptask->GetHttpStatus());
+        is_header_set = true;
+      }
 
       SDK_LOG_DBG("[sliding window] %" PRIu64 "th task successed, index=%d, offset=%" PRIu64 ", downlen:%zu",
-                     ptask->GetSequence(), i, vec_offset[i], ptask->GetDownLoadLen());
+                  ptask->GetSequence(), i, vec_offset[i], ptask->GetDownLoadLen());
+      if (check_crc64) {
+        crc64_combiner.AddSlice(vec_offset[i], ptask->GetCrc64(),
+                                ptask->GetDownLoadLen());
+      }
 
-        // 重置任务槽为IDLE，供下一轮复用（线程已结束，此处操作线程安全）
-        ptask->ResetTaskStatus();
-      } else {
-        // 任务失败
-        const std::string& task_resp = ptask->GetTaskResp();
-        const std::map<std::string, std::string>& task_resp_headers = ptask->GetRespHeaders();
-        SDK_LOG_ERR("sliding window: task[%d] failed, rsp:%s, http_status:%d",
-                    i, task_resp.c_str(), ptask->GetHttpStatus());
-        result.SetHttpStatus(ptask->GetHttpStatus());
-        if (ptask->GetHttpStatus() < 0) {
-          result.SetErrorMsg(ptask->GetErrMsg());
-        } else if (!result.ParseFromHttpResponse(task_resp_headers, task_resp)) {
-          result.SetErrorMsg(task_resp);
-        }
-        task_fail_flag = true;
-        break;
+      // 重置任务槽为IDLE，供下一轮复用（任务已推入完成队列，不会再访问槽位）
+      ptask->ResetTaskStatus();
+      idle_slots.push_back(i);
+    } else {
+      // 任务失败
+      const std::string& task_resp = ptask->GetTaskResp();
+      const std::map<std::string, std::string>& task_resp_headers = ptask->GetRespHeaders();
+      SDK_LOG_ERR("sliding window: task[%d] failed, rsp:%s, http_status:%d",
+                  i, task_resp.c_str(), ptask->GetHttpStatus());
+      result.SetHttpStatus(ptask->GetHttpStatus());
+      if (ptask->GetHttpStatus() < 0) {
+        result.SetErrorMsg(ptask->GetErrMsg());
+      } else if (!result.ParseFromHttpResponse(task_resp_headers, task_resp)) {
+        result.SetErrorMsg(task_resp);
       }
+      task_fail_flag = true;
     }
   };
 
-  while (offset < file_size || semaphore.get_count() > 0) {
+  while (offset < file_size || active_tasks > 0) {
     if (handler && !handler->ShouldContinue()) {
       task_fail_flag = true;
       SetResultAndLogError(result, "Request canceled by user");
       break;
     }
 
-    // semaphore.get_count()对应正在执行的任务数量
-    // 如果任务执行完成但还没被主线程处理, count已经-1, 但状态还是TASK_COMPLETED, 这里不会被覆盖
-    for (int i = 0; i < pool_size && semaphore.get_count() < pool_size && offset < file_size; i ++) {
-      if (pptaskArr[i]->GetTaskStatus() != TASK_IDLE) {
-        // 跳过非空闲的任务槽
-        continue;
-      }
-
-      // 填充空闲任务槽，直到窗口满或文件读完
+    // 填充空闲任务槽，直到窗口满或文件读完
+    while (!idle_slots.empty() && offset < file_size) {
+      unsigned i = idle_slots.back();
+      idle_slots.pop_back();
       FileDownTask* ptask = pptaskArr[i];
       uint64_t left_size = file_size - offset;
       uint64_t part_len = slice_size < left_size ? slice_size : left_size;
@@ -2032,23 +2158,24 @@ ObjectOp::MultiThreadDownload(const GetObjectByFileReq& req,
       ptask->SetSslCtxCb(req.GetSSLCtxCallback(), req.GetSSLCtxCbData());
       ptask->SetSequence(++down_sequence);
 
-      vec_offset[i] = offset;  // 记录该槽对应的文件偏移，供写入时使用
-      // 申请信号量, 这里一定可以申请到
-      semaphore.acquire();
-      // 在 tp.start() 之前主动设为 RUNNING，防止 run() 尚未开始时槽位被误判为 IDLE 而重复使用
+      vec_offset[i] = offset;  // 记录该槽对应的文件偏移
       ptask->SetTaskRunning();
-      SDK_LOG_DBG("[sliding window] new task started, index=%d, sequence=%" PRIu64 ", offset=%" PRIu64 ", active_tasks=%u",
-                   i, down_sequence, offset, semaphore.get_count());
-      task_pool.start(*ptask);
+      ++active_tasks;
+      SDK_LOG_DBG("[sliding window] new task started, index=%d, sequence=%u, offset=%" PRIu64 ", active_tasks=%u",
+                   i, down_sequence, offset, active_tasks);
+      task_pool.Start(*ptask);
 
       offset += part_len;
     }
 
-    // 阻塞等待任意一个任务完成（由FileDownTask中的semaphore->release()触发）
-    semaphore.wait();
-
-    // 扫描所有已完成（TASK_COMPLETED）的任务槽，处理结果并重置为IDLE
-    process_completed_tasks();
+    // 阻塞等待任意一个任务完成，然后处理其间已完成的其他任务
+    process_completed_task(done_queue.pop());
+    --active_tasks;
+    unsigned done_slot = 0;
+    while (!task_fail_flag && done_queue.try_pop(&done_slot)) {
+      --active_tasks;
+      process_completed_task(done_slot);
+    }
 
     if (task_fail_flag) {
       break;
@@ -2056,17 +2183,24 @@ ObjectOp::MultiThreadDownload(const GetObjectByFileReq& req,
   }
 
   // 等待所有剩余任务完成
-  task_pool.joinAll();
+  task_pool.JoinAll();
 
-  // joinAll()后扫描遗漏任务：while循环退出时可能有已完成但未处理的任务槽
-  process_completed_tasks();
-
-  // 检查object etag与resp body的md5
-  // std::string md5 = Poco::DigestEngine::digestToHex(md5_engine.digest());
-  // if (req.CheckMD5() && md5 != objecdt_etag) {
-  //    SDK_LOG_ERR("md5 of response body:%s is not equal to object etag:%s",
-  //    md5.c_str(), objecdt_etag.c_str()); task_fail_flag = true;
-  // }
+  // 分块上传的对象ETag不是MD5, 用CRC64校验整个文件
+  if (!task_fail_flag && check_crc64) {
+    uint64_t crc64_origin = StringUtil::StringToUint64(crc64_server);
+    if (crc64_combiner.GetOffset() != file_size ||
+        crc64_combiner.GetCrc64() != crc64_origin) {
+      std::string err_msg =
+          "MultiThreadDownload failed, crc64 check failed, crc64_local: " +
+          std::to_string(crc64_combiner.GetCrc64()) +
+          ", crc64_server_resp: " + std::to_string(crc64_origin) +
+          ", combined_len: " + std::to_string(crc64_combiner.GetOffset());
+      SetResultAndLogError(result, err_msg);
+      task_fail_flag = true;
+    } else {
+      SDK_LOG_INFO("crc64 check passed, crc64: %" PRIu64, crc64_origin);
+    }
+  }
 
   if (!task_fail_flag) {
     SDK_LOG_INFO("down data succeed");
@@ -2089,7 +2223,7 @@ ObjectOp::MultiThreadDownload(const GetObjectByFileReq& req,
   // fsync(fd);
   close(fd);
   for (unsigned i = 0; i < pool_size; i++) {
-    delete[] file_content_buf[i];
+    GetGlobalBufferPool().Release(file_content_buf[i]);
     delete pptaskArr[i];
   }
   delete[] pptaskArr;
@@ -2113,24 +2247,6 @@ CosResult ObjectOp::MultiThreadUpload(
 
   // 1. 获取文件大小
   std::string local_file_path = req.GetLocalFilePath();
-  std::ifstream fin;
-#if defined(_WIN32)
-  if (req.IsWideCharPath()) {
-    fin.open(req.GetWideCharLocalFilePath(), std::ios::in | std::ios::binary);
-  } else {
-    fin.open(req.GetLocalFilePath(), std::ios::in | std::ios::binary);
-  }
-#else
-  fin.open(req.GetLocalFilePath(), std::ios::in | std::ios::binary);
-#endif
-  if (!fin) {
-    std::string err_msg = "Failed to open file " + req.GetLocalFilePath();
-    SetResultAndLogError(result, err_msg);
-    if (handler) {
-      handler->UpdateStatus(TransferStatus::FAILED, result);
-    }
-    return result;
-  }
 #if defined(_WIN32)
   uint64_t file_size =
       req.IsWideCharPath()
@@ -2167,13 +2283,42 @@ CosResult ObjectOp::MultiThreadUpload(
     return result;
   }
 
+  // 预读线程按顺序将分块读入缓冲区环, 与上传并行进行
+  // 缓冲区数量为 pool_size + 预读深度, 任务槽持有的缓冲区在任务处理完成后归还
+  FilePartReader part_reader(file_size, part_size, pool_size,
+                             CosSysConfig::GetUploadReadAheadDepth(),
+                             CosSysConfig::GetUploadReaderThreadNum());
+  bool reader_started = false;
+#if defined(_WIN32)
+  if (req.IsWideCharPath()) {
+    reader_started = part_reader.Start(req.GetWideCharLocalFilePath());
+  } else {
+    reader_started = part_reader.Start(req.GetLocalFilePath());
+  }
+#else
+  reader_started = part_reader.Start(req.GetLocalFilePath());
+#endif
+  if (!reader_started) {
+    std::string err_msg = part_reader.GetErrMsg();
+    if (err_msg.empty()) {
+      err_msg = "Failed to open file " + req.GetLocalFilePath();
+    }
+    SetResultAndLogError(result, err_msg);
+    if (handler) {
+      handler->UpdateStatus(TransferStatus::FAILED, result);
+    }
+    return result;
+  }
+
+  // 每个任务槽当前持有的分块缓冲区
   PartBufInfo *part_buf_info = new PartBufInfo[pool_size];
   for (int i = 0; i < pool_size; ++i) {
-    part_buf_info[i].buf = new unsigned char[(size_t)part_size];
+    part_buf_info[i].buf = nullptr;
+    part_buf_info[i].len = 0;
   }
 
-  // 创建共享信号量，初始计数为pool_size，任务完成时notify，主线程wait
-  Semaphore semaphore(pool_size);
+  // 任务完成时推入自己的槽位下标，主线程按完成顺序取出并立即复用该槽位
+  CompletionQueue done_queue;
   std::string dest_url = GetRealUrl(host, path, req.IsHttps());
   FileUploadTask** pptaskArr = new FileUploadTask*[pool_size];
   for (int i = 0; i < pool_size; ++i) {
@@ -2182,16 +2327,15 @@ CosResult ObjectOp::MultiThreadUpload(
                            req.GetRecvTimeoutInms(), handler,
                            req.GetVerifyCert(), req.GetCaLocation(),
                            req.GetSSLCtxCallback(), req.GetSSLCtxCbData());
-    pptaskArr[i]->SetSemaphore(&semaphore);
+    pptaskArr[i]->SetCompletionQueue(&done_queue, i);
   }
 
   SDK_LOG_DBG("upload data, host=%s, path=%s, poolsize=%u, part_size=%" PRIu64
               ", file_size=%" PRIu64,
               host.c_str(), path.c_str(), pool_size, part_size, file_size);
 
-  // maxCapacity 设为 pool_size + 1：release() 之后 run() 返回之前存在短暂时间窗口，
-  // 此时线程尚未回到池中，主线程可能再次调用 tp.start()，需要额外一个线程容量
-  Poco::ThreadPool tp(pool_size, pool_size + 1);
+  // 任务提交到全局传输线程池, 本次传输最多同时占用pool_size个线程
+  TransferWorkerPool::Group tp(GetGlobalTransferWorkerPool(), pool_size);
 
   // 记录每个任务槽对应的part_number，用于CRC64按序合并
   std::vector<uint64_t> vec_part_number(pool_size, 0);
@@ -2205,58 +2349,61 @@ CosResult ObjectOp::MultiThreadUpload(
   // 收集各分块的etag，key为part_number，保证最终按part_number顺序填充
   std::map<uint64_t, std::string> part_etag_map;
 
-  // 处理已完成（TASK_COMPLETED）任务槽的公共逻辑：收集etag/crc64，重置槽位为IDLE
-  auto process_completed_tasks = [&]() {
-    for (int i = 0; i < pool_size && !task_fail_flag; ++i) {
-      FileUploadTask* ptask = pptaskArr[i];
-      if (ptask->GetTaskStatus() != TASK_COMPLETED) {
-        continue;
+  // 空闲任务槽，只由主线程访问
+  std::vector<int> idle_slots;
+  for (int i = pool_size - 1; i >= 0; --i) {
+    idle_slots.push_back(i);
+  }
+  unsigned active_tasks = 0;
+
+  // 处理一个已完成（TASK_COMPLETED）的任务槽：收集etag/crc64，重置槽位为IDLE
+  auto process_completed_task = [&](int i) {
+    FileUploadTask* ptask = pptaskArr[i];
+
+    SDK_LOG_INFO("upload task completed, index=%d, part_number=%" PRIu64 ", status=%d", i, vec_part_number[i], ptask->GetTaskStatus());
+    if (!ptask->IsTaskSuccess()) {
+      const std::string& task_resp = ptask->GetTaskResp();
+      const std::map<std::string, std::string>& task_resp_headers = ptask->GetRespHeaders();
+      SDK_LOG_ERR("upload data, upload task fail, index=%d, part_number=%" PRIu64 ", rsp:%s",
+                  i, vec_part_number[i], task_resp.c_str());
+      result.SetHttpStatus(ptask->GetHttpStatus());
+      if (ptask->GetHttpStatus() < 0) {
+        result.SetErrorMsg(ptask->GetErrMsg());
+      } else if (!result.ParseFromHttpResponse(task_resp_headers, task_resp)) {
+        result.SetErrorMsg(task_resp);
       }
+      task_fail_flag = true;
+      return;
+    }
 
-      SDK_LOG_INFO("upload task completed, index=%d, part_number=%" PRIu64 ", status=%d", i, vec_part_number[i], ptask->GetTaskStatus());
-      if (!ptask->IsTaskSuccess()) {
-        const std::string& task_resp = ptask->GetTaskResp();
-        const std::map<std::string, std::string>& task_resp_headers = ptask->GetRespHeaders();
-        SDK_LOG_ERR("upload data, upload task fail, index=%d, part_number=%" PRIu64 ", rsp:%s",
-                    i, vec_part_number[i], task_resp.c_str());
-        result.SetHttpStatus(ptask->GetHttpStatus());
-        if (ptask->GetHttpStatus() < 0) {
-          result.SetErrorMsg(ptask->GetErrMsg());
-        } else if (!result.ParseFromHttpResponse(task_resp_headers, task_resp)) {
-          result.SetErrorMsg(task_resp);
-        }
-        task_fail_flag = true;
-        return;
-      }
+    // 找不到etag也算失败
+    const std::map<std::string, std::string>& resp_header = ptask->GetRespHeaders();
+    std::map<std::string, std::string>::const_iterator itr = resp_header.find("ETag");
+    if (itr != resp_header.end()) {
+      part_etag_map[vec_part_number[i]] = itr->second;
+    } else {
+      std::string err_msg = "upload failed response header missing etag";
+      SetResultAndLogError(result, err_msg);
+      result.SetHttpStatus(ptask->GetHttpStatus());
+      task_fail_flag = true;
+      return;
+    }
 
-      // 找不到etag也算失败
-      const std::map<std::string, std::string>& resp_header = ptask->GetRespHeaders();
-      std::map<std::string, std::string>::const_iterator itr = resp_header.find("ETag");
-      if (itr != resp_header.end()) {
-        part_etag_map[vec_part_number[i]] = itr->second;
-      } else {
-        std::string err_msg = "upload failed response header missing etag";
-        SetResultAndLogError(result, err_msg);
-        result.SetHttpStatus(ptask->GetHttpStatus());
-        task_fail_flag = true;
-        return;
-      }
+    // 立即保存该part独立的crc64，不能延迟到最后（buf槽位会被后续part复用覆盖）
+    // task在上传前已计算crc64(CheckPartCrc64()为false时与md5一次遍历算出)，无需再读buf
+    if (req.CheckCRC64()) {
+      uint64_t part_crc64 = ptask->GetCrc64Value();
+      part_crc64_map[vec_part_number[i]] = part_crc64;
+      SDK_LOG_DBG("Part[%d] Crc64: %" PRIu64, vec_part_number[i], part_crc64);
+    }
 
-      // 立即计算并保存该part独立的crc64，不能延迟到最后（buf槽位会被后续part复用覆盖）
-      if (req.CheckCRC64()) {
-        uint64_t part_crc64 = ptask->GetCrc64Value();
-        if (part_crc64 == 0) {
-          // CheckPartCrc64()为false时task未计算crc64，从buf重新计算
-          part_crc64 = CRC64::CalcCRC(0, static_cast<void*>(part_buf_info[i].buf),
-                                        part_buf_info[i].len);
-        }
-        part_crc64_map[vec_part_number[i]] = part_crc64;
-        SDK_LOG_DBG("Part[%d] Crc64: %" PRIu64, vec_part_number[i], part_crc64);
-      }
+    // 归还缓冲区给预读线程
+    part_reader.Release(part_buf_info[i].buf);
+    part_buf_info[i].buf = nullptr;
 
-      // 重置任务槽为IDLE，供下一轮复用
-      ptask->ResetTaskStatus();
-    }
+    // 重置任务槽为IDLE，供下一轮复用
+    ptask->ResetTaskStatus();
+    idle_slots.push_back(i);
   };
 
   // 3. 滑动窗口多线程upload
@@ -2264,50 +2411,41 @@ CosResult ObjectOp::MultiThreadUpload(
     crc64_file = 0;
     uint64_t cur_part_number = 1;  // 当前待分配的part编号
 
-    while (offset < file_size || semaphore.get_count() > 0) {
+    while (offset < file_size || active_tasks > 0) {
       if (handler && !handler->ShouldContinue()) {
         task_fail_flag = true;
         result.SetErrorMsg("Request canceled by user");
         break;
       }
 
-      // started_real_task 标记本轮内层 for 是否启动了至少一个真实上传任务（非 resume 分片）。
-      // resume 分片不调用 semaphore.acquire()、不启动线程，如果本轮全部是 resume 分片，之后执行 semaphore.wait() 将因无 worker 调用 release() 而死锁。
-      // 该标记用于后续跳过 wait()，避免此死锁。
-      bool started_real_task = false;
       // 填充空闲任务槽，直到窗口满或文件读完
-      for (int i = 0; i < pool_size && semaphore.get_count() < pool_size && offset < file_size; ++i) {
-        if (pptaskArr[i]->GetTaskStatus() != TASK_IDLE) {
-          continue;
-        }
-
+      // resume 分片不启动线程，处理完后槽位直接放回空闲列表
+      while (!idle_slots.empty() && offset < file_size) {
+        int i = idle_slots.back();
+        idle_slots.pop_back();
         FileUploadTask* ptask = pptaskArr[i];
 
-        fin.read((char *)(part_buf_info[i].buf), part_size);
-        std::streamsize read_len = fin.gcount();
-        if (read_len == 0) {
-          if (fin.eof()) {
+        // 获取预读完成的下一个分块, 读取未完成时阻塞等待
+        ReadAheadPart read_part;
+        if (!part_reader.Next(&read_part)) {
+          std::string read_err = part_reader.GetErrMsg();
+          if (!read_err.empty()) {
+            // 读取出错或源文件被截断, 应明确报错避免上传残缺对象
+            SetResultAndLogError(result, "read part fail, file_size=" +
+                                             std::to_string(file_size) +
+                                             ", offset=" + std::to_string(offset) +
+                                             ", " + read_err);
+            task_fail_flag = true;
+          } else {
             SDK_LOG_DBG("read over, task_index: %d", i);
-            // 文件已读完。如果 offset < file_size 说明源文件被截断或 file_size 报告不准，
-            // 应明确报错避免上传残缺对象；将 offset 设为 file_size 让循环正常退出。
-            if (offset < file_size) {
-              SDK_LOG_ERR("Source file size mismatch: expected=%" PRIu64
-                          ", actual_read=%" PRIu64
-                          ". File may be truncated or modified during upload.",
-                          file_size, offset);
-              task_fail_flag = true;
-            }
             offset = file_size;
-            break;
-          } else {
-            // 流读取错误（非 EOF），设置失败标记并退出
-            SDK_LOG_ERR("read error, task_index: %d, file_size=%" PRIu64
-                        ", offset=%" PRIu64, i, file_size, offset);
-            task_fail_flag = true;
-            break;
           }
+          idle_slots.push_back(i);
+          break;
         }
-        part_buf_info[i].len = static_cast<size_t>(read_len);
+        std::streamsize read_len = static_cast<std::streamsize>(read_part.len);
+        part_buf_info[i].buf = read_part.buf;
+        part_buf_info[i].len = read_part.len;
 
         SDK_LOG_DBG("upload data, task_index=%d, file_size=%" PRIu64
                     ", offset=%" PRIu64 ", len=%" PRIu64,
@@ -2336,24 +2474,25 @@ CosResult ObjectOp::MultiThreadUpload(
             part_crc64_map[cur_part_number] = part_crc64;
             SDK_LOG_DBG("Resume Part[%" PRIu64 "] Crc64: %" PRIu64, cur_part_number, part_crc64);
           }
+          part_reader.Release(part_buf_info[i].buf);
+          part_buf_info[i].buf = nullptr;
+          idle_slots.push_back(i);
           offset += read_len;
           ++cur_part_number;
           continue;
         }
 
         FillUploadTask(upload_id, host, path, part_buf_info[i].buf,
-                       read_len, cur_part_number, ptask, req.SignHeaderHost(), req.CheckPartCrc64());
+                       read_len, cur_part_number, ptask, req.SignHeaderHost(),
+                       req.CheckPartCrc64(), req.CheckCRC64());
 
-        // 申请信号量，这里一定可以申请到
-        semaphore.acquire();
-        // 在 tp.start() 之前主动设为 RUNNING，防止 run() 尚未开始时槽位被误判为 IDLE 而重复使用
         ptask->SetTaskRunning();
+        ++active_tasks;
         SDK_LOG_INFO("[sliding window] new upload task started, index=%d, part_number=%" PRIu64
                     ", offset=%" PRIu64 ", active_tasks=%u",
-                    i, cur_part_number, offset, semaphore.get_count());
-        tp.start(*ptask);
+                    i, cur_part_number, offset, active_tasks);
+        tp.Start(*ptask);
 
-        started_real_task = true;
         offset += read_len;
         ++cur_part_number;
       }
@@ -2363,18 +2502,19 @@ CosResult ObjectOp::MultiThreadUpload(
         break;
       }
 
-      // 本轮是否启动了真实的上传任务？没有则不需要等待 worker 线程
-      if (started_real_task) {
-        // 阻塞等待任意一个任务完成（由FileUploadTask中的semaphore->release()触发）
-        semaphore.wait();
-      } else if (offset >= file_size) {
-        // 全部是 resume 分片且文件已读完，直接退出循环
+      // 全部是 resume 分片且文件已读完，没有需要等待的任务
+      if (active_tasks == 0) {
         break;
       }
-      // else: 全部是 resume 分片但文件未读完，继续下一轮循环
 
-      // 扫描所有已完成（TASK_COMPLETED）的任务槽，处理结果并重置为IDLE
-      process_completed_tasks();
+      // 阻塞等待任意一个任务完成，然后处理其间已完成的其他任务
+      process_completed_task(static_cast<int>(done_queue.pop()));
+      --active_tasks;
+      unsigned done_slot = 0;
+      while (!task_fail_flag && done_queue.try_pop(&done_slot)) {
+        --active_tasks;
+        process_completed_task(static_cast<int>(done_slot));
+      }
 
       if (task_fail_flag) {
         break;
@@ -2382,9 +2522,7 @@ CosResult ObjectOp::MultiThreadUpload(
     }
 
     // 等待所有剩余任务完成
-    tp.joinAll();
-    // joinAll() 后扫描所有槽位，处理 while 循环退出时遗漏的 TASK_COMPLETED 任务
-    process_completed_tasks();
+    tp.JoinAll();
   }
 
   // 按part_number顺序填充etags和part_numbers（保证与CompleteMultiUpload的顺序一致）
@@ -2420,16 +2558,12 @@ CosResult ObjectOp::MultiThreadUpload(
     }
   }
 
-  // 释放相关资源
-  fin.close();
+  // 释放相关资源, 分块缓冲区由part_reader统一释放
+  part_reader.Stop();
   for (int i = 0; i < pool_size; ++i) {
     delete pptaskArr[i];
   }
   delete[] pptaskArr;
-
-  for (int i = 0; i < pool_size; ++i) {
-    delete[] part_buf_info[i].buf;
-  }
   delete[] part_buf_info;
 
   return result;
@@ -2497,7 +2631,17 @@ CosResult ObjectOp::SingleThreadUpload(
     return result;
   }
 
-  unsigned char* file_content_buf = new unsigned char[(size_t)part_size];
+  unsigned char* file_content_buf =
+      GetGlobalBufferPool().Acquire(static_cast<size_t>(part_size));
+  if (file_content_buf == nullptr) {
+    fin.close();
+    SetResultAndLogError(result, "allocate part buffer fail, size=" +
+                                     StringUtil::Uint64ToString(part_size));
+    if (handler) {
+      handler->UpdateStatus(TransferStatus::FAILED, result);
+    }
+    return result;
+  }
   SDK_LOG_DBG("upload data, part_size=%" PRIu64
               ", file_size=%" PRIu64, part_size, file_size);
 
@@ -2517,14 +2661,28 @@ CosResult ObjectOp::SingleThreadUpload(
                     part_number, file_size, offset, read_len);
 
         // 提前计算整个文件的crc64，用于整个合并分块完成后做crc64校验
-        if (req.CheckCRC64()) {
-          crc64 = CRC64::CalcCRC(crc64, static_cast<void*>(file_content_buf),
-                              static_cast<size_t>(read_len));
+        // 需要上传的分块在同一次遍历中算出md5，UploadPartData无需再读一遍数据
+        bool is_resumed_part =
+            resume_flag && !already_exist_parts[part_number].empty();
+        std::string part_md5;
+        if (is_resumed_part) {
+          if (req.CheckCRC64()) {
+            crc64 = CRC64::CalcCRC(crc64, static_cast<void*>(file_content_buf),
+                                static_cast<size_t>(read_len));
+          }
+        } else if (req.CheckCRC64()) {
+          Md5Crc64Engine engine(crc64);
+          engine.Update(file_content_buf, static_cast<size_t>(read_len));
+          part_md5 = engine.Md5Hex();
+          crc64 = engine.GetCrc64();
+        } else {
+          part_md5 = HashUtil::Md5Hex(file_content_buf,
+                                      static_cast<size_t>(read_len));
         }
 
         // Check the resume
 
-        if (resume_flag && !already_exist_parts[part_number].empty()) {
+        if (is_resumed_part) {
           // Already has this part
           SDK_LOG_INFO("part etag: %s",
                        already_exist_parts[part_number].c_str());
@@ -2546,13 +2704,10 @@ CosResult ObjectOp::SingleThreadUpload(
             upload_part_req.SetTrafficLimit(req.GetHeader("x-cos-traffic-limit"));
           }
 
-        #ifdef USE_OPENSSL_MD5
-          // 提前计算Content-MD5
-          unsigned char digest[MD5_DIGEST_LENGTH];
-          MD5((const unsigned char *)file_content_buf, read_len, digest);
-          std::string digest_str((const char*)digest, MD5_DIGEST_LENGTH);
-          upload_part_req.AddHeader("Content-MD5", CodecUtil::Base64Encode(digest_str));
-        #endif
+          // 使用已算出的md5设置Content-MD5，ETag由下面自行校验
+          upload_part_req.AddHeader(
+              "Content-MD5",
+              CodecUtil::Base64Encode(CodecUtil::HexToBin(part_md5)));
 
           qcloud_cos::UploadPartDataResp upload_part_resp;
           qcloud_cos::CosResult upload_part_result = UploadPartData(upload_part_req, &upload_part_resp);
@@ -2560,7 +2715,18 @@ CosResult ObjectOp::SingleThreadUpload(
           if (upload_part_result.IsSucc()) {
             //未包含 etag 也算失败
             std::string upload_par_etag = upload_part_resp.GetEtag();
-            if (upload_par_etag != "") {
+            if (upload_par_etag != "" && !StringUtil::IsV4ETag(upload_par_etag) &&
+                upload_par_etag != part_md5) {
+              SDK_LOG_ERR("Response etag is not correct, Expect md5 is: %s, "
+                          "but return etag is: %s. RequestId: %s",
+                          part_md5.c_str(), upload_par_etag.c_str(),
+                          upload_part_resp.GetXCosRequestId().c_str());
+              SetResultAndLogError(
+                  result, "Response etag is not correct, Please try again.");
+              result.SetHttpStatus(upload_part_result.GetHttpStatus());
+              task_fail_flag = true;
+              break;
+            } else if (upload_par_etag != "") {
               etags_ptr->push_back(upload_par_etag);
             } else {
               std::string err_msg = "upload failed response header missing etag";
@@ -2595,7 +2761,7 @@ CosResult ObjectOp::SingleThreadUpload(
 
   // 释放相关资源
   fin.close();
-  delete[] file_content_buf;
+  GetGlobalBufferPool().Release(file_content_buf);
   return result;
 }
 
@@ -2615,7 +2781,8 @@ void ObjectOp::FillUploadTask(const std::string& upload_id,
                               const std::string& host, const std::string& path,
                               unsigned char* file_content_buf, uint64_t len,
                               uint64_t part_number, FileUploadTask* task_ptr,
-                              bool sign_header_host, bool check_crc64) {
+                              bool sign_header_host, bool check_crc64,
+                              bool calc_crc64) {
   std::map<std::string, std::string> req_params;
   req_params.insert(std::make_pair("uploadId", upload_id));
   req_params.insert(
@@ -2647,6 +2814,7 @@ void ObjectOp::FillUploadTask(const std::string& upload_id,
   task_ptr->SetUploadBuf(file_content_buf, len);
   task_ptr->SetPartNumber(part_number);
   task_ptr->SetCheckCrc64(check_crc64);
+  task_ptr->SetCalcCrc64(calc_crc64);
 }
 
 void ObjectOp::FillCopyTask(const std::string& upload_id,
@@ -2793,6 +2961,47 @@ CosResult ObjectOp::SelectObjectContent(const SelectObjectContentReq& req,
                       req_body, false, resp);
 }
 
+CosResult ObjectOp::SelectObjectContent(const SelectObjectContentReq& req,
+                                        SelectEventHandler* handler,
+                                        SelectObjectContentResp* resp,
+                                        bool change_backup_domain) {
+  std::string host = CosSysConfig::GetHost(GetAppId(), m_config->GetRegion(),
+                                           req.GetBucketName(), change_backup_domain);
+  std::string path = req.GetPath();
+  CosResult result;
+
+  std::string req_body;
+  if (!req.GenerateRequestBody(&req_body)) {
+    result.SetErrorMsg("Generate SelectObjectContent Request Body fail.");
+    return result;
+  }
+  std::string raw_md5 = CodecUtil::Base64Encode(CodecUtil::RawMd5(req_body));
+
+  std::map<std::string, std::string> additional_headers;
+  std::map<std::string, std::string> additional_params;
+  additional_headers.insert(std::make_pair("Content-MD5", raw_md5));
+
+  SelectEventDecoder decoder(handler);
+  SelectEventStreamBuf stream_buf(&decoder);
+  std::ostream os(&stream_buf);
+  result = StreamAction(host, path, req, additional_headers, additional_params,
+                        req_body, resp, os);
+  // 回调要求停止或解码失败时写入中断, StreamAction只能返回通用的读写错误,
+  // 优先返回解码器的状态
+  if (decoder.IsStopped()) {
+    result.SetFail();
+    result.SetErrorMsg("Select stopped by records handler.");
+  } else if (decoder.IsFailed()) {
+    result.SetFail();
+    result.SetErrorCode(decoder.GetServerErrorCode());
+    result.SetErrorMsg("Select response error, " + decoder.GetErrorMsg());
+  } else if (result.IsSucc() && !decoder.IsEnd()) {
+    result.SetFail();
+    result.SetErrorMsg("Select response incomplete, no End event received.");
+  }
+  return result;
+}
+
 CosResult ObjectOp::AppendObject(const AppendObjectReq& req,
                                  AppendObjectResp* resp) {
   return PutObject(static_cast<PutObjectByStreamReq>(req),
@@ -2950,25 +3159,43 @@ CosResult ObjectOp::ResumableGetObject(const GetObjectByFileReq& req,
   };
 
   // 2. 检查任务文件是否可以走断点下载
-  uint64_t resume_offset = 0;
+  uint64_t file_size = head_resp.GetContentLength();
+  ResumableDownloadSlices slices;
+  bool is_resume = false;
   if (CheckResumableDownloadTask(resumable_task_json_file,
-                                 resume_task_check_element, &resume_offset)) {
-    SDK_LOG_INFO("resumable task file check passed, resume_offset: %" PRIu64,
-                 resume_offset);
+                                 resume_task_check_element, &slices)) {
+    // 已完成分片的数据都应在本地文件中, 本地文件被截断或删除时不能续传
+    uint64_t done_end = 0;
+    for (size_t idx = 0; idx < slices.done.size(); ++idx) {
+      if (slices.done[idx]) {
+        done_end = std::min<uint64_t>(file_size, (idx + 1) * slices.slice_size);
+      }
+    }
     std::ifstream in(req.GetLocalFilePath(),
                      std::ifstream::ate | std::ifstream::binary);
-    uint64_t local_filesize = in.tellg();
-    if (resume_offset != local_filesize) {
-      SDK_LOG_ERR("resume_offset: %" PRIu64 " != local_filesize: %" PRIu64
+    uint64_t local_filesize =
+        in.is_open() ? static_cast<uint64_t>(in.tellg()) : 0;
+    if (!in.is_open() || local_filesize < done_end) {
+      SDK_LOG_ERR("local_filesize: %" PRIu64 " < done_end: %" PRIu64
                   ", don't use resume download",
-                  resume_offset, local_filesize);
-      resume_offset = 0;
+                  local_filesize, done_end);
+    } else {
+      SDK_LOG_INFO("resumable task file check passed, slice_size: %" PRIu64
+                   ", done_end: %" PRIu64, slices.slice_size, done_end);
+      is_resume = true;
     }
     in.close();
   } else {
     // 任务文件无效，删除任务文件
     ::remove(resumable_task_json_file.c_str());
   }
+  if (!is_resume) {
+    slices.slice_size = CosSysConfig::GetDownSliceSize();
+    uint64_t slice_num =
+        (file_size + slices.slice_size - 1) / slices.slice_size;
+    slices.done.assign(slice_num, false);
+    slices.crc64.assign(slice_num, 0);
+  }
 
   // 2. 填充header
   std::map<std::string, std::string> headers = req.GetHeaders();
@@ -3007,20 +3234,16 @@ CosResult ObjectOp::ResumableGetObject(const GetObjectByFileReq& req,
   // 3. 打开本地文件
   std::string local_path = req.GetLocalFilePath();
   int fd = -1;
-  uint64_t crc64_local = 0;
-  if (resume_offset > 0) {
+  if (is_resume) {
     // 可以走断点下载
-    // 计算本地文件初始CRC64
-    crc64_local = FileUtil::GetFileCrc64(local_path);
-    SDK_LOG_INFO("crc64_local: %" PRIu64, crc64_local);
-    // 以append打开文件,断点下载不应该使用O_TRUNC
+    // 断点下载不应该使用O_TRUNC, 也不能使用O_APPEND, 只下载未完成的分片并按偏移写入
 #if defined(_WIN32)
     // The _O_BINARY is need by windows otherwise the x0A might change into x0D
     // x0A
-    fd = open(local_path.c_str(), _O_BINARY | O_WRONLY | O_CREAT | O_APPEND,
+    fd = open(local_path.c_str(), _O_BINARY | O_WRONLY | O_CREAT,
               _S_IREAD | _S_IWRITE);
 #else
-    fd = open(local_path.c_str(), O_WRONLY | O_CREAT | O_APPEND,
+    fd = open(local_path.c_str(), O_WRONLY | O_CREAT,
               S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH);
 #endif
   } else {
@@ -3047,72 +3270,115 @@ CosResult ObjectOp::ResumableGetObject(const GetObjectByFileReq& req,
 
   // 4. 多线程下载
   std::string object_etag = head_resp.GetEtag();
-  uint64_t file_size = head_resp.GetContentLength();
   if (handler) {
     handler->SetTotalSize(file_size);
     handler->UpdateStatus(TransferStatus::IN_PROGRESS);
   }
 
+  // 已完成分片的CRC64直接取自任务文件, 与本次下载的分片CRC64按offset顺序合并,
+  // 无需重新读取本地文件
+  unsigned slice_size = static_cast<unsigned>(slices.slice_size);
+  Crc64SliceCombiner crc64_combiner;
+  std::vector<uint64_t> pending_slices;  // 需要下载的分片序号
+  uint64_t resumed_size = 0;
+  for (uint64_t idx = 0; idx < slices.done.size(); ++idx) {
+    uint64_t slice_offset = idx * slice_size;
+    uint64_t slice_len = std::min<uint64_t>(slice_size, file_size - slice_offset);
+    if (slices.done[idx]) {
+      crc64_combiner.AddSlice(slice_offset, slices.crc64[idx], slice_len);
+      resumed_size += slice_len;
+    } else {
+      pending_slices.push_back(idx);
+    }
+  }
+  if (handler && resumed_size > 0) {
+    handler->UpdateProgress(resumed_size);
+  }
+
+  if (CosSysConfig::GetDownFilePreallocate() &&
+      !FileUtil::PreallocateFile(fd, file_size)) {
+    SDK_LOG_WARN("preallocate file(%s) fail, size=%" PRIu64,
+                 local_path.c_str(), file_size);
+  }
+
   unsigned pool_size = CosSysConfig::GetDownThreadPoolSize();
-  unsigned slice_size = CosSysConfig::GetDownSliceSize();
-  unsigned max_task_num = (file_size - resume_offset) / slice_size + 1;
+  unsigned max_task_num = static_cast<unsigned>(pending_slices.size()) + 1;
   if (max_task_num < pool_size) {
     pool_size = max_task_num;
   }
 
+  // 分片缓冲区从全局缓冲区池申请, 下载结束后归还复用
   unsigned char** file_content_buf = new unsigned char*[pool_size];
+  bool buf_alloc_fail = false;
   for (unsigned i = 0; i < pool_size; ++i) {
-    file_content_buf[i] = new unsigned char[slice_size];
+    file_content_buf[i] = GetGlobalBufferPool().Acquire(slice_size);
+    if (file_content_buf[i] == nullptr) {
+      buf_alloc_fail = true;
+    }
+  }
+  if (buf_alloc_fail) {
+    for (unsigned i = 0; i < pool_size; ++i) {
+      GetGlobalBufferPool().Release(file_content_buf[i]);
+    }
+    delete[] file_content_buf;
+#if defined(_WIN32)
+    _close(fd);
+#else
+    close(fd);
+#endif
+    SetResultAndLogError(result, "allocate slice buffer fail, size=" +
+                                     StringUtil::Uint64ToString(slice_size));
+    if (handler) {
+      handler->UpdateStatus(TransferStatus::FAILED, result);
+    }
+    return result;
   }
 
-  // 创建共享信号量，初始计数为pool_size，任务完成时notify，主线程wait
-  Semaphore semaphore(pool_size);
+  // 任务完成时推入自己的槽位下标，主线程按完成顺序取出并立即复用该槽位
+  CompletionQueue done_queue;
 
   FileDownTask** pptaskArr = new FileDownTask*[pool_size];
   for (unsigned i = 0; i < pool_size; ++i) {
     pptaskArr[i] =
         new FileDownTask(host, path, req.IsHttps(), m_op_util, headers, params, req.GetConnTimeoutInms(),
                          req.GetRecvTimeoutInms(), handler);
-    pptaskArr[i]->SetSemaphore(&semaphore);
+    pptaskArr[i]->SetCompletionQueue(&done_queue, i);
+    // 任务线程下载完成后计算分片CRC64并直接写入文件的对应偏移处
+    pptaskArr[i]->SetWriteFd(fd);
+    pptaskArr[i]->SetCalcCrc64(true);
   }
 
   SDK_LOG_INFO("download data,host=%s, path=%s, poolsize=%u, slice_size=%u, file_size=%" PRIu64
-               ", last_offset=%" PRIu64, host.c_str(), path.c_str(), pool_size, slice_size, file_size, resume_offset);
+               ", resumed_size=%" PRIu64 ", pending_slices=%zu", host.c_str(), path.c_str(), pool_size,
+               slice_size, file_size, resumed_size, pending_slices.size());
 
   std::vector<uint64_t> vec_offset;
   vec_offset.resize(pool_size);
-  // maxCapacity 设为 pool_size + 1：release() 之后 run() 返回之前存在短暂时间窗口，
-  // 此时线程尚未回到池中，主线程可能再次调用 tp.start()，需要额外一个线程容量
-  Poco::ThreadPool tp(pool_size, pool_size + 1);
-  // 如果走断点下载，则从resume_offset开始下载
-  uint64_t offset = resume_offset;
+  // 任务提交到全局传输线程池, 本次传输最多同时占用pool_size个线程
+  TransferWorkerPool::Group tp(GetGlobalTransferWorkerPool(), pool_size);
+  // 如果走断点下载，则只下载未完成的分片
+  size_t next_pending = 0;
   bool task_fail_flag = false;
   bool is_header_set = false;
-  // TODO(jackyding) 暂时不校验md5,分块上传的文件etag不是md5
-  uint64_t resume_update_offset = resume_offset;  // 已连续完成并写入的最大offset
-
-  // 滑动窗口中任务完成顺序不确定，CRC64必须按offset顺序流式计算
-  // 用有序map缓存已完成但还未按序处理的分片：key=offset, value=(buf_index, download_len)
-  struct SliceInfo {
-    std::vector<unsigned char> buf;  // buf数据拷贝，避免槽位复用后数据被覆盖
-    uint64_t download_len;
-  };
-  std::map<uint64_t, SliceInfo> completed_slices;  // key=slice起始offset
-
-  // 处理所有已完成（TASK_COMPLETED）的任务槽，写入文件并重置为IDLE
-  auto process_completed_tasks = [&]() {
-    for (unsigned i = 0; i < pool_size && !task_fail_flag; ++i) {
-      FileDownTask* ptask = pptaskArr[i];
-      if (ptask->GetTaskStatus() != TASK_COMPLETED) {
-        continue;
-      }
 
-      if (!ptask->IsTaskSuccess()) {
-        const std::string& task_resp = ptask->GetTaskResp();
+  // 空闲任务槽，只由主线程访问
+  std::vector<unsigned> idle_slots;
+  for (unsigned i = pool_size; i > 0; --i) {
+    idle_slots.push_back(i - 1);
+  }
+  unsigned active_tasks = 0;
+
+  // 处理一个已完成（TASK_COMPLETED）的任务槽并重置为IDLE, 数据已由任务线程写入文件
+  auto process_completed_task = [&](unsigned i) {
+    FileDownTask* ptask = pptaskArr[i];
+    if (!ptask->IsTaskSuccess()) {
+      const std::string& task_resp = ptask->GetTaskResp();
+      SDK_LOG_ERR("[sliding window] down task fail, index=%u, offset=%" PRIu64
+                  ", rsp: %s", i, vec_offset[i], task_resp.c_str());
+      if (!task_fail_flag) {
+        // 只记录第一个失败任务的错误信息
         const std::map<std::string, std::string>& task_resp_headers =
             ptask->GetRespHeaders();
-        SDK_LOG_ERR("[sliding window] down task fail, index=%u, offset=%" PRIu64
-                    ", rsp: %s", i, vec_offset[i], task_resp.c_str());
         result.SetHttpStatus(ptask->GetHttpStatus());
         if (ptask->GetHttpStatus() < 0) {
           result.SetErrorMsg(ptask->GetErrMsg());
@@ -3120,77 +3386,60 @@ CosResult ObjectOp::ResumableGetObject(const GetObjectByFileReq& req,
           result.SetErrorMsg(task_resp);
         }
         resp->ParseFromHeaders(ptask->GetRespHeaders());
-        task_fail_flag = true;
-        break;
-      }
-
-      // 任务成功：写入文件
-      if (!SeekFile(fd, vec_offset[i], result)) {
-        task_fail_flag = true;
-        break;
-      }
-      if (-1 == write(fd, file_content_buf[i], ptask->GetDownLoadLen())) {
-        std::string err_msg =
-            "down data, write ret=" + StringUtil::IntToString(errno) +
-            ", len=" + StringUtil::Uint64ToString(ptask->GetDownLoadLen());
-        SDK_LOG_ERR("%s", err_msg.c_str());
-        result.SetErrorMsg(err_msg);
-        task_fail_flag = true;
-        break;
       }
+      task_fail_flag = true;
+      return;
+    }
 
-      if (!is_header_set) {
-        resp->ParseFromHeaders(ptask->GetRespHeaders());
-        is_header_set = true;
-      }
+    if (!is_header_set) {
+      resp->ParseFromHeaders(ptask->GetRespHeaders());
+      is_header_set = true;
+    }
 
-      // 将buf数据拷贝到SliceInfo中，然后立即重置槽位为IDLE供新任务复用
-      // 这样后续分片完成后可以立刻启动新任务，不影响并发度
-      // CRC64按序消费时读取拷贝的数据，不依赖原始buf
-      uint64_t down_len = ptask->GetDownLoadLen();
-      SliceInfo si;
-      si.buf.assign(file_content_buf[i], file_content_buf[i] + down_len);
-      si.download_len = down_len;
-      completed_slices[vec_offset[i]] = std::move(si);
-      ptask->ResetTaskStatus();  // 立即重置，槽位可立刻被新任务复用
-
-      SDK_LOG_DBG("[sliding window] task completed, index=%u, offset=%" PRIu64
-                  ", downlen=%" PRIu64, i, vec_offset[i], down_len);
-
-      // 按offset顺序推进CRC64和resume_update_offset
-      // 只有从resume_update_offset开始连续的分片才能推进
-      while (!completed_slices.empty()) {
-        auto it = completed_slices.begin();
-        if (it->first != resume_update_offset) {
-          // 还有空洞，等待前面的分片完成
-          break;
-        }
-        const SliceInfo& si = it->second;
-        // 流式更新CRC64（必须按顺序），读取拷贝的数据
-        crc64_local = CRC64::CalcCRC(crc64_local, const_cast<unsigned char*>(si.buf.data()), si.download_len);
-        resume_update_offset += si.download_len;
-        SDK_LOG_DBG("[sliding window] crc64 updated, resume_update_offset=%" PRIu64
-                    ", crc64_local=%" PRIu64, resume_update_offset, crc64_local);
-        completed_slices.erase(it);
+    // 数据不完整的分片不能记为已完成
+    uint64_t down_len = ptask->GetDownLoadLen();
+    uint64_t slice_len = std::min<uint64_t>(slice_size, file_size - vec_offset[i]);
+    if (down_len != slice_len) {
+      if (!task_fail_flag) {
+        result.SetErrorMsg("download slice incomplete, offset=" +
+                           StringUtil::Uint64ToString(vec_offset[i]) +
+                           ", downlen=" + StringUtil::Uint64ToString(down_len) +
+                           ", expected=" + StringUtil::Uint64ToString(slice_len));
       }
+      SDK_LOG_ERR("[sliding window] down task incomplete, index=%u, offset=%" PRIu64
+                  ", downlen=%" PRIu64 ", expected=%" PRIu64,
+                  i, vec_offset[i], down_len, slice_len);
+      task_fail_flag = true;
+      return;
     }
+
+    // 记录分片完成情况及CRC64后立即重置槽位为IDLE供新任务复用,
+    // 乱序完成的分片同样记入任务文件, 续传时无需重新下载
+    uint64_t slice_index = vec_offset[i] / slice_size;
+    slices.done[slice_index] = true;
+    slices.crc64[slice_index] = ptask->GetCrc64();
+    crc64_combiner.AddSlice(vec_offset[i], ptask->GetCrc64(), down_len);
+    ptask->ResetTaskStatus();  // 立即重置，槽位可立刻被新任务复用
+    idle_slots.push_back(i);
+
+    SDK_LOG_DBG("[sliding window] task completed, index=%u, offset=%" PRIu64
+                ", downlen=%" PRIu64 ", combined_offset=%" PRIu64,
+                i, vec_offset[i], down_len, crc64_combiner.GetOffset());
   };
 
-  while (offset < file_size || semaphore.get_count() > 0) {
+  while (next_pending < pending_slices.size() || active_tasks > 0) {
     if (handler && !handler->ShouldContinue()) {
       task_fail_flag = true;
       SetResultAndLogError(result, "Request canceled by user");
       break;
     }
 
-    // 填充空闲任务槽，直到窗口满或文件下载完
-    for (int i = 0; i < (int)pool_size && semaphore.get_count() < pool_size && offset < file_size; ++i) {
-      if (pptaskArr[i]->GetTaskStatus() != TASK_IDLE) {
-        // 跳过非空闲的任务槽
-        continue;
-      }
-
+    // 填充空闲任务槽，直到窗口满或未完成的分片都已开始下载
+    while (!idle_slots.empty() && next_pending < pending_slices.size()) {
+      unsigned i = idle_slots.back();
+      idle_slots.pop_back();
       FileDownTask* ptask = pptaskArr[i];
+      uint64_t offset = pending_slices[next_pending] * slice_size;
       uint64_t left_size = file_size - offset;
       uint64_t part_len = slice_size < left_size ? slice_size : left_size;
 
@@ -3200,22 +3449,23 @@ CosResult ObjectOp::ResumableGetObject(const GetObjectByFileReq& req,
       ptask->SetSslCtxCb(req.GetSSLCtxCallback(), req.GetSSLCtxCbData());
 
       vec_offset[i] = offset;
-      // 申请信号量，这里一定可以申请到
-      semaphore.acquire();
-      // 在 tp.start() 之前主动设为 RUNNING，防止 run() 尚未开始时槽位被误判为 IDLE 而重复使用
       ptask->SetTaskRunning();
+      ++active_tasks;
       SDK_LOG_DBG("[sliding window] new task started, index=%u, offset=%" PRIu64 ", len=%" PRIu64 ", active_tasks=%u",
-          i, offset, part_len, semaphore.get_count());
-      tp.start(*ptask);
+          i, offset, part_len, active_tasks);
+      tp.Start(*ptask);
 
-      offset += part_len;
+      ++next_pending;
     }
 
-    // 阻塞等待任意一个任务完成（由FileDownTask中的semaphore->release()触发）
-    semaphore.wait();
-
-    // 扫描所有已完成（TASK_COMPLETED）的任务槽，处理结果并重置为IDLE
-    process_completed_tasks();
+    // 阻塞等待任意一个任务完成，然后处理其间已完成的其他任务
+    process_completed_task(done_queue.pop());
+    --active_tasks;
+    unsigned done_slot = 0;
+    while (!task_fail_flag && done_queue.try_pop(&done_slot)) {
+      --active_tasks;
+      process_completed_task(done_slot);
+    }
 
     if (task_fail_flag) {
       break;
@@ -3223,16 +3473,21 @@ CosResult ObjectOp::ResumableGetObject(const GetObjectByFileReq& req,
   }
 
   // 等待所有剩余任务完成
-  tp.joinAll();
+  tp.JoinAll();
 
-  // joinAll()后扫描遗漏任务：while循环退出时可能有已完成但未处理的任务槽
-  process_completed_tasks();
+  // 处理退出循环后完成的任务：失败时也记录这些分片，减少续传时重新下载的数据
+  unsigned done_slot = 0;
+  while (done_queue.try_pop(&done_slot)) {
+    process_completed_task(done_slot);
+  }
 
   bool need_to_redownload = false;
   if (!task_fail_flag) {
     SDK_LOG_INFO("down data succeed, start to check crc64");
-    if (StringUtil::StringToUint64(head_resp.GetXCosHashCrc64Ecma()) ==
-        crc64_local) {
+    uint64_t crc64_local = crc64_combiner.GetCrc64();
+    if (crc64_combiner.GetOffset() == file_size &&
+        StringUtil::StringToUint64(head_resp.GetXCosHashCrc64Ecma()) ==
+            crc64_local) {
       SDK_LOG_INFO("crc64 check passed");
       result.SetSucc();
       // 下载成功则用head得到的content_length和etag设置get response
@@ -3251,7 +3506,7 @@ CosResult ObjectOp::ResumableGetObject(const GetObjectByFileReq& req,
                   StringUtil::StringToUint64(head_resp.GetXCosHashCrc64Ecma()));
       // CRC
       // check失败，如果存在本地文件，则可能本地文件不是最新的，删除任务文件以及本地文件
-      if (resume_offset > 0) {
+      if (is_resume) {
         SDK_LOG_INFO("need to redownload, remove %s, %s",
                      resumable_task_json_file.c_str(), local_path.c_str());
         ::remove(resumable_task_json_file.c_str());
@@ -3270,20 +3525,10 @@ CosResult ObjectOp::ResumableGetObject(const GetObjectByFileReq& req,
   } else {
     // 有任务下载失败
     SDK_LOG_ERR("down data failed");
-    if (resume_offset > 0) {
-      // 如果走断点下载,则有任务失败批次写入的数据
-      SDK_LOG_INFO("truncate file to %" PRIu64, resume_update_offset);
-#if defined(_WIN32)
-      _chsize(fd, resume_update_offset);
-#else
-      ftruncate(fd, resume_update_offset);
-#endif
-    }
     result.SetFail();
-    // 如果失败,则更新resume offset到最新offset
+    // 如果失败,则记录已完成的分片及其CRC64, 乱序完成的分片也无需重新下载
     UpdateResumableDownloadTaskFile(resumable_task_json_file,
-                                    resume_task_check_element,
-                                    resume_update_offset);
+                                    resume_task_check_element, slices);
     if (handler) {
       handler->UpdateStatus(TransferStatus::FAILED, result);
     }
@@ -3296,7 +3541,7 @@ CosResult ObjectOp::ResumableGetObject(const GetObjectByFileReq& req,
   close(fd);
 #endif
   for (unsigned i = 0; i < pool_size; i++) {
-    delete[] file_content_buf[i];
+    GetGlobalBufferPool().Release(file_content_buf[i]);
     delete pptaskArr[i];
   }
   delete[] pptaskArr;
@@ -3350,54 +3595,122 @@ CosResult ObjectOp::PutObjects(const PutObjectsByDirectoryReq& req,
     return result;
   }
 
+  // 1. 遍历目录得到所有待上传的文件及总大小
+  struct PutEntry {
+    std::string file_name;
+    std::string object_name;
+    uint64_t file_size;
+    bool is_dir;
+  };
+  std::vector<PutEntry> entries;
+  uint64_t total_size = 0;
   Poco::Path p(directory_name);
   Poco::SimpleRecursiveDirectoryIterator dirIterator(p);
   Poco::SimpleRecursiveDirectoryIterator end;
-  std::string file_name;
-  std::string object_name;
   std::string bucket_name = req.GetBucketName();
   std::string cos_path = req.GetCosPath();
   while (dirIterator != end) {
-    file_name = dirIterator->path();
-    object_name = StringUtil::StringRemovePrefix(file_name, directory_name);
-    object_name = cos_path + object_name;
+    PutEntry entry;
+    entry.file_name = dirIterator->path();
+    entry.object_name =
+        cos_path + StringUtil::StringRemovePrefix(entry.file_name, directory_name);
+    entry.is_dir = FileUtil::IsDirectory(entry.file_name);
+    entry.file_size = entry.is_dir ? 0 : FileUtil::GetFileLen(entry.file_name);
+    total_size += entry.file_size;
+    entries.push_back(entry);
+    ++dirIterator;
+  }
 
-    PutObjectsByDirectoryResp::PutResp r;
-    r.m_file_name = file_name;
-    r.m_object_name = object_name;
+  // 2. 汇总各文件的进度, 回调传入所有文件的累计大小
+  const TransferProgressCallback progress_cb = req.GetTransferProgressCallback();
+  void* user_data = req.GetUserData();
+  std::mutex progress_mutex;
+  uint64_t transferred_size = 0;
+  auto report_progress = [&](uint64_t delta) {
+    std::lock_guard<std::mutex> lock(progress_mutex);
+    transferred_size += delta;
+    progress_cb(transferred_size, total_size, user_data);
+  };
 
-    // TODO 支持异步操作
-    if (FileUtil::IsDirectory(file_name)) {
+  // 3. 上传单个文件, 大文件使用分块上传
+  const uint64_t multi_upload_threshold = req.GetMultiUploadThreshold();
+  auto put_entry = [&](const PutEntry& entry,
+                       PutObjectsByDirectoryResp::PutResp* r) -> CosResult {
+    if (entry.is_dir) {
       // 创建目录
-      PutDirectoryReq put_dir_req(bucket_name, file_name);
+      PutDirectoryReq put_dir_req(bucket_name, entry.file_name);
       PutDirectoryResp put_dir_resp;
       put_dir_req.AddHeaders(req.GetHeaders());
-      SDK_LOG_DBG("start to mkdir: %s", file_name.c_str());
-      CosResult put_dir_result = PutDirectory(put_dir_req, &put_dir_resp, change_backup_domain);
-      if (!put_dir_result.IsSucc()) {
-        SDK_LOG_ERR("failed to mkdir: %s", file_name.c_str());
-        return put_dir_result;
+      SDK_LOG_DBG("start to mkdir: %s", entry.file_name.c_str());
+      CosResult put_dir_result =
+          PutDirectory(put_dir_req, &put_dir_resp, change_backup_domain);
+      if (put_dir_result.IsSucc()) {
+        r->m_cos_resp.CopyFrom(put_dir_resp);
+      }
+      return put_dir_result;
+    }
+
+    PutObjectByFileReq put_obj_req(bucket_name, entry.object_name,
+                                   entry.file_name);
+    put_obj_req.AddHeaders(req.GetHeaders());
+    if (!req.ShouldComputeContentMd5()) {
+      put_obj_req.TurnOffComputeConentMd5();
+    }
+    SharedTransferHandler handler;
+    if (progress_cb) {
+      handler = NewFileProgressHandler(entry.file_size, report_progress);
+    }
+    SDK_LOG_DBG("start to upload %s to %s, size=%" PRIu64,
+                entry.file_name.c_str(), entry.object_name.c_str(),
+                entry.file_size);
+    CosResult put_obj_result;
+    if (entry.file_size >= multi_upload_threshold) {
+      MultiPutObjectResp put_obj_resp;
+      put_obj_result = MultiUploadObject(put_obj_req, &put_obj_resp, handler,
+                                         change_backup_domain);
+      if (put_obj_result.IsSucc()) {
+        r->m_cos_resp.CopyFrom(put_obj_resp);
       }
-
-      r.m_cos_resp.CopyFrom(put_dir_resp);
     } else {
-      // 上传文件
-      PutObjectByFileReq put_obj_req(bucket_name, object_name, file_name);
-      put_obj_req.AddHeaders(req.GetHeaders());
       PutObjectByFileResp put_obj_resp;
-      SDK_LOG_DBG("start to upload %s to %s", file_name.c_str(),
-                  object_name.c_str());
-      CosResult put_obj_result = PutObject(put_obj_req, &put_obj_resp, nullptr, change_backup_domain);
-      if (!put_obj_result.IsSucc()) {
-        SDK_LOG_ERR("failed to upload file: %s to cos", file_name.c_str());
-        return put_obj_result;
+      put_obj_result =
+          PutObject(put_obj_req, &put_obj_resp, handler, change_backup_domain);
+      if (put_obj_result.IsSucc()) {
+        r->m_cos_resp.CopyFrom(put_obj_resp);
       }
-      r.m_cos_resp.CopyFrom(put_obj_resp);
     }
-    resp->m_succ_put_objs.push_back(r);
-    ++dirIterator;
-  }
+    return put_obj_result;
+  };
 
+  // 4. 多个文件并发上传, 单个文件失败不影响其他文件
+  FileWorkerResult worker_result;
+  RunFileWorkers(req.GetConcurrency(), entries.size(), [&](size_t index) {
+    const PutEntry& entry = entries[index];
+    PutObjectsByDirectoryResp::PutResp r;
+    r.m_file_name = entry.file_name;
+    r.m_object_name = entry.object_name;
+    CosResult put_result = put_entry(entry, &r);
+
+    std::lock_guard<std::mutex> lock(worker_result.GetMutex());
+    if (put_result.IsSucc()) {
+      resp->m_succ_put_objs.push_back(r);
+      return;
+    }
+    SDK_LOG_ERR("failed to upload file: %s to cos, msg=%s",
+                entry.file_name.c_str(), put_result.GetErrorMsg().c_str());
+    PutObjectsByDirectoryResp::PutFailResp fail_r;
+    fail_r.m_file_name = entry.file_name;
+    fail_r.m_object_name = entry.object_name;
+    fail_r.m_http_status = put_result.GetHttpStatus();
+    fail_r.m_err_code = put_result.GetErrorCode();
+    fail_r.m_err_msg = put_result.GetErrorMsg();
+    resp->m_fail_put_objs.push_back(fail_r);
+    worker_result.SetFailLocked(put_result);
+  });
+
+  if (worker_result.IsFailed()) {
+    return worker_result.GetFailResult();
+  }
   result.SetSucc();
   return result;
 }
@@ -84,7 +84,7 @@ bool GetBucketResp::ParseFromXmlString(const std::string& body) {
         } else if (name == kGetBucketContentsOwner) {
           rapidxml::xml_node<>* id_node = contents_node->first_node();
           for (; id_node != NULL; id_node = id_node->next_sibling()) {
-            if (id_node->name() != kGetBucketContentsOwnerID) {
+            if (std::string(id_node->name()) != kGetBucketContentsOwnerID) {
               continue;
             }
             cnt.m_owner_ids.push_back(std::string(id_node->value()));
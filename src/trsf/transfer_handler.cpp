@@ -1,4 +1,5 @@
 ﻿#include "trsf/transfer_handler.h"
+#include <algorithm>
 #include <iostream>
 #include "Poco/Buffer.h"
 #include "response/object_resp.h"
@@ -208,6 +209,35 @@ HandleStreamCopier::handleCopyStream(const SharedTransferHandler& handler,
   return len;
 }
 
+std::streamsize HandleStreamCopier::handleCopyStream(
+    const SharedTransferHandler& handler, std::istream& istr, char *buf, size_t buf_len,
+    std::size_t bufferSize) {
+  poco_assert(bufferSize > 0);
+  poco_assert(buf != nullptr || buf_len == 0);
+
+  std::streamsize len = 0;
+  std::streamsize capacity = static_cast<std::streamsize>(buf_len);
+  std::streamsize part_size = static_cast<std::streamsize>(bufferSize);
+  while (len < capacity && istr) {
+    // 用户取消操作
+    if (handler && !handler->ShouldContinue()) {
+      throw UserCancelException();
+    }
+
+    istr.read(buf + len, std::min(part_size, capacity - len));
+    std::streamsize n = istr.gcount();
+    if (n <= 0) {
+      break;
+    }
+    len += n;
+    // update progress
+    if (handler) {
+      handler->UpdateProgress(n);
+    }
+  }
+  return len;
+}
+
 // 代码主要逻辑复制了 Poco::StreamCopier::copyStream(io_tmp, resp_stream) 的代码, 内部加入了客户取消操作的判断逻
 std::streamsize HandleStreamCopier::handleCopyStream(
     const SharedTransferHandler& handler, std::istream& istr, std::ostream& ostr, std::size_t bufferSize) {
@@ -238,4 +268,19 @@ std::streamsize HandleStreamCopier::handleCopyStream(
   }
   return len;
 }
+
+SharedTransferHandler NewFileProgressHandler(
+    uint64_t file_size, const std::function<void(uint64_t delta)>& report) {
+  SharedTransferHandler handler(new TransferHandler());
+  handler->SetTotalSize(file_size);
+  uint64_t last_size = 0;
+  handler->SetTransferProgressCallback(
+      [report, last_size](uint64_t transferred, uint64_t, void*) mutable {
+        if (transferred > last_size) {
+          report(transferred - last_size);
+          last_size = transferred;
+        }
+      });
+  return handler;
+}
 }  // namespace qcloud_cos
@@ -7,11 +7,12 @@
 #include <algorithm>
 #include <iostream>
 #include <unordered_set>
+#include <vector>
 
 #include "cos_sys_config.h"
 #include "util/codec_util.h"
+#include "util/hash_util.h"
 #include "util/http_sender.h"
-#include "util/sha1.h"
 #include "util/string_util.h"
 
 #if defined(_WIN32)
@@ -21,10 +22,10 @@
 
 namespace qcloud_cos {
 
-void AuthTool::FilterAndSetSignHeader(
-    const std::map<std::string, std::string>& headers,
-    std::map<std::string, std::string>* filted_req_headers,
-    const std::unordered_set<std::string>& not_sign_headers) {
+namespace {
+
+// 除host、content-type等通用头部外, x-cos、x-ci开头的头部也需要签名
+const std::unordered_set<std::string>& GetSignHeaders() {
   const static std::unordered_set<std::string> sign_headers = {
       "cache-control",
       "content-disposition",
@@ -44,57 +45,158 @@ void AuthTool::FilterAndSetSignHeader(
       "transfer-encoding",
       "pic-operations"
       };
-  for (std::map<std::string, std::string>::const_iterator itr = headers.begin();
-       itr != headers.end(); ++itr) {
-    if (!not_sign_headers.count(itr->first) && (sign_headers.count(StringUtil::StringToLower(itr->first)) > 0 ||
-        !strncmp(itr->first.c_str(), "x-cos", 5) || !strncmp(itr->first.c_str(), "x-ci", 4))) {
-      filted_req_headers->insert(std::make_pair(itr->first, itr->second));
-    }
+  return sign_headers;
+}
+
+char LowerAscii(char ch) {
+  return (ch >= 'A' && ch <= 'Z') ? static_cast<char>(ch - 'A' + 'a') : ch;
+}
+
+void AppendLower(const std::string& str, std::string* out) {
+  for (size_t i = 0; i < str.size(); ++i) {
+    out->push_back(LowerAscii(str[i]));
   }
 }
 
-void AuthTool::FillMap(const std::map<std::string, std::string>& params,
-                       bool key_encode, bool value_encode, bool value_lower,
-                       std::string* param_list, std::string* param_value_list) {
-  if (params.empty()) {
-    return;
+// 与CodecUtil::UrlEncode的编码规则一致, 直接追加到out, lower为true时结果转小写
+void AppendUrlEncode(const std::string& str, bool lower, std::string* out) {
+  for (size_t i = 0; i < str.size(); ++i) {
+    unsigned char ch = static_cast<unsigned char>(str[i]);
+    if (CodecUtil::IsalnumAscii(ch) || ch == '-' || ch == '_' || ch == '.' ||
+        ch == '~') {
+      out->push_back(lower ? LowerAscii(str[i]) : str[i]);
+    } else {
+      char high = static_cast<char>(CodecUtil::ToHex(ch >> 4));
+      char low = static_cast<char>(CodecUtil::ToHex(ch & 0x0F));
+      out->push_back('%');
+      out->push_back(lower ? LowerAscii(high) : high);
+      out->push_back(lower ? LowerAscii(low) : low);
+    }
   }
+}
 
-  std::map<std::string, std::string>::const_iterator itr;
-  std::map<std::string, std::string> trim_params;
+// 参与签名的一个键值对, key已编码并转小写, value在拼接时编码
+struct SignEntry {
+  std::string key;
+  const std::string* value;
+};
 
-  for (itr = params.begin(); itr != params.end(); ++itr) {
-    std::string key, value;
-    if (key_encode) {
-      key = CodecUtil::UrlEncode(itr->first);
-    } else {
-      key = itr->first;
+bool SignEntryLess(const SignEntry& lhs, const SignEntry& rhs) {
+  return lhs.key < rhs.key;
+}
+
+// 按key排序, 转换后key相同时保留最后一个, 与依次写入std::map的结果一致
+void SortSignEntries(std::vector<SignEntry>* entries) {
+  std::stable_sort(entries->begin(), entries->end(), SignEntryLess);
+  size_t count = 0;
+  for (size_t i = 0; i < entries->size(); ++i) {
+    if (i + 1 < entries->size() && (*entries)[i + 1].key == (*entries)[i].key) {
+      continue;
+    }
+    if (count != i) {
+      (*entries)[count].key.swap((*entries)[i].key);
+      (*entries)[count].value = (*entries)[i].value;
     }
+    ++count;
+  }
+  entries->resize(count);
+}
 
-    if (value_encode) {
-      value = CodecUtil::UrlEncode(itr->second);
-    } else {
-      value = itr->second;
+// 签名所需的url参数: key、value均编码, key转小写
+void CollectSignParams(const std::map<std::string, std::string>& params,
+                       std::vector<SignEntry>* entries) {
+  entries->reserve(params.size());
+  for (std::map<std::string, std::string>::const_iterator itr = params.begin();
+       itr != params.end(); ++itr) {
+    entries->push_back(SignEntry());
+    SignEntry& entry = entries->back();
+    AppendUrlEncode(itr->first, true, &entry.key);
+    entry.value = &itr->second;
+  }
+  SortSignEntries(entries);
+}
+
+// 找出需要签名的头部: key转小写不编码, value编码
+void CollectSignHeaders(const std::map<std::string, std::string>& headers,
+                        const std::unordered_set<std::string>& not_sign_headers,
+                        std::vector<SignEntry>* entries) {
+  const std::unordered_set<std::string>& sign_headers = GetSignHeaders();
+  entries->reserve(headers.size());
+  std::string lower_key;
+  for (std::map<std::string, std::string>::const_iterator itr = headers.begin();
+       itr != headers.end(); ++itr) {
+    if (not_sign_headers.count(itr->first) > 0) {
+      continue;
+    }
+    lower_key.clear();
+    AppendLower(itr->first, &lower_key);
+    if (sign_headers.count(lower_key) > 0 ||
+        !strncmp(itr->first.c_str(), "x-cos", 5) ||
+        !strncmp(itr->first.c_str(), "x-ci", 4)) {
+      entries->push_back(SignEntry());
+      entries->back().key = lower_key;
+      entries->back().value = &itr->second;
     }
+  }
+  SortSignEntries(entries);
+}
 
-    std::transform(key.begin(), key.end(), key.begin(), ::tolower);
-    if (value_lower) {
-      std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+// 拼接key1=value1&key2=value2, value在此编码
+void AppendKeyValueList(const std::vector<SignEntry>& entries,
+                        std::string* out) {
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if (i > 0) {
+      out->push_back('&');
     }
-    trim_params[key] = value;
+    out->append(entries[i].key);
+    out->push_back('=');
+    AppendUrlEncode(*entries[i].value, false, out);
   }
+}
 
-  itr = trim_params.begin();
+// 拼接key1;key2
+void AppendKeyList(const std::vector<SignEntry>& entries, std::string* out) {
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if (i > 0) {
+      out->push_back(';');
+    }
+    out->append(entries[i].key);
+  }
+}
 
-  param_list->append(itr->first);
-  *param_value_list += itr->first + "=" + itr->second;
+size_t EstimateSignEntriesSize(const std::vector<SignEntry>& entries) {
+  size_t size = 0;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    // value编码后最多为原长度的3倍
+    size += entries[i].key.size() + entries[i].value->size() * 3 + 2;
+  }
+  return size;
+}
 
-  for (++itr; itr != trim_params.end(); ++itr) {
-    *param_list += ";" + itr->first;
-    *param_value_list += "&" + itr->first + "=" + itr->second;
+// 由secret_key和key-time派生的sign_key, 同一秒内签名的key-time相同,
+// 每个线程缓存最近一次的结果, 避免每次签名都计算HMAC且无需加锁.
+// 返回的引用在本线程下次调用前有效
+const std::string& GetSignKey(const std::string& secret_key,
+                              const std::string& key_time) {
+  struct SignKeyCache {
+    std::string secret_key;
+    std::string key_time;
+    std::string sign_key;
+  };
+  static thread_local SignKeyCache cache;
+  if (cache.sign_key.empty() || cache.key_time != key_time ||
+      cache.secret_key != secret_key) {
+    cache.sign_key = CodecUtil::HmacSha1Hex(key_time, secret_key);
+    std::transform(cache.sign_key.begin(), cache.sign_key.end(),
+                   cache.sign_key.begin(), ::tolower);
+    cache.secret_key = secret_key;
+    cache.key_time = key_time;
   }
+  return cache.sign_key;
 }
 
+}  // namespace
+
 std::string AuthTool::Sign(const std::string& access_key,
                            const std::string& secret_key,
                            const std::string& http_method,
@@ -126,55 +228,70 @@ std::string AuthTool::Sign(const std::string& access_key,
   if (access_key.empty() || secret_key.empty()) {
     return "";
   }
-  std::string start_end_time_str = StringUtil::Uint64ToString(start_time_in_s) +
-                                   ";" +
-                                   StringUtil::Uint64ToString(end_time_in_s);
-
-  // 1. 获取签名所需的path/params/headers
-  std::map<std::string, std::string> filted_req_headers;
-  FilterAndSetSignHeader(headers, &filted_req_headers, not_sign_headers);
-
-  // 2. 将header和params拼接为字符串
-  std::string header_list, header_value_list;
-  std::string param_list, param_value_list;
-
-  FillMap(params, true, true, false, &param_list, &param_value_list);
-  FillMap(filted_req_headers, false, true, false, &header_list,
-          &header_value_list);
-
-  std::string uri = in_uri;
-  if (uri.empty()) {
-    uri = "/";
+  std::string start_end_time_str = StringUtil::Uint64ToString(start_time_in_s);
+  start_end_time_str.push_back(';');
+  start_end_time_str.append(StringUtil::Uint64ToString(end_time_in_s));
+
+  // 1. 获取签名所需的params/headers, 编码、转小写并排序
+  std::vector<SignEntry> sign_params;
+  CollectSignParams(params, &sign_params);
+  std::vector<SignEntry> sign_headers;
+  CollectSignHeaders(headers, not_sign_headers, &sign_headers);
+
+  // 2. format string, 在同一块预留的内存中拼接
+  std::string format_str;
+  format_str.reserve(http_method.size() + in_uri.size() + 5 +
+                     EstimateSignEntriesSize(sign_params) +
+                     EstimateSignEntriesSize(sign_headers));
+  AppendLower(http_method, &format_str);
+  format_str.push_back('\n');
+  if (in_uri.empty()) {
+    format_str.push_back('/');
+  } else {
+    format_str.append(in_uri);
   }
-
-  // 3. format string
-  std::string lower_method = StringUtil::StringToLower(http_method);
-  std::string format_str = lower_method + "\n" + uri + "\n" + param_value_list +
-                           "\n" + header_value_list + "\n";
+  format_str.push_back('\n');
+  AppendKeyValueList(sign_params, &format_str);
+  format_str.push_back('\n');
+  AppendKeyValueList(sign_headers, &format_str);
+  format_str.push_back('\n');
 
   SDK_LOG_DBG("format string :%s", format_str.c_str());
-  // 4. StringToSign
-  Sha1 sha1;
-  sha1.Append(format_str.c_str(), format_str.size());
-  std::string string_to_sign =
-      "sha1\n" + start_end_time_str + "\n" + sha1.Final() + "\n";
+  // 3. StringToSign
+  std::string string_to_sign;
+  string_to_sign.reserve(start_end_time_str.size() + 48);
+  string_to_sign.append("sha1\n");
+  string_to_sign.append(start_end_time_str);
+  string_to_sign.push_back('\n');
+  string_to_sign.append(
+      HashUtil::Sha1Hex(format_str.data(), format_str.size()));
+  string_to_sign.push_back('\n');
 
   SDK_LOG_DBG("string_to_sign :%s", string_to_sign.c_str());
-  // 5. signature
-  std::string sign_key = CodecUtil::HmacSha1Hex(start_end_time_str, secret_key);
-  std::transform(sign_key.begin(), sign_key.end(), sign_key.begin(), ::tolower);
+  // 4. signature
+  const std::string& sign_key = GetSignKey(secret_key, start_end_time_str);
 
   SDK_LOG_DBG("sign_key :%s", sign_key.c_str());
   std::string signature = CodecUtil::HmacSha1Hex(string_to_sign, sign_key);
   std::transform(signature.begin(), signature.end(), signature.begin(),
                  ::tolower);
 
-  // 6. 拼接
-  std::string req_sign =
-      "q-sign-algorithm=sha1&q-ak=" + access_key +
-      "&q-sign-time=" + start_end_time_str +
-      "&q-key-time=" + start_end_time_str + "&q-header-list=" + header_list +
-      "&q-url-param-list=" + param_list + "&q-signature=" + signature;
+  // 5. 拼接
+  std::string req_sign;
+  req_sign.reserve(access_key.size() + start_end_time_str.size() * 2 +
+                   format_str.size() + signature.size() + 96);
+  req_sign.append("q-sign-algorithm=sha1&q-ak=");
+  req_sign.append(access_key);
+  req_sign.append("&q-sign-time=");
+  req_sign.append(start_end_time_str);
+  req_sign.append("&q-key-time=");
+  req_sign.append(start_end_time_str);
+  req_sign.append("&q-header-list=");
+  AppendKeyList(sign_headers, &req_sign);
+  req_sign.append("&q-url-param-list=");
+  AppendKeyList(sign_params, &req_sign);
+  req_sign.append("&q-signature=");
+  req_sign.append(signature);
 
   return req_sign;
 }
@@ -207,15 +324,14 @@ std::string AuthTool::RtmpSign(const std::string& secret_id,
     rtmp_str.append(canonicalized_param);
   }
   rtmp_str.append("\n");
-  Sha1 sha1;
-  sha1.Append(rtmp_str.c_str(), rtmp_str.size());
 
   time_t now = time(NULL);
   time_t end = now + expire;
   std::string time_str =
       StringUtil::IntToString(now) + ";" + StringUtil::IntToString(end);
 
-  str_to_sign = "sha1\n" + time_str + "\n" + sha1.Final() + "\n";
+  str_to_sign = "sha1\n" + time_str + "\n" +
+                HashUtil::Sha1Hex(rtmp_str.data(), rtmp_str.size()) + "\n";
 
   signature = CodecUtil::HmacSha1Hex(str_to_sign, secret_key);
   std::transform(signature.begin(), signature.end(), signature.begin(),
@@ -0,0 +1,219 @@
+#include "util/buffer_pool.h"
+
+#include <stdlib.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "cos_sys_config.h"
+
+namespace qcloud_cos {
+
+namespace {
+const size_t kPageSize = 4096;
+const size_t kHugePageSize = 2 * 1024 * 1024;
+// 每个2的幂区间分为4档, 取整浪费不超过25%
+const unsigned kClassesPerDoubling = 4;
+}  // namespace
+
+BufferPool& GetGlobalBufferPool() {
+  static BufferPool buffer_pool(CosSysConfig::GetBufferPoolMaxBytes(),
+                                CosSysConfig::GetBufferPoolUseHugePage());
+  return buffer_pool;
+}
+
+BufferPool::BufferPool(uint64_t max_cached_bytes, bool use_huge_page)
+    : m_max_cached_bytes(max_cached_bytes), m_use_huge_page(use_huge_page) {
+  memset(&m_stats, 0, sizeof(m_stats));
+}
+
+BufferPool::~BufferPool() {
+  Trim();
+  // 使用中的缓冲区由持有者归还, 池析构时不再跟踪
+}
+
+size_t BufferPool::GetSizeClass(size_t size) {
+  if (size <= kPageSize) {
+    return kPageSize;
+  }
+  // 找到不小于size的最小档位: 2^n + k * 2^n / 4
+  size_t pow2 = kPageSize;
+  while (pow2 * 2 < size) {
+    pow2 *= 2;
+  }
+  size_t step = pow2 / kClassesPerDoubling;
+  if (step < kPageSize) {
+    step = kPageSize;
+  }
+  return (size + step - 1) / step * step;
+}
+
+unsigned char* BufferPool::Allocate(size_t size_class, bool huge_page) {
+  void* ptr = nullptr;
+#if defined(_WIN32)
+  ptr = _aligned_malloc(size_class, kPageSize);
+  (void)huge_page;
+#else
+  size_t alignment = huge_page ? kHugePageSize : kPageSize;
+  if (posix_memalign(&ptr, alignment, size_class) != 0) {
+    return nullptr;
+  }
+#if defined(MADV_HUGEPAGE)
+  if (huge_page) {
+    // 透明大页不可用时忽略失败
+    madvise(ptr, size_class, MADV_HUGEPAGE);
+  }
+#endif
+#endif
+  return static_cast<unsigned char*>(ptr);
+}
+
+void BufferPool::Free(unsigned char* buf) {
+#if defined(_WIN32)
+  _aligned_free(buf);
+#else
+  free(buf);
+#endif
+}
+
+unsigned char* BufferPool::Acquire(size_t size) {
+  const size_t size_class = GetSizeClass(size);
+  bool huge_page = false;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_stats.acquire_count;
+    auto it = m_free_lists.find(size_class);
+    if (it != m_free_lists.end() && !it->second.empty()) {
+      unsigned char* buf = it->second.back();
+      it->second.pop_back();
+      ++m_stats.reuse_count;
+      m_stats.bytes_cached -= size_class;
+      m_stats.bytes_in_use += size_class;
+      if (m_stats.bytes_in_use > m_stats.peak_bytes_in_use) {
+        m_stats.peak_bytes_in_use = m_stats.bytes_in_use;
+      }
+      return buf;
+    }
+    huge_page = m_use_huge_page && size_class >= kHugePageSize;
+  }
+
+  // 在锁外分配, 避免大块内存分配阻塞其他线程
+  unsigned char* buf = Allocate(size_class, huge_page);
+  if (buf == nullptr) {
+    SDK_LOG_ERR("allocate buffer fail, size=%zu", size_class);
+    return nullptr;
+  }
+
+  std::vector<unsigned char*> freed;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_buffers[buf] = size_class;
+    m_stats.bytes_in_use += size_class;
+    if (m_stats.bytes_in_use > m_stats.peak_bytes_in_use) {
+      m_stats.peak_bytes_in_use = m_stats.bytes_in_use;
+    }
+    if (m_stats.bytes_in_use > m_max_cached_bytes) {
+      ++m_stats.over_limit_count;
+    }
+    // 使用中的内存增加后, 缓存需要让出空间
+    ShrinkLocked(&freed);
+  }
+  for (size_t i = 0; i < freed.size(); ++i) {
+    Free(freed[i]);
+  }
+  return buf;
+}
+
+void BufferPool::Release(unsigned char* buf) {
+  if (buf == nullptr) {
+    return;
+  }
+  std::vector<unsigned char*> freed;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_buffers.find(buf);
+    if (it == m_buffers.end()) {
+      SDK_LOG_ERR("release unknown buffer %p", static_cast<void*>(buf));
+      return;
+    }
+    const size_t size_class = it->second;
+    m_stats.bytes_in_use -= size_class;
+    if (m_stats.bytes_in_use + m_stats.bytes_cached + size_class <=
+        m_max_cached_bytes) {
+      m_free_lists[size_class].push_back(buf);
+      m_stats.bytes_cached += size_class;
+    } else {
+      m_buffers.erase(it);
+      freed.push_back(buf);
+    }
+  }
+  for (size_t i = 0; i < freed.size(); ++i) {
+    Free(freed[i]);
+  }
+}
+
+void BufferPool::ShrinkLocked(std::vector<unsigned char*>* freed) {
+  // 优先淘汰大规格, 小规格缓冲区更容易被复用
+  auto it = m_free_lists.end();
+  while (m_stats.bytes_cached > 0 &&
+         m_stats.bytes_in_use + m_stats.bytes_cached > m_max_cached_bytes &&
+         it != m_free_lists.begin()) {
+    --it;
+    std::vector<unsigned char*>& free_list = it->second;
+    while (!free_list.empty() &&
+           m_stats.bytes_in_use + m_stats.bytes_cached > m_max_cached_bytes) {
+      unsigned char* buf = free_list.back();
+      free_list.pop_back();
+      m_buffers.erase(buf);
+      m_stats.bytes_cached -= it->first;
+      freed->push_back(buf);
+    }
+  }
+}
+
+void BufferPool::Trim() {
+  std::vector<unsigned char*> freed;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& item : m_free_lists) {
+      for (size_t i = 0; i < item.second.size(); ++i) {
+        m_buffers.erase(item.second[i]);
+        freed.push_back(item.second[i]);
+      }
+      item.second.clear();
+    }
+    m_free_lists.clear();
+    m_stats.bytes_cached = 0;
+  }
+  for (size_t i = 0; i < freed.size(); ++i) {
+    Free(freed[i]);
+  }
+}
+
+BufferPool::Stats BufferPool::GetStats() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_stats;
+}
+
+void BufferPool::SetMaxCachedBytes(uint64_t max_cached_bytes) {
+  std::vector<unsigned char*> freed;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_max_cached_bytes = max_cached_bytes;
+    ShrinkLocked(&freed);
+  }
+  for (size_t i = 0; i < freed.size(); ++i) {
+    Free(freed[i]);
+  }
+}
+
+void BufferPool::SetUseHugePage(bool use_huge_page) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_use_huge_page = use_huge_page;
+}
+
+}  // namespace qcloud_cos
@@ -0,0 +1,306 @@
+#include "util/compact_list_result.h"
+
+#include "util/string_util.h"
+
+namespace qcloud_cos {
+
+namespace {
+
+const size_t kHexETagLen = 32;
+const size_t kPackedETagLen = kHexETagLen / 2;
+const char kHexDigits[] = "0123456789abcdef";
+
+int HexValue(char ch) {
+  if (ch >= '0' && ch <= '9') {
+    return ch - '0';
+  }
+  if (ch >= 'a' && ch <= 'f') {
+    return ch - 'a' + 10;
+  }
+  return -1;
+}
+
+// 32位小写十六进制的ETag(单次上传对象的MD5)按二进制追加到out, 其他格式返回false
+bool PackHexETag(const std::string& etag, std::string* out) {
+  if (etag.size() != kHexETagLen) {
+    return false;
+  }
+  char packed[kPackedETagLen];
+  for (size_t i = 0; i < kPackedETagLen; ++i) {
+    int high = HexValue(etag[2 * i]);
+    int low = HexValue(etag[2 * i + 1]);
+    if (high < 0 || low < 0) {
+      return false;
+    }
+    packed[i] = static_cast<char>((high << 4) | low);
+  }
+  out->append(packed, kPackedETagLen);
+  return true;
+}
+
+int64_t ParseLastModified(const std::string& last_modified) {
+  int64_t ms = 0;
+  if (!ListXmlParser::ParseIso8601Ms(last_modified, &ms)) {
+    return 0;
+  }
+  return ms;
+}
+
+template <typename T>
+size_t VectorBytes(const std::vector<T>& vec) {
+  return vec.capacity() * sizeof(T);
+}
+
+}  // namespace
+
+CompactListResult::CompactListResult()
+    : m_page_begin(0), m_page_prefix_begin(0) {
+  m_offsets.push_back(0);
+}
+
+void CompactListResult::Clear() {
+  m_arena.clear();
+  m_offsets.assign(1, 0);
+  m_key_lens.clear();
+  m_etag_lens.clear();
+  m_sizes.clear();
+  m_last_modified_ms.clear();
+  m_flags.clear();
+  m_attr_ids.clear();
+  m_owner_ids.clear();
+  m_attrs.Clear();
+  m_owners.Clear();
+  m_common_prefixes.clear();
+  m_page_begin = 0;
+  m_page_prefix_begin = 0;
+}
+
+void CompactListResult::Reserve(size_t entry_num, size_t arena_bytes) {
+  m_arena.reserve(arena_bytes);
+  m_offsets.reserve(entry_num + 1);
+  m_key_lens.reserve(entry_num);
+  m_etag_lens.reserve(entry_num);
+  m_sizes.reserve(entry_num);
+  m_last_modified_ms.reserve(entry_num);
+  m_flags.reserve(entry_num);
+  m_attr_ids.reserve(entry_num);
+  m_owner_ids.reserve(entry_num);
+}
+
+void CompactListResult::ShrinkToFit() {
+  m_arena.shrink_to_fit();
+  m_offsets.shrink_to_fit();
+  m_key_lens.shrink_to_fit();
+  m_etag_lens.shrink_to_fit();
+  m_sizes.shrink_to_fit();
+  m_last_modified_ms.shrink_to_fit();
+  m_flags.shrink_to_fit();
+  m_attr_ids.shrink_to_fit();
+  m_owner_ids.shrink_to_fit();
+}
+
+size_t CompactListResult::MemoryUsage() const {
+  size_t bytes = m_arena.capacity();
+  bytes += VectorBytes(m_offsets) + VectorBytes(m_key_lens) +
+           VectorBytes(m_etag_lens) + VectorBytes(m_sizes) +
+           VectorBytes(m_last_modified_ms) + VectorBytes(m_flags) +
+           VectorBytes(m_attr_ids) + VectorBytes(m_owner_ids);
+  // 去重表的取值很少, 每个取值按一个hash节点及其key估算
+  const size_t kInternNodeBytes = 96;
+  bytes += m_attrs.Count() * (sizeof(StorageAttr) + kInternNodeBytes);
+  bytes += m_owners.Count() * (sizeof(Owner) + kInternNodeBytes);
+  for (size_t i = 0; i < m_common_prefixes.size(); ++i) {
+    bytes += sizeof(std::string) + m_common_prefixes[i].capacity();
+  }
+  return bytes;
+}
+
+void CompactListResult::AppendEntry(
+    const std::string& key, const std::string& etag,
+    const std::string& version_id, uint64_t size, int64_t last_modified_ms,
+    const std::string& storage_class, const std::string& storage_tier,
+    const std::string& restore_status, const std::string& owner_id,
+    const std::string& owner_display_name, uint8_t flags) {
+  m_arena.append(key);
+  if (PackHexETag(etag, &m_arena)) {
+    flags |= kFlagETagPacked;
+    m_etag_lens.push_back(static_cast<uint16_t>(kPackedETagLen));
+  } else {
+    // ETag最长为分块上传的"MD5-分块数", 远小于长度字段的上限
+    size_t etag_len = etag.size() > 0xFFFF ? 0xFFFF : etag.size();
+    m_arena.append(etag, 0, etag_len);
+    m_etag_lens.push_back(static_cast<uint16_t>(etag_len));
+  }
+  m_arena.append(version_id);
+  m_offsets.push_back(m_arena.size());
+  m_key_lens.push_back(static_cast<uint32_t>(key.size()));
+  m_sizes.push_back(size);
+  m_last_modified_ms.push_back(last_modified_ms);
+  m_flags.push_back(flags);
+
+  uint32_t attr_id = 0;
+  if (!storage_class.empty() || !storage_tier.empty() ||
+      !restore_status.empty()) {
+    StorageAttr attr;
+    attr.storage_class = storage_class;
+    attr.storage_tier = storage_tier;
+    attr.restore_status = restore_status;
+    std::string attr_key = storage_class;
+    attr_key.append(1, '\0').append(storage_tier);
+    attr_key.append(1, '\0').append(restore_status);
+    attr_id = m_attrs.Intern(attr_key, attr);
+  }
+  m_attr_ids.push_back(attr_id);
+
+  uint32_t owner_index = 0;
+  if (!owner_id.empty() || !owner_display_name.empty()) {
+    Owner owner;
+    owner.m_id = owner_id;
+    owner.m_display_name = owner_display_name;
+    std::string owner_key = owner_id;
+    owner_key.append(1, '\0').append(owner_display_name);
+    owner_index = m_owners.Intern(owner_key, owner);
+  }
+  m_owner_ids.push_back(owner_index);
+}
+
+void CompactListResult::Append(const ListEntry& entry) {
+  uint8_t flags = 0;
+  if (entry.is_latest) {
+    flags |= kFlagLatest;
+  }
+  if (entry.is_delete_marker) {
+    flags |= kFlagDeleteMarker;
+  }
+  AppendEntry(entry.key, entry.etag, entry.version_id, entry.size,
+              entry.last_modified_ms, entry.storage_class, entry.storage_tier,
+              entry.restore_status, entry.owner_id, entry.owner_display_name,
+              flags);
+}
+
+void CompactListResult::Append(const Content& content) {
+  const std::string owner_id =
+      content.m_owner_ids.empty() ? std::string() : content.m_owner_ids[0];
+  AppendEntry(content.m_key, content.m_etag, std::string(),
+              StringUtil::StringToUint64(content.m_size),
+              ParseLastModified(content.m_last_modified),
+              content.m_storage_class, content.m_storage_tier,
+              content.m_restore_status, owner_id, std::string(), 0);
+}
+
+void CompactListResult::Append(const COSVersionSummary& summary) {
+  uint8_t flags = 0;
+  if (summary.m_is_latest) {
+    flags |= kFlagLatest;
+  }
+  if (summary.m_is_delete_marker) {
+    flags |= kFlagDeleteMarker;
+  }
+  AppendEntry(summary.m_key, summary.m_etag, summary.m_version_id,
+              summary.m_size, ParseLastModified(summary.m_last_modified),
+              summary.m_storage_class, std::string(), std::string(),
+              summary.m_owner.m_id, summary.m_owner.m_display_name, flags);
+}
+
+void CompactListResult::AppendContents(const std::vector<Content>& contents) {
+  for (size_t i = 0; i < contents.size(); ++i) {
+    Append(contents[i]);
+  }
+}
+
+void CompactListResult::AppendVersionSummaries(
+    const std::vector<COSVersionSummary>& summaries) {
+  for (size_t i = 0; i < summaries.size(); ++i) {
+    Append(summaries[i]);
+  }
+}
+
+void CompactListResult::AppendCommonPrefix(const std::string& prefix) {
+  m_common_prefixes.push_back(prefix);
+}
+
+void CompactListResult::Truncate(size_t entry_num) {
+  if (entry_num >= Size()) {
+    return;
+  }
+  m_arena.resize(m_offsets[entry_num]);
+  m_offsets.resize(entry_num + 1);
+  m_key_lens.resize(entry_num);
+  m_etag_lens.resize(entry_num);
+  m_sizes.resize(entry_num);
+  m_last_modified_ms.resize(entry_num);
+  m_flags.resize(entry_num);
+  m_attr_ids.resize(entry_num);
+  m_owner_ids.resize(entry_num);
+  if (m_page_begin > entry_num) {
+    m_page_begin = entry_num;
+  }
+}
+
+void CompactListResult::CommitPage() {
+  m_page_begin = Size();
+  m_page_prefix_begin = m_common_prefixes.size();
+}
+
+void CompactListResult::OnReset() {
+  Truncate(m_page_begin);
+  m_common_prefixes.resize(m_page_prefix_begin);
+}
+
+std::string CompactListResult::GetKey(size_t index) const {
+  return m_arena.substr(m_offsets[index], m_key_lens[index]);
+}
+
+std::string CompactListResult::GetETag(size_t index) const {
+  size_t pos = m_offsets[index] + m_key_lens[index];
+  if ((m_flags[index] & kFlagETagPacked) == 0) {
+    return m_arena.substr(pos, m_etag_lens[index]);
+  }
+  std::string etag(kHexETagLen, '0');
+  for (size_t i = 0; i < kPackedETagLen; ++i) {
+    unsigned char byte = static_cast<unsigned char>(m_arena[pos + i]);
+    etag[2 * i] = kHexDigits[byte >> 4];
+    etag[2 * i + 1] = kHexDigits[byte & 0x0F];
+  }
+  return etag;
+}
+
+std::string CompactListResult::GetVersionId(size_t index) const {
+  size_t pos = m_offsets[index] + m_key_lens[index] + m_etag_lens[index];
+  return m_arena.substr(pos, m_offsets[index + 1] - pos);
+}
+
+std::string CompactListResult::GetLastModified(size_t index) const {
+  return ListXmlParser::FormatIso8601Ms(m_last_modified_ms[index]);
+}
+
+void CompactListResult::GetContent(size_t index, Content* content) const {
+  content->m_key = GetKey(index);
+  content->m_last_modified = GetLastModified(index);
+  content->m_etag = GetETag(index);
+  content->m_size = StringUtil::Uint64ToString(m_sizes[index]);
+  content->m_owner_ids.clear();
+  const std::string& owner_id = GetOwnerId(index);
+  if (!owner_id.empty()) {
+    content->m_owner_ids.push_back(owner_id);
+  }
+  content->m_storage_class = GetStorageClass(index);
+  content->m_storage_tier = GetStorageTier(index);
+  content->m_restore_status = GetRestoreStatus(index);
+}
+
+void CompactListResult::GetVersionSummary(size_t index,
+                                          COSVersionSummary* summary) const {
+  summary->m_is_delete_marker = IsDeleteMarker(index);
+  summary->m_etag = GetETag(index);
+  summary->m_size = m_sizes[index];
+  summary->m_storage_class = GetStorageClass(index);
+  summary->m_is_latest = IsLatest(index);
+  summary->m_key = GetKey(index);
+  summary->m_last_modified = GetLastModified(index);
+  summary->m_owner.m_id = GetOwnerId(index);
+  summary->m_owner.m_display_name = GetOwnerDisplayName(index);
+  summary->m_version_id = GetVersionId(index);
+}
+
+}  // namespace qcloud_cos
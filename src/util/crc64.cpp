@@ -35,10 +35,25 @@
    1.3  15 Dec 2013  Add eight-byte processing for big endian as well
                      Make use of the pthread library optional
    1.4  16 Dec 2013  Make once variable volatile for limited thread protection
+   Modified for the COS C++ SDK: add a PCLMULQDQ folding kernel for x86-64
+   with runtime cpu dispatch; the table code remains the portable fallback.
  */
 
 #include "util/crc64.h"
 
+#if defined(__x86_64__) || defined(_M_X64)
+#define CRC64_HAVE_CLMUL 1
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define CRC64_TARGET_CLMUL
+#else
+#include <cpuid.h>
+#define CRC64_TARGET_CLMUL __attribute__((target("sse2,pclmul")))
+#endif
+#endif
+
 namespace qcloud_cos {
 /* 64-bit CRC polynomial with these coefficients, but reversed:
     64, 62, 57, 55, 54, 53, 52, 47, 46, 45, 40, 39, 38, 37, 35, 33, 32,
@@ -161,6 +176,120 @@ static uint64_t crc64_big(uint64_t crc, void *buf, size_t len) {
     return ~rev8(crc);
 }
 
+#ifdef CRC64_HAVE_CLMUL
+/* Carry-less multiplication folding kernel (PCLMULQDQ), following Intel's
+   "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction".
+   Everything stays in the bit-reflected domain used by crc64_little(): a
+   16-byte block loaded little-endian holds the coefficients of x^127..x^0
+   from bit 0 upwards.  Folding a block forward over D bits multiplies its
+   high-degree half (low qword) by x^(D+63) mod P and its low-degree half
+   (high qword) by x^(D-1) mod P; the extra factor x is supplied by the
+   one-bit offset of the reflected carry-less product.  The final 128-bit
+   remainder is reduced with the table code, so no Barrett constants are
+   needed. */
+
+#define CRC64_CLMUL_LANES 8
+#define CRC64_CLMUL_BLOCK (16 * CRC64_CLMUL_LANES)
+
+/* crc64_fold_k[n] holds the constant pair to fold over (n + 1) * 128 bits:
+   [0] = x^(D+63) mod P, [1] = x^(D-1) mod P, both bit-reflected. */
+static uint64_t crc64_fold_k[CRC64_CLMUL_LANES][2];
+static bool crc64_use_clmul = false;
+
+/* Return x^n mod P in the bit-reflected representation. */
+static uint64_t crc64_xpow_mod(unsigned n) {
+    uint64_t r = UINT64_C(1) << 63;     /* x^0 */
+    while (n--)
+        r = r & 1 ? POLY ^ (r >> 1) : r >> 1;
+    return r;
+}
+
+static bool crc64_cpu_has_clmul(void) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 1)) != 0 && (info[3] & (1 << 26)) != 0;
+#else
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return false;
+    return (ecx & bit_PCLMUL) != 0 && (edx & bit_SSE2) != 0;
+#endif
+}
+
+static void crc64_clmul_init(void) {
+    unsigned n;
+
+    for (n = 0; n < CRC64_CLMUL_LANES; n++) {
+        unsigned d = (n + 1) * 128;
+        crc64_fold_k[n][0] = crc64_xpow_mod(d + 63);
+        crc64_fold_k[n][1] = crc64_xpow_mod(d - 1);
+    }
+    crc64_use_clmul = crc64_cpu_has_clmul();
+}
+
+CRC64_TARGET_CLMUL
+static inline __m128i crc64_fold(__m128i x, __m128i k, __m128i data) {
+    __m128i lo = _mm_clmulepi64_si128(x, k, 0x00);
+    __m128i hi = _mm_clmulepi64_si128(x, k, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(lo, hi), data);
+}
+
+CRC64_TARGET_CLMUL
+static inline __m128i crc64_fold_k_load(unsigned n) {
+    return _mm_set_epi64x((long long)crc64_fold_k[n][1],
+                          (long long)crc64_fold_k[n][0]);
+}
+
+/* Requires len >= CRC64_CLMUL_BLOCK. */
+CRC64_TARGET_CLMUL
+static uint64_t crc64_little_clmul(uint64_t crc, void *buf, size_t len) {
+    const unsigned char *next = (const unsigned char *)buf;
+    __m128i x[CRC64_CLMUL_LANES];
+    __m128i k, acc;
+    unsigned char tail[16];
+    uint64_t raw;
+    unsigned i;
+
+    for (i = 0; i < CRC64_CLMUL_LANES; i++)
+        x[i] = _mm_loadu_si128((const __m128i *)(next + 16 * i));
+    /* pre-conditioned crc is xored into the first eight message bytes */
+    x[0] = _mm_xor_si128(x[0], _mm_set_epi64x(0, (long long)~crc));
+    next += CRC64_CLMUL_BLOCK;
+    len -= CRC64_CLMUL_BLOCK;
+
+    /* fold eight independent lanes, 128 bytes per iteration */
+    k = crc64_fold_k_load(CRC64_CLMUL_LANES - 1);
+    while (len >= CRC64_CLMUL_BLOCK) {
+        for (i = 0; i < CRC64_CLMUL_LANES; i++)
+            x[i] = crc64_fold(x[i], k,
+                      _mm_loadu_si128((const __m128i *)(next + 16 * i)));
+        next += CRC64_CLMUL_BLOCK;
+        len -= CRC64_CLMUL_BLOCK;
+    }
+
+    /* fold the lanes into the last one */
+    acc = x[CRC64_CLMUL_LANES - 1];
+    for (i = 0; i < CRC64_CLMUL_LANES - 1; i++)
+        acc = crc64_fold(x[i], crc64_fold_k_load(CRC64_CLMUL_LANES - 2 - i),
+                         acc);
+
+    /* fold the remaining whole blocks one at a time */
+    k = crc64_fold_k_load(0);
+    while (len >= 16) {
+        acc = crc64_fold(acc, k, _mm_loadu_si128((const __m128i *)next));
+        next += 16;
+        len -= 16;
+    }
+
+    /* reduce the 128-bit remainder to the crc register, then finish the
+       trailing bytes with the table code */
+    _mm_storeu_si128((__m128i *)tail, acc);
+    raw = ~crc64_little(~UINT64_C(0), tail, 16);
+    return crc64_little(~raw, (void *)next, len);
+}
+#endif
+
 /* Return the CRC-64 of buf[0..len-1] with initial crc, processing eight bytes
    at a time.  This selects one of two routines depending on the endianess of
    the architecture.  A good optimizing compiler will determine the endianess
@@ -251,6 +380,9 @@ public:
         uint64_t n = 1;
         if (*(char *)&n) {
             crc64_little_init();
+#ifdef CRC64_HAVE_CLMUL
+            crc64_clmul_init();
+#endif
         }
         else {
             crc64_big_init();
@@ -260,13 +392,31 @@ public:
 
 static CRC64_INIT_TABLE crc64_init_table;
 
+/* Use the folding kernel when the cpu supports it and the buffer is long
+   enough to fill all lanes, the table code otherwise. */
+static uint64_t crc64_little_dispatch(uint64_t crc, void *buf, size_t len) {
+#ifdef CRC64_HAVE_CLMUL
+    if (crc64_use_clmul && len >= CRC64_CLMUL_BLOCK)
+        return crc64_little_clmul(crc, buf, len);
+#endif
+    return crc64_little(crc, buf, len);
+}
+
 uint64_t CRC64::CalcCRC(uint64_t crc, void *buf, size_t len) {
     uint64_t n = 1;
-    return *(char *)&n ? crc64_little(crc, buf, len) : crc64_big(crc, buf, len);
+    return *(char *)&n ? crc64_little_dispatch(crc, buf, len) : crc64_big(crc, buf, len);
 }
 
 uint64_t CRC64::CalcCRC(uint64_t crc, void *buf, size_t len, bool little) {
-    return little ? crc64_little(crc, buf, len) : crc64_big(crc, buf, len);
+    return little ? crc64_little_dispatch(crc, buf, len) : crc64_big(crc, buf, len);
+}
+
+bool CRC64::IsHardwareAccelerated() {
+#ifdef CRC64_HAVE_CLMUL
+    return crc64_use_clmul;
+#else
+    return false;
+#endif
 }
 
 uint64_t CRC64::CombineCRC(uint64_t crc1, uint64_t crc2, uintmax_t len2) {
@@ -1,22 +1,31 @@
 
 #include "util/file_util.h"
 
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #if defined(_WIN32)
+#include <io.h>
 #include <codecvt>
+#else
+#include <unistd.h>
 #endif
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <vector>
 
-#include "Poco/DigestStream.h"
-#include "Poco/MD5Engine.h"
-#include "Poco/StreamCopier.h"
 #include "cos_defines.h"
 #include "cos_sys_config.h"
 #include "util/codec_util.h"
 #include "util/crc64.h"
+#include "util/hash_util.h"
 #include "util/string_util.h"
 
 
@@ -72,42 +81,98 @@ std::string FileUtil::GetDirectory(const std::string& path) {
   return (path.substr(0, found));
 }
 
-uint64_t FileUtil::GetFileCrc64(const std::string& file) {
-  std::fstream f(file, std::ios::in | std::ios::binary);
-  const static int buffer_size = 2048;
-  // NOCA:VariableLengthArrays(设计如此)
-  char buffer[buffer_size];
+namespace {
+// 每个线程至少处理的数据量, 避免小文件创建过多线程
+const uint64_t kCrc64MinRangeSize = 16 * 1024 * 1024;
+// 每次读取的数据量
+const size_t kCrc64ReadBufferSize = 1024 * 1024;
+// 默认最大并发线程数
+const unsigned kCrc64MaxThreadNum = 8;
+
+// 计算文件[offset, offset + len)范围内的CRC64, read_len返回实际读取的字节数
+template <typename PathType>
+uint64_t GetFileRangeCrc64(const PathType& file, uint64_t offset, uint64_t len,
+                           uint64_t* read_len) {
+  *read_len = 0;
+  std::ifstream f(file, std::ios::in | std::ios::binary);
+  if (!f.is_open()) {
+    return 0;
+  }
+  f.seekg(offset, std::ios::beg);
+  std::unique_ptr<char[]> buffer(new char[kCrc64ReadBufferSize]);
   uint64_t crc64 = 0;
-  while (f.good()) {
-    f.read(buffer, buffer_size);
+  while (*read_len < len && f.good()) {
+    size_t to_read = static_cast<size_t>(
+        std::min<uint64_t>(kCrc64ReadBufferSize, len - *read_len));
+    f.read(buffer.get(), to_read);
     auto bytes_read = f.gcount();
-    if (bytes_read > 0) {
-      crc64 = CRC64::CalcCRC(crc64, static_cast<void*>(buffer),
-                             static_cast<size_t>(bytes_read));
+    if (bytes_read <= 0) {
+      break;
     }
+    crc64 = CRC64::CalcCRC(crc64, static_cast<void*>(buffer.get()),
+                           static_cast<size_t>(bytes_read));
+    *read_len += static_cast<uint64_t>(bytes_read);
   }
   f.close();
   return crc64;
 }
 
-#if defined(_WIN32)
-uint64_t FileUtil::GetFileCrc64(const std::wstring& file) {
-  std::fstream f(file, std::ios::in | std::ios::binary);
-  // NOCA:VariableLengthArrays(设计如此)
-  const static int buffer_size = 2048; // NOCA:runtime/arrays(ignore)
-  char buffer[buffer_size]; // NOCA:runtime/arrays(ignore)
-  uint64_t crc64 = 0;
-  while (f.good()) {
-    f.read(buffer, buffer_size);
-    auto bytes_read = f.gcount();
-    if (bytes_read > 0) {
-      crc64 = CRC64::CalcCRC(crc64, static_cast<void*>(buffer),
-                             static_cast<size_t>(bytes_read));
+// 将文件切分为多个范围, 多线程分别计算后按顺序合并
+template <typename PathType>
+uint64_t GetFileCrc64Parallel(const PathType& file, unsigned thread_num) {
+  uint64_t file_len = 0;
+  {
+    std::ifstream f(file, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!f.is_open()) {
+      return 0;
     }
+    file_len = static_cast<uint64_t>(f.tellg());
+  }
+
+  if (thread_num == 0) {
+    thread_num = std::min(std::max(std::thread::hardware_concurrency(), 1u),
+                          kCrc64MaxThreadNum);
+  }
+  uint64_t max_ranges = (file_len + kCrc64MinRangeSize - 1) / kCrc64MinRangeSize;
+  unsigned range_num = static_cast<unsigned>(
+      std::max<uint64_t>(1, std::min<uint64_t>(thread_num, max_ranges)));
+  if (range_num == 1) {
+    uint64_t read_len = 0;
+    return GetFileRangeCrc64(file, 0, file_len, &read_len);
+  }
+
+  uint64_t range_size = file_len / range_num;
+  std::vector<uint64_t> range_crc(range_num, 0);
+  std::vector<uint64_t> range_read_len(range_num, 0);
+  std::vector<std::thread> workers;
+  workers.reserve(range_num);
+  for (unsigned i = 0; i < range_num; ++i) {
+    uint64_t offset = range_size * i;
+    uint64_t len = (i == range_num - 1) ? file_len - offset : range_size;
+    workers.emplace_back([&file, &range_crc, &range_read_len, i, offset, len]() {
+      range_crc[i] = GetFileRangeCrc64(file, offset, len, &range_read_len[i]);
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  uint64_t crc64 = range_crc[0];
+  for (unsigned i = 1; i < range_num; ++i) {
+    crc64 = CRC64::CombineCRC(crc64, range_crc[i], range_read_len[i]);
   }
-  f.close();
   return crc64;
 }
+}  // namespace
+
+uint64_t FileUtil::GetFileCrc64(const std::string& file, unsigned thread_num) {
+  return GetFileCrc64Parallel(file, thread_num);
+}
+
+#if defined(_WIN32)
+uint64_t FileUtil::GetFileCrc64(const std::wstring& file, unsigned thread_num) {
+  return GetFileCrc64Parallel(file, thread_num);
+}
 
 std::wstring FileUtil::GetWideCharFilePath(const std::string file_path) {
   std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
@@ -117,12 +182,96 @@ std::wstring FileUtil::GetWideCharFilePath(const std::string file_path) {
 
 std::string FileUtil::GetFileMd5(const std::string& file) {
   std::ifstream ifs(file);
-  Poco::MD5Engine md5;
-  Poco::DigestOutputStream md5_dos(md5);
-  Poco::StreamCopier::copyStream(ifs, md5_dos);
+  std::string md5 = HashUtil::Md5Hex(ifs);
   ifs.close();
-  md5_dos.close();
-  return Poco::DigestEngine::digestToHex(md5.digest());
+  return md5;
+}
+
+bool FileUtil::WriteFileAt(int fd, const unsigned char* buf, size_t len,
+                           uint64_t offset, std::string* err_msg) {
+#if defined(_WIN32)
+  // CRT没有pwrite, seek和write需要作为整体执行
+  static std::mutex write_mutex;
+  std::lock_guard<std::mutex> lock(write_mutex);
+  if (-1 == _lseeki64(fd, offset, SEEK_SET)) {
+    if (err_msg) {
+      *err_msg = "lseek failed, ret=" + StringUtil::IntToString(errno) +
+                 ", offset=" + StringUtil::Uint64ToString(offset);
+    }
+    return false;
+  }
+#endif
+  size_t written = 0;
+  while (written < len) {
+#if defined(_WIN32)
+    int ret = _write(fd, buf + written, static_cast<unsigned>(len - written));
+#else
+    ssize_t ret = pwrite(fd, buf + written, len - written,
+                         static_cast<off_t>(offset + written));
+#endif
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (err_msg) {
+        *err_msg = "write failed, ret=" + StringUtil::IntToString(errno) +
+                   ", offset=" + StringUtil::Uint64ToString(offset) +
+                   ", len=" + StringUtil::Uint64ToString(len);
+      }
+      return false;
+    }
+    written += static_cast<size_t>(ret);
+  }
+  return true;
+}
+
+bool FileUtil::PreallocateFile(int fd, uint64_t size) {
+  if (size == 0) {
+    return true;
+  }
+#if defined(__linux__)
+  // posix_fallocate出错时直接返回错误码, 不设置errno
+  int ret = posix_fallocate(fd, 0, static_cast<off_t>(size));
+  if (ret != 0) {
+    SDK_LOG_WARN("posix_fallocate failed, ret=%d, size=%" PRIu64, ret, size);
+    return false;
+  }
+  return true;
+#else
+  (void)fd;
+  return false;
+#endif
+}
+
+bool FileUtil::NormalizeRelativePath(const std::string& path,
+                                     std::string* normalized) {
+  normalized->clear();
+  if (StringUtil::StringStartsWith(path, "\\")) {
+    return false;
+  }
+  if (path.size() >= 2 && path[1] == ':' && isalpha(static_cast<unsigned char>(path[0]))) {
+    return false;
+  }
+  size_t begin = 0;
+  while (begin <= path.size()) {
+    size_t end = path.find_first_of("/\\", begin);
+    if (end == std::string::npos) {
+      end = path.size();
+    }
+    std::string segment = path.substr(begin, end - begin);
+    begin = end + 1;
+    if (segment.empty() || segment == ".") {
+      continue;
+    }
+    if (segment == "..") {
+      return false;
+    }
+    if (!normalized->empty()) {
+      normalized->push_back('/');
+    }
+    normalized->append(segment);
+  }
+  return true;
 }
 
 }  // namespace qcloud_cos
@@ -0,0 +1,235 @@
+#include "util/hash_util.h"
+
+#include <openssl/hmac.h>
+
+#include <atomic>
+#include <vector>
+
+#include "Poco/HMACEngine.h"
+#include "Poco/SHA1Engine.h"
+#include "cos_sys_config.h"
+#include "util/codec_util.h"
+#include "util/crc64.h"
+
+namespace qcloud_cos {
+
+namespace {
+
+const size_t kMd5DigestLen = 16;
+// 计算流的MD5时每次读取的长度
+const size_t kHashReadBufSize = 64 * 1024;
+// MD5与CRC64交替计算的块大小, 需要能放进L1/L2缓存
+const size_t kFusedBlockSize = 16 * 1024;
+
+const EVP_MD* GetEvpMd(HASH_ALGORITHM algorithm) {
+  return algorithm == HASH_SHA1 ? EVP_sha1() : EVP_md5();
+}
+
+// OpenSSL不可用时只打印一次日志
+void WarnOpenSSLUnavailable(const char* what) {
+  static std::atomic<bool> warned(false);
+  if (!warned.exchange(true)) {
+    SDK_LOG_WARN("OpenSSL %s unavailable, use builtin implementation", what);
+  }
+}
+
+}  // namespace
+
+HashEngine::HashEngine(HASH_ALGORITHM algorithm)
+    : m_algorithm(algorithm),
+      m_backend(CosSysConfig::GetHashBackend()),
+      m_ctx(nullptr) {
+  Init();
+}
+
+HashEngine::HashEngine(HASH_ALGORITHM algorithm, HASH_BACKEND backend)
+    : m_algorithm(algorithm), m_backend(backend), m_ctx(nullptr) {
+  Init();
+}
+
+HashEngine::~HashEngine() {
+  if (m_ctx != nullptr) {
+    EVP_MD_CTX_destroy(m_ctx);
+  }
+}
+
+void HashEngine::Init() {
+  if (m_backend == HASH_BACKEND_OPENSSL) {
+    m_ctx = EVP_MD_CTX_create();
+    if (m_ctx == nullptr ||
+        EVP_DigestInit_ex(m_ctx, GetEvpMd(m_algorithm), nullptr) != 1) {
+      WarnOpenSSLUnavailable(m_algorithm == HASH_SHA1 ? "sha1" : "md5");
+      if (m_ctx != nullptr) {
+        EVP_MD_CTX_destroy(m_ctx);
+        m_ctx = nullptr;
+      }
+      m_backend = HASH_BACKEND_BUILTIN;
+    }
+  }
+  if (m_backend == HASH_BACKEND_BUILTIN && m_algorithm == HASH_SHA1) {
+    ShaInit(&m_sha);
+  }
+}
+
+std::size_t HashEngine::digestLength() const {
+  return m_algorithm == HASH_SHA1 ? SHA_DIGESTSIZE : kMd5DigestLen;
+}
+
+void HashEngine::reset() {
+  if (m_backend == HASH_BACKEND_OPENSSL) {
+    EVP_DigestInit_ex(m_ctx, GetEvpMd(m_algorithm), nullptr);
+  } else if (m_algorithm == HASH_SHA1) {
+    ShaInit(&m_sha);
+  } else {
+    m_md5.reset();
+  }
+}
+
+void HashEngine::updateImpl(const void* data, std::size_t length) {
+  if (m_backend == HASH_BACKEND_OPENSSL) {
+    EVP_DigestUpdate(m_ctx, data, length);
+  } else if (m_algorithm == HASH_SHA1) {
+    // ShaUpdate的长度为int, 分段输入
+    const SHA_BYTE* pos = static_cast<const SHA_BYTE*>(data);
+    const std::size_t kMaxChunk = 1 << 30;
+    while (length > 0) {
+      std::size_t n = length < kMaxChunk ? length : kMaxChunk;
+      ShaUpdate(&m_sha, const_cast<SHA_BYTE*>(pos), static_cast<int>(n));
+      pos += n;
+      length -= n;
+    }
+  } else {
+    m_md5.update(data, length);
+  }
+}
+
+const Poco::DigestEngine::Digest& HashEngine::digest() {
+  if (m_backend == HASH_BACKEND_OPENSSL) {
+    unsigned char buf[EVP_MAX_MD_SIZE];
+    unsigned int len = 0;
+    EVP_DigestFinal_ex(m_ctx, buf, &len);
+    m_digest.assign(buf, buf + len);
+    EVP_DigestInit_ex(m_ctx, GetEvpMd(m_algorithm), nullptr);
+  } else if (m_algorithm == HASH_SHA1) {
+    unsigned char buf[SHA_DIGESTSIZE];
+    ShaFinal(buf, &m_sha);
+    m_digest.assign(buf, buf + SHA_DIGESTSIZE);
+    ShaInit(&m_sha);
+  } else {
+    m_digest = m_md5.digest();
+  }
+  return m_digest;
+}
+
+std::string HashEngine::HexDigest() {
+  const Digest& result = digest();
+  return CodecUtil::DigestToHex(result.data(), result.size());
+}
+
+std::string HashUtil::Md5(const void* data, size_t len) {
+  HashEngine engine(HASH_MD5);
+  engine.update(data, len);
+  const Poco::DigestEngine::Digest& result = engine.digest();
+  return std::string(result.begin(), result.end());
+}
+
+std::string HashUtil::Md5Hex(const void* data, size_t len) {
+  HashEngine engine(HASH_MD5);
+  engine.update(data, len);
+  return engine.HexDigest();
+}
+
+std::string HashUtil::Md5Hex(std::istream& is) {
+  HashEngine engine(HASH_MD5);
+  std::vector<char> buf(kHashReadBufSize);
+  while (is.good()) {
+    is.read(&buf[0], buf.size());
+    std::streamsize n = is.gcount();
+    if (n > 0) {
+      engine.update(&buf[0], static_cast<size_t>(n));
+    }
+  }
+  return engine.HexDigest();
+}
+
+std::string HashUtil::Sha1Hex(const void* data, size_t len) {
+  HashEngine engine(HASH_SHA1);
+  engine.update(data, len);
+  return engine.HexDigest();
+}
+
+std::string HashUtil::HmacSha1(const std::string& plain_text,
+                               const std::string& key) {
+  if (CosSysConfig::GetHashBackend() == HASH_BACKEND_OPENSSL) {
+    unsigned char buf[EVP_MAX_MD_SIZE];
+    unsigned int len = 0;
+    if (HMAC(EVP_sha1(), key.data(), static_cast<int>(key.size()),
+             reinterpret_cast<const unsigned char*>(plain_text.data()),
+             plain_text.size(), buf, &len) != nullptr) {
+      return std::string(reinterpret_cast<const char*>(buf), len);
+    }
+    WarnOpenSSLUnavailable("hmac-sha1");
+  }
+  Poco::HMACEngine<Poco::SHA1Engine> hmac_engine(key);
+  hmac_engine.update(plain_text);
+  const Poco::DigestEngine::Digest& result = hmac_engine.digest();
+  return std::string(result.begin(), result.end());
+}
+
+std::string HashUtil::HmacSha1Hex(const std::string& plain_text,
+                                  const std::string& key) {
+  std::string raw = HmacSha1(plain_text, key);
+  return CodecUtil::DigestToHex(
+      reinterpret_cast<const unsigned char*>(raw.data()), raw.size());
+}
+
+void HashUtil::Md5Crc64(const void* data, size_t len, std::string* md5_hex,
+                        uint64_t* crc64) {
+  if (md5_hex == nullptr) {
+    *crc64 = CRC64::CalcCRC(0, const_cast<void*>(data), len);
+    return;
+  }
+  Md5Crc64Engine engine;
+  engine.Update(data, len);
+  *md5_hex = engine.Md5Hex();
+  *crc64 = engine.GetCrc64();
+}
+
+void HashUtil::Md5Crc64(std::istream& is, std::string* md5_hex,
+                        uint64_t* crc64) {
+  Md5Crc64Engine engine;
+  *crc64 = 0;
+  std::vector<char> buf(kHashReadBufSize);
+  while (is.good()) {
+    is.read(&buf[0], buf.size());
+    std::streamsize n = is.gcount();
+    if (n <= 0) {
+      continue;
+    }
+    if (md5_hex != nullptr) {
+      engine.Update(&buf[0], static_cast<size_t>(n));
+    } else {
+      *crc64 = CRC64::CalcCRC(*crc64, &buf[0], static_cast<size_t>(n));
+    }
+  }
+  if (md5_hex != nullptr) {
+    *md5_hex = engine.Md5Hex();
+    *crc64 = engine.GetCrc64();
+  }
+}
+
+Md5Crc64Engine::Md5Crc64Engine(uint64_t crc64)
+    : m_md5(HASH_MD5), m_crc64(crc64) {}
+
+void Md5Crc64Engine::Update(const void* data, size_t len) {
+  unsigned char* pos = static_cast<unsigned char*>(const_cast<void*>(data));
+  while (len > 0) {
+    size_t n = len < kFusedBlockSize ? len : kFusedBlockSize;
+    m_md5.update(pos, n);
+    m_crc64 = CRC64::CalcCRC(m_crc64, pos, n);
+    pos += n;
+    len -= n;
+  }
+}
+
+}  // namespace qcloud_cos
@@ -12,8 +12,6 @@
 #include <memory>
 #include <sstream>
 
-#include "Poco/DigestStream.h"
-#include "Poco/MD5Engine.h"
 #include "Poco/Net/Context.h"
 #include "Poco/Net/HTTPClientSession.h"
 #include "Poco/Net/HTTPRequest.h"
@@ -26,6 +24,9 @@
 #include "cos_defines.h"
 #include "cos_sys_config.h"
 #include "util/codec_util.h"
+#include "util/hash_util.h"
+#include "util/http_session_pool.h"
+#include "util/ssl_context_cache.h"
 #include "util/string_util.h"
 
 namespace qcloud_cos {
@@ -109,6 +110,161 @@ int CheckResponseBodyLength(const std::string& http_method, const int64_t expect
   }
   return 0;
 }
+
+// 写入目标流的同时计算MD5, 用于边接收边校验响应正文, 无需缓存整个响应
+class Md5TeeStreamBuf : public std::streambuf {
+ public:
+  explicit Md5TeeStreamBuf(std::ostream& ostr)
+      : m_md5(HASH_MD5), m_ostr(ostr) {}
+
+  std::string Md5Hex() {
+    return m_md5.HexDigest();
+  }
+
+ protected:
+  std::streamsize xsputn(const char* s, std::streamsize n) override {
+    m_md5.update(s, static_cast<std::size_t>(n));
+    m_ostr.write(s, n);
+    return m_ostr ? n : 0;
+  }
+
+  int_type overflow(int_type c) override {
+    if (traits_type::eq_int_type(c, traits_type::eof())) {
+      return traits_type::not_eof(c);
+    }
+    char ch = traits_type::to_char_type(c);
+    return xsputn(&ch, 1) == 1 ? c : traits_type::eof();
+  }
+
+ private:
+  HashEngine m_md5;
+  std::ostream& m_ostr;
+};
+
+// 连接池的key, 只有目标地址及SSL参数都相同的连接才能复用
+// HTTPS的Context不可缓存时返回空串, 连接不放回连接池
+std::string BuildSessionPoolKey(const Poco::URI& url, const std::string& ssl_ctx_key) {
+  if (url.getScheme() == "https" && ssl_ctx_key.empty()) {
+    return "";
+  }
+  std::string key = url.getScheme() + "://" + url.getHost() + ":" + std::to_string(url.getPort());
+  if (!ssl_ctx_key.empty()) {
+    key += "|" + ssl_ctx_key;
+  }
+  return key;
+}
+
+// TLS会话的key, 会话与Context及目标地址绑定
+std::string BuildTlsSessionKey(const Poco::URI& url, const std::string& ssl_ctx_key) {
+  return url.getHost() + ":" + std::to_string(url.getPort()) + "|" + ssl_ctx_key;
+}
+
+// 请求占用的连接池名额, 正常结束时由ReleaseSession归还,
+// 请求中途抛出异常时在析构中归还, 避免名额泄漏后其他请求一直等待
+class PoolSlot : private NonCopyable {
+ public:
+  explicit PoolSlot(const std::string& pool_key)
+      : m_pool_key(pool_key), m_held(false) {}
+  ~PoolSlot() { Release(HttpSessionPool::SessionPtr()); }
+
+  const std::string& GetKey() const { return m_pool_key; }
+
+  HttpSessionPool::SessionPtr Acquire() {
+    m_held = true;
+    return GetGlobalHttpSessionPool().Acquire(m_pool_key);
+  }
+
+  void Release(HttpSessionPool::SessionPtr session) {
+    if (m_held) {
+      m_held = false;
+      GetGlobalHttpSessionPool().Release(m_pool_key, std::move(session));
+    }
+  }
+
+ private:
+  std::string m_pool_key;
+  bool m_held;
+};
+
+// 开启长连接时, 从连接池中取出空闲连接, 没有则新建
+// HTTPS连接使用缓存的Context, 并尝试复用之前的TLS会话
+int AcquireSession(const Poco::URI& url, bool is_verify_cert,
+                   const std::string& ca_location,
+                   const SSLCtxCallback& ssl_ctx_cb, void* user_data,
+                   const std::string& ssl_ctx_key, PoolSlot* pool_slot,
+                   HttpSessionPool::SessionPtr* session, std::string* err_msg) {
+  if (!pool_slot->GetKey().empty()) {
+    *session = pool_slot->Acquire();
+    if (*session) {
+      SDK_LOG_DBG("reuse session of %s", pool_slot->GetKey().c_str());
+      return 0;
+    }
+  }
+
+  if (url.getScheme() == "https") {
+    int cb_ret = 0;
+    Poco::Net::Context::Ptr context = GetGlobalSslContextCache().GetContext(
+        ssl_ctx_key, is_verify_cert, ca_location, ssl_ctx_cb, user_data, &cb_ret);
+    if (context.isNull()) {
+      *err_msg = "SSL_Ctx Callback Exception Code: " + std::to_string(cb_ret);
+      return kHttpStatusNetError;
+    }
+    Poco::Net::Session::Ptr tls_session;
+    if (!ssl_ctx_key.empty()) {
+      tls_session =
+          GetGlobalSslContextCache().GetSession(BuildTlsSessionKey(url, ssl_ctx_key));
+    }
+    session->reset(new Poco::Net::HTTPSClientSession(url.getHost(), url.getPort(),
+                                                     context, tls_session));
+  } else {
+    session->reset(new Poco::Net::HTTPClientSession(url.getHost(), url.getPort()));
+  }
+
+  if (!pool_slot->GetKey().empty()) {
+    (*session)->setKeepAlive(true);
+    (*session)->setKeepAliveTimeout(
+        Poco::Timespan(CosSysConfig::GetSessionIdleTimeout(), 0));
+  }
+  return 0;
+}
+
+// 握手完成后保存TLS会话, 供后续连接复用
+void SaveTlsSession(const Poco::URI& url, const std::string& ssl_ctx_key,
+                    Poco::Net::HTTPClientSession* session) {
+  if (ssl_ctx_key.empty()) {
+    return;
+  }
+  Poco::Net::HTTPSClientSession* https_session =
+      static_cast<Poco::Net::HTTPSClientSession*>(session);
+  GetGlobalSslContextCache().SaveSession(BuildTlsSessionKey(url, ssl_ctx_key),
+                                         https_session->sslSession());
+}
+
+// 按CosSysConfig中的参数开启TCP keepalive探测, 需在连接建立后调用
+void SetTcpKeepAlive(Poco::Net::StreamSocket& ss) {
+  try {
+    ss.setKeepAlive(true);
+#if defined(TCP_KEEPIDLE) && defined(TCP_KEEPINTVL)
+    ss.setOption(IPPROTO_TCP, TCP_KEEPIDLE, static_cast<int>(CosSysConfig::GetKeepIdle()));
+    ss.setOption(IPPROTO_TCP, TCP_KEEPINTVL, static_cast<int>(CosSysConfig::GetKeepIntvl()));
+#endif
+  } catch (const std::exception& ex) {
+    SDK_LOG_WARN("set tcp keepalive fail: %s", ex.what());
+  }
+}
+
+// 归还连接池名额, 响应完整读取且服务端允许keep-alive时, 将连接放回连接池
+void ReleaseSession(PoolSlot* pool_slot, HttpSessionPool::SessionPtr session,
+                    const Poco::Net::HTTPResponse& res, const std::istream& recv_stream,
+                    int status_code) {
+  // 响应正文未读完(如写入用户流失败)的连接不能复用
+  if (status_code == kHttpStatusNetError ||
+      status_code == kHttpStatusUserCancel || !res.getKeepAlive() ||
+      !recv_stream.eof()) {
+    session.reset();
+  }
+  pool_slot->Release(std::move(session));
+}
 } // namespace
 
 int HttpSender::SendRequest(
@@ -173,27 +329,19 @@ int HttpSender::SendRequest(
   try {
     SDK_LOG_INFO("send request to [%s]", url_str.c_str());
     Poco::URI url(url_str);
-    std::unique_ptr<Poco::Net::HTTPClientSession> session;
+    std::string ssl_ctx_key;
     if (url.getScheme() == "https") {
-      bool load_default_ca = ca_location.empty();
-      Poco::Net::Context::VerificationMode verify_mode = Poco::Net::Context::VERIFY_RELAXED;
-      if (!is_verify_cert) {
-        verify_mode = Poco::Net::Context::VERIFY_NONE;
-      }
-      Poco::Net::Context::Ptr context =
-          new Poco::Net::Context(Poco::Net::Context::CLIENT_USE, "", "", ca_location,
-                                 verify_mode, 9, load_default_ca,
-                                 "ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
-      if (ssl_ctx_cb) {
-        int ret = ssl_ctx_cb(context->sslContext(), user_data);
-        if (ret != 0) {
-          *err_msg = "SSL_Ctx Callback Exception Code: " + std::to_string(ret);
-          return kHttpStatusNetError;
-        }
-      }
-      session.reset(new Poco::Net::HTTPSClientSession(url.getHost(), url.getPort(), context));
-    } else {
-      session.reset(new Poco::Net::HTTPClientSession(url.getHost(), url.getPort()));
+      ssl_ctx_key = SslContextCache::BuildContextKey(is_verify_cert, ca_location, ssl_ctx_cb, user_data);
+    }
+    std::string pool_key;
+    if (CosSysConfig::GetKeepAlive()) {
+      pool_key = BuildSessionPoolKey(url, ssl_ctx_key);
+    }
+    PoolSlot pool_slot(pool_key);
+    HttpSessionPool::SessionPtr session;
+    if (AcquireSession(url, is_verify_cert, ca_location, ssl_ctx_cb, user_data,
+                       ssl_ctx_key, &pool_slot, &session, err_msg) != 0) {
+      return kHttpStatusNetError;
     }
 
     session->setTimeout(Poco::Timespan(0, conn_timeout_in_ms * 1000));
@@ -218,6 +366,9 @@ int HttpSender::SendRequest(
     std::chrono::time_point<std::chrono::steady_clock> start_ts, end_ts;
     start_ts = std::chrono::steady_clock::now();
     std::ostream& os = session->sendRequest(req);
+    if (!pool_key.empty()) {
+      SetTcpKeepAlive(session->socket());
+    }
     std::streamsize copy_size;
     if (req_body_buf != nullptr) {
       copy_size = HandleStreamCopier::handleCopyStream(handler, req_body_buf, req_body_len, os);
@@ -231,6 +382,7 @@ int HttpSender::SendRequest(
     Poco::Net::StreamSocket& ss = session->socket();
     ss.setReceiveTimeout(Poco::Timespan(0, recv_timeout_in_ms * 1000));
     std::istream& recv_stream = session->receiveResponse(res);
+    SaveTlsSession(url, ssl_ctx_key, session.get());
 
     // 6. 处理返回
     int status_code = res.getStatus();
@@ -249,36 +401,24 @@ int HttpSender::SendRequest(
 
     if (is_check_md5 && !StringUtil::IsV4ETag(etag) && !StringUtil::IsMultipartUploadETag(etag)) {
       SDK_LOG_DBG("Check Response Md5");
-      Poco::MD5Engine md5;
-      Poco::DigestOutputStream dos(md5);
-
-      std::stringbuf ibuf;
-      std::iostream io_tmp(&ibuf);
-
-      // The Poco session->receiveResponse return the streambuf which dose not
-      // overload the base_iostream seekpos which is the realization of the
-      // tellg and seekg. It casue the recv_stream can not relocation the begin
-      // postion, so can not reuse of the recv_stream.
-      // FIXME it might has property issue.
+      // 边转发给resp_stream边计算MD5, 接收完成后再比较
+      Md5TeeStreamBuf tee_buf(resp_stream);
+      std::ostream tee_stream(&tee_buf);
       start_ts = std::chrono::steady_clock::now();
-      copy_size = Poco::StreamCopier::copyStream(recv_stream, io_tmp);
+      copy_size = HandleStreamCopier::handleCopyStream(handler, recv_stream, tee_stream);
       end_ts = std::chrono::steady_clock::now();
 
-      std::streampos pos = io_tmp.tellg();
-      Poco::StreamCopier::copyStream(io_tmp, dos);
-      io_tmp.clear();
-      io_tmp.seekg(pos);
-      dos.close();
-
-      std::string md5_str = Poco::DigestEngine::digestToHex(md5.digest());
-
-      if (etag != md5_str) {
+      std::string md5_str = tee_buf.Md5Hex();
+      if (!resp_stream) {
+          *err_msg = "Write response body to stream fail";
+          SDK_LOG_ERR("%s", err_msg->c_str());
+          status_code = kHttpStatusNetError;
+      } else if (etag != md5_str) {
           *err_msg = "Md5 of response body is not equal to the etag in the header."
                      " Body Md5= " + md5_str + ", etag=" + etag;
           SDK_LOG_ERR("Check Md5 fail, %s", err_msg->c_str());
           status_code = kHttpStatusNetError;
       }
-      HandleStreamCopier::handleCopyStream(handler, io_tmp, resp_stream);
     } else {
       int64_t content_length = GetResponseContentLength(resp_headers);
       start_ts = std::chrono::steady_clock::now();
@@ -292,6 +432,7 @@ int HttpSender::SendRequest(
 
     LogResponseMessage(resp_headers, status_code, res, *err_msg);
     SDK_LOG_INFO("Send request over, ret=%d, http_status=%d, reason=%s", status_code, res.getStatus(), res.getReason().c_str());
+    ReleaseSession(&pool_slot, std::move(session), res, recv_stream, status_code);
     return status_code;
   } catch (Poco::Net::NetException& ex) {
     SDK_LOG_ERR("Net Exception:%s", ex.displayText().c_str());
@@ -339,28 +480,19 @@ int HttpSender::SendRequest(
   try {
     SDK_LOG_INFO("send request to [%s]", url_str.c_str());
     Poco::URI url(url_str);
-    std::unique_ptr<Poco::Net::HTTPClientSession> session;
+    std::string ssl_ctx_key;
     if (url.getScheme() == "https") {
-      bool load_default_ca = ca_location.empty();
-      Poco::Net::Context::VerificationMode verify_mode = Poco::Net::Context::VERIFY_RELAXED;
-      if (!is_verify_cert) {
-        verify_mode = Poco::Net::Context::VERIFY_NONE;
-      }
-
-      Poco::Net::Context::Ptr context =
-          new Poco::Net::Context(Poco::Net::Context::CLIENT_USE, "", "", ca_location,
-                                 verify_mode, 9, load_default_ca,
-                                 "ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
-      if (ssl_ctx_cb) {
-        int ret = ssl_ctx_cb(context->sslContext(), user_data);
-        if (ret != 0) {
-          *err_msg = "SSL_Ctx Callback Exception Code: " + std::to_string(ret);
-          return kHttpStatusNetError;
-        }
-      }
-      session.reset(new Poco::Net::HTTPSClientSession(url.getHost(), url.getPort(), context));
-    } else {
-      session.reset(new Poco::Net::HTTPClientSession(url.getHost(), url.getPort()));
+      ssl_ctx_key = SslContextCache::BuildContextKey(is_verify_cert, ca_location, ssl_ctx_cb, user_data);
+    }
+    std::string pool_key;
+    if (CosSysConfig::GetKeepAlive()) {
+      pool_key = BuildSessionPoolKey(url, ssl_ctx_key);
+    }
+    PoolSlot pool_slot(pool_key);
+    HttpSessionPool::SessionPtr session;
+    if (AcquireSession(url, is_verify_cert, ca_location, ssl_ctx_cb, user_data,
+                       ssl_ctx_key, &pool_slot, &session, err_msg) != 0) {
+      return kHttpStatusNetError;
     }
     session->setTimeout(Poco::Timespan(0, conn_timeout_in_ms * 1000));
     // 1. 拼接path_query字符串
@@ -384,6 +516,9 @@ int HttpSender::SendRequest(
     std::streamsize copy_size = 0;
     // 3. 发送请求
     std::ostream& os = session->sendRequest(req);
+    if (!pool_key.empty()) {
+      SetTcpKeepAlive(session->socket());
+    }
     if (!req_body.empty()) {
       // 统计上传速率
       start_ts = std::chrono::steady_clock::now();
@@ -396,6 +531,7 @@ int HttpSender::SendRequest(
     Poco::Net::StreamSocket& ss = session->socket();
     ss.setReceiveTimeout(Poco::Timespan(0, recv_timeout_in_ms * 1000));
     std::istream& recv_stream = session->receiveResponse(res);
+    SaveTlsSession(url, ssl_ctx_key, session.get());
 
     // 6. 处理返回
     int status_code = res.getStatus();
@@ -422,37 +558,25 @@ int HttpSender::SendRequest(
       }
       if (is_check_md5 && !StringUtil::IsV4ETag(etag) && !StringUtil::IsMultipartUploadETag(etag)) {
         SDK_LOG_DBG("Check Response Md5");
-        Poco::MD5Engine md5;
-        Poco::DigestOutputStream dos(md5);
-
-        // explicit iostream (streambuf* sb);
-        std::stringbuf ibuf;
-        std::iostream io_tmp(&ibuf);
-
-        // The Poco session->receiveResponse return the streambuf which dose not
-        // overload the base_iostream seekpos which is the realization of the
-        // tellg and seekg. It casue the recv_stream can not relocation the
-        // begin postion, so can not reuse of the recv_stream.
-        // FIXME it might has property issue.
+        // 边转发给resp_stream边计算MD5, 接收完成后再比较
+        Md5TeeStreamBuf tee_buf(resp_stream);
+        std::ostream tee_stream(&tee_buf);
         start_ts = std::chrono::steady_clock::now();
-        *real_byte = Poco::StreamCopier::copyStream(recv_stream, io_tmp);
+        *real_byte = HandleStreamCopier::handleCopyStream(handler, recv_stream, tee_stream);
         end_ts = std::chrono::steady_clock::now();
 
-        std::streampos pos = io_tmp.tellg();
-        Poco::StreamCopier::copyStream(io_tmp, dos);
-        io_tmp.clear();
-        io_tmp.seekg(pos);
-        dos.close();
-        std::string md5_str = Poco::DigestEngine::digestToHex(md5.digest());
-
-        if (etag != md5_str) {
+        std::string md5_str = tee_buf.Md5Hex();
+        if (!resp_stream) {
+          *err_msg = "Write response body to stream fail, recv-len=" + StringUtil::Uint64ToString(*real_byte);
+          SDK_LOG_ERR("%s", err_msg->c_str());
+          status_code = kHttpStatusNetError;
+        } else if (etag != md5_str) {
           *err_msg = "Md5 of response body is not equal to the etag in the header. Body Md5= " + md5_str +
                       ", etag=" + etag + ", recv-len=" + StringUtil::Uint64ToString(*real_byte) +
                       ", content-length=" + std::to_string(content_length);
           SDK_LOG_ERR("Check Md5 fail, %s", err_msg->c_str());
           status_code = kHttpStatusNetError;
         }
-        HandleStreamCopier::handleCopyStream(handler, io_tmp, resp_stream);
       } else {  // other way direct use the recv_stream
         start_ts = std::chrono::steady_clock::now();
         *real_byte = HandleStreamCopier::handleCopyStream(handler, recv_stream, resp_stream);
@@ -466,6 +590,7 @@ int HttpSender::SendRequest(
 
     LogResponseMessage(resp_headers, status_code, res, *err_msg);
     SDK_LOG_INFO("Send request over, ret=%d, http_status=%d, reason=%s", status_code, res.getStatus(), res.getReason().c_str());
+    ReleaseSession(&pool_slot, std::move(session), res, recv_stream, status_code);
     return status_code;
   } catch (Poco::Net::NetException& ex) {
     SDK_LOG_ERR("Net Exception:%s", ex.displayText().c_str());
@@ -491,4 +616,128 @@ int HttpSender::SendRequest(
   }
 }
 
+int HttpSender::SendRequest(
+    const SharedTransferHandler& handler, const std::string& http_method,
+    const std::string& url_str,
+    const std::map<std::string, std::string>& req_params,
+    const std::map<std::string, std::string>& req_headers,
+    uint64_t conn_timeout_in_ms,
+    uint64_t recv_timeout_in_ms,
+    std::map<std::string, std::string>* resp_headers,
+    std::string* xml_err_str, // 响应返回非 2xx 错误码时, 传输报错响应信息
+    char* resp_buf, // 接收响应正文的缓冲区
+    size_t resp_buf_len,
+    std::string* err_msg,
+    uint64_t* real_byte, // 实际接收字节数
+    bool is_verify_cert,
+    const std::string& ca_location,
+    const SSLCtxCallback& ssl_ctx_cb,
+    void *user_data) {
+  Poco::Net::HTTPResponse res;
+  *real_byte = 0;
+  try {
+    SDK_LOG_INFO("send request to [%s]", url_str.c_str());
+    Poco::URI url(url_str);
+    std::string ssl_ctx_key;
+    if (url.getScheme() == "https") {
+      ssl_ctx_key = SslContextCache::BuildContextKey(is_verify_cert, ca_location, ssl_ctx_cb, user_data);
+    }
+    std::string pool_key;
+    if (CosSysConfig::GetKeepAlive()) {
+      pool_key = BuildSessionPoolKey(url, ssl_ctx_key);
+    }
+    PoolSlot pool_slot(pool_key);
+    HttpSessionPool::SessionPtr session;
+    if (AcquireSession(url, is_verify_cert, ca_location, ssl_ctx_cb, user_data,
+                       ssl_ctx_key, &pool_slot, &session, err_msg) != 0) {
+      return kHttpStatusNetError;
+    }
+    session->setTimeout(Poco::Timespan(0, conn_timeout_in_ms * 1000));
+    // 1. 拼接path_query字符串
+    std::string path_and_query_str = BuildRequestPathAndQueryParams(url, req_params);
+
+    // 2. 创建http request, 并填充头部
+    Poco::Net::HTTPRequest req(http_method, path_and_query_str,
+                               Poco::Net::HTTPMessage::HTTP_1_1);
+    for (auto c_itr = req_headers.begin(); c_itr != req_headers.end(); ++c_itr) {
+      req.add(c_itr->first, c_itr->second);
+    }
+
+    std::ostringstream debug_os;
+    req.write(debug_os);
+    SDK_LOG_DBG("request=[%s]", debug_os.str().c_str());
+
+    // 3. 发送请求
+    session->sendRequest(req);
+    if (!pool_key.empty()) {
+      SetTcpKeepAlive(session->socket());
+    }
+
+    // 4. 接收返回
+    Poco::Net::StreamSocket& ss = session->socket();
+    ss.setReceiveTimeout(Poco::Timespan(0, recv_timeout_in_ms * 1000));
+    std::istream& recv_stream = session->receiveResponse(res);
+    SaveTlsSession(url, ssl_ctx_key, session.get());
+
+    // 5. 处理返回
+    int status_code = res.getStatus();
+    resp_headers->insert(res.begin(), res.end());
+    // 有些代理可能会把ETag头部修改成Etag,此处修改成ETag
+    if (resp_headers->count("Etag") > 0) {
+      (*resp_headers)["ETag"] = (*resp_headers)["Etag"];
+      resp_headers->erase("Etag");
+    }
+    if (status_code != 200 && status_code != 206) {
+      *real_byte = Poco::StreamCopier::copyToString(recv_stream, *xml_err_str);
+    } else {
+      int64_t content_length = GetResponseContentLength(resp_headers);
+      if (content_length > 0 && static_cast<uint64_t>(content_length) > resp_buf_len) {
+        *err_msg = "response body exceeds buffer: content-length=" + std::to_string(content_length) +
+                   ", buffer-len=" + std::to_string(resp_buf_len);
+        SDK_LOG_ERR("Recv response fail: %s", err_msg->c_str());
+        return kHttpStatusNetError;
+      }
+      std::chrono::time_point<std::chrono::steady_clock> start_ts, end_ts;
+      start_ts = std::chrono::steady_clock::now();
+      *real_byte = HandleStreamCopier::handleCopyStream(handler, recv_stream, resp_buf, resp_buf_len);
+      end_ts = std::chrono::steady_clock::now();
+      PrintRate(start_ts, end_ts, *real_byte, "recv");
+      if (*real_byte == resp_buf_len && recv_stream.peek() != std::char_traits<char>::eof()) {
+        *err_msg = "response body exceeds buffer: buffer-len=" + std::to_string(resp_buf_len);
+        SDK_LOG_ERR("Recv response fail: %s", err_msg->c_str());
+        return kHttpStatusNetError;
+      }
+      if (CheckResponseBodyLength(http_method, content_length, *real_byte, err_msg) < 0) {
+        status_code = kHttpStatusNetError;
+      }
+    }
+
+    LogResponseMessage(resp_headers, status_code, res, *err_msg);
+    SDK_LOG_INFO("Send request over, ret=%d, http_status=%d, reason=%s", status_code, res.getStatus(), res.getReason().c_str());
+    ReleaseSession(&pool_slot, std::move(session), res, recv_stream, status_code);
+    return status_code;
+  } catch (Poco::Net::NetException& ex) {
+    SDK_LOG_ERR("Net Exception:%s", ex.displayText().c_str());
+    *err_msg = "Net Exception:" + ex.displayText();
+    return kHttpStatusNetError;
+  } catch (Poco::TimeoutException& ex) {
+    SDK_LOG_ERR("TimeoutException:%s", ex.displayText().c_str());
+    *err_msg = "TimeoutException:" + ex.displayText();
+    return kHttpStatusNetError;
+  } catch (UserCancelException& ex) {
+    SDK_LOG_INFO("Request canceled by user");
+    *err_msg = "Request canceled by user";
+    return kHttpStatusUserCancel;
+  } catch (Poco::URISyntaxException& ex) {
+    SDK_LOG_ERR("url:%s    URISyntaxException:%s", url_str.c_str(), ex.displayText().c_str());
+    *err_msg = "url:" + url_str +  "    URISyntaxException:" + ex.displayText();
+    return kHttpStatusNetError;
+  } catch (const std::exception& ex) {
+    SDK_LOG_ERR("Exception:%s, errno=%d", std::string(ex.what()).c_str(),
+                errno);
+    *err_msg = "Exception:" + std::string(ex.what());
+    return kHttpStatusNetError;
+  }
+}
+
 }  // namespace qcloud_cos
@@ -0,0 +1,199 @@
+#include "util/http_session_pool.h"
+
+#include "Poco/Net/NetException.h"
+#include "Poco/Net/Socket.h"
+#include "cos_sys_config.h"
+#include "util/log_util.h"
+
+namespace qcloud_cos {
+
+HttpSessionPool& GetGlobalHttpSessionPool() {
+  static HttpSessionPool session_pool(CosSysConfig::GetMaxIdleSessionsPerHost(),
+                                      CosSysConfig::GetSessionIdleTimeout(),
+                                      CosSysConfig::GetMaxSessionsPerHost());
+  return session_pool;
+}
+
+HttpSessionPool::HttpSessionPool(unsigned max_idle_per_host,
+                                 int64_t idle_timeout_in_s,
+                                 unsigned max_active_per_host)
+    : m_max_idle_per_host(max_idle_per_host),
+      m_max_active_per_host(max_active_per_host),
+      m_idle_timeout_in_s(idle_timeout_in_s),
+      m_last_evict_ts(std::chrono::steady_clock::now()) {}
+
+HttpSessionPool::~HttpSessionPool() { Clear(); }
+
+bool HttpSessionPool::IsHealthy(Poco::Net::HTTPClientSession* session) {
+  if (session == nullptr || !session->connected()) {
+    return false;
+  }
+  try {
+    // 空闲连接上不应该有可读数据, 可读说明对端已关闭或者状态异常
+    return !session->socket().poll(
+        Poco::Timespan(0), Poco::Net::Socket::SELECT_READ |
+                               Poco::Net::Socket::SELECT_ERROR);
+  } catch (const std::exception& ex) {
+    SDK_LOG_DBG("poll idle session fail: %s", ex.what());
+    return false;
+  }
+}
+
+void HttpSessionPool::EvictExpiredLocked(
+    const std::chrono::steady_clock::time_point& now,
+    std::deque<SessionPtr>* expired) {
+  const std::chrono::seconds idle_timeout(m_idle_timeout_in_s);
+  for (auto it = m_idle_sessions.begin(); it != m_idle_sessions.end();) {
+    IdleQueue& queue = it->second;
+    // 队列按归还时间排序, 头部最老
+    while (!queue.empty() && now - queue.front().idle_since >= idle_timeout) {
+      expired->push_back(std::move(queue.front().session));
+      queue.pop_front();
+    }
+    if (queue.empty()) {
+      it = m_idle_sessions.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  m_last_evict_ts = now;
+}
+
+HttpSessionPool::SessionPtr HttpSessionPool::Acquire(const std::string& key) {
+  std::deque<SessionPtr> discarded;
+  SessionPtr session;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_active_cond.wait(lock, [this, &key]() {
+      if (m_max_active_per_host == 0) {
+        return true;
+      }
+      auto active_it = m_active_counts.find(key);
+      return active_it == m_active_counts.end() ||
+             active_it->second < m_max_active_per_host;
+    });
+    ++m_active_counts[key];
+
+    auto it = m_idle_sessions.find(key);
+    if (it == m_idle_sessions.end()) {
+      return session;
+    }
+    const std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    const std::chrono::seconds idle_timeout(m_idle_timeout_in_s);
+    IdleQueue& queue = it->second;
+    // 优先使用最近归还的连接, 其对端关闭的概率最小
+    while (!queue.empty()) {
+      IdleSession idle = std::move(queue.back());
+      queue.pop_back();
+      if (now - idle.idle_since < idle_timeout &&
+          IsHealthy(idle.session.get())) {
+        session = std::move(idle.session);
+        break;
+      }
+      discarded.push_back(std::move(idle.session));
+    }
+    if (queue.empty()) {
+      m_idle_sessions.erase(it);
+    }
+  }
+
+  if (!discarded.empty()) {
+    SDK_LOG_DBG("discard %zu stale sessions of %s", discarded.size(),
+                key.c_str());
+  }
+  return session;
+}
+
+void HttpSessionPool::Release(const std::string& key, SessionPtr session) {
+  std::deque<SessionPtr> discarded;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto active_it = m_active_counts.find(key);
+    if (active_it != m_active_counts.end()) {
+      if (--active_it->second == 0) {
+        m_active_counts.erase(active_it);
+      }
+      m_active_cond.notify_all();
+    }
+
+    if (!session) {
+      return;
+    }
+    if (m_max_idle_per_host == 0) {
+      discarded.push_back(std::move(session));
+    } else {
+      const std::chrono::steady_clock::time_point now =
+          std::chrono::steady_clock::now();
+      if (now - m_last_evict_ts >= std::chrono::seconds(m_idle_timeout_in_s)) {
+        EvictExpiredLocked(now, &discarded);
+      }
+      IdleQueue& queue = m_idle_sessions[key];
+      while (queue.size() >= m_max_idle_per_host) {
+        discarded.push_back(std::move(queue.front().session));
+        queue.pop_front();
+      }
+      IdleSession idle;
+      idle.session = std::move(session);
+      idle.idle_since = now;
+      queue.push_back(std::move(idle));
+    }
+  }
+  // discarded在锁外析构, 避免关闭连接时阻塞其他线程
+}
+
+void HttpSessionPool::Clear() {
+  std::map<std::string, IdleQueue> sessions;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    sessions.swap(m_idle_sessions);
+  }
+}
+
+size_t HttpSessionPool::GetIdleCount() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  size_t count = 0;
+  for (const auto& item : m_idle_sessions) {
+    count += item.second.size();
+  }
+  return count;
+}
+
+size_t HttpSessionPool::GetIdleCount(const std::string& key) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_idle_sessions.find(key);
+  return it == m_idle_sessions.end() ? 0 : it->second.size();
+}
+
+size_t HttpSessionPool::GetActiveCount(const std::string& key) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_active_counts.find(key);
+  return it == m_active_counts.end() ? 0 : it->second;
+}
+
+void HttpSessionPool::SetMaxIdlePerHost(unsigned max_idle_per_host) {
+  std::deque<SessionPtr> discarded;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_max_idle_per_host = max_idle_per_host;
+  for (auto& item : m_idle_sessions) {
+    while (item.second.size() > m_max_idle_per_host) {
+      discarded.push_back(std::move(item.second.front().session));
+      item.second.pop_front();
+    }
+  }
+}
+
+void HttpSessionPool::SetMaxActivePerHost(unsigned max_active_per_host) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_max_active_per_host = max_active_per_host;
+  }
+  m_active_cond.notify_all();
+}
+
+void HttpSessionPool::SetIdleTimeout(int64_t idle_timeout_in_s) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_idle_timeout_in_s = idle_timeout_in_s;
+}
+
+}  // namespace qcloud_cos
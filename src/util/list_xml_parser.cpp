@@ -0,0 +1,597 @@
+#include "util/list_xml_parser.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cos_sys_config.h"
+#include "util/string_util.h"
+
+namespace qcloud_cos {
+
+namespace {
+
+enum ListXmlElement {
+  kElemUnknown = 0,
+  kElemRoot,
+  kElemContents,
+  kElemVersion,
+  kElemDeleteMarker,
+  kElemCommonPrefixes,
+  kElemKey,
+  kElemLastModified,
+  kElemETag,
+  kElemSize,
+  kElemStorageClass,
+  kElemStorageTier,
+  kElemRestoreStatus,
+  kElemVersionId,
+  kElemIsLatest,
+  kElemOwner,
+  kElemId,
+  kElemDisplayName,
+  kElemPrefix,
+  kElemIsTruncated,
+  kElemNextMarker,
+  kElemNextKeyMarker,
+  kElemNextVersionIdMarker,
+};
+
+struct ElementName {
+  const char* name;
+  size_t len;
+  ListXmlElement element;
+};
+
+#define LIST_XML_ELEMENT(name, element) {name, sizeof(name) - 1, element}
+
+// 按出现频率排列, 条目内的字段在前
+const ElementName kElementNames[] = {
+    LIST_XML_ELEMENT("Key", kElemKey),
+    LIST_XML_ELEMENT("LastModified", kElemLastModified),
+    LIST_XML_ELEMENT("ETag", kElemETag),
+    LIST_XML_ELEMENT("Size", kElemSize),
+    LIST_XML_ELEMENT("StorageClass", kElemStorageClass),
+    LIST_XML_ELEMENT("Owner", kElemOwner),
+    LIST_XML_ELEMENT("ID", kElemId),
+    LIST_XML_ELEMENT("DisplayName", kElemDisplayName),
+    LIST_XML_ELEMENT("Contents", kElemContents),
+    LIST_XML_ELEMENT("Version", kElemVersion),
+    LIST_XML_ELEMENT("VersionId", kElemVersionId),
+    LIST_XML_ELEMENT("IsLatest", kElemIsLatest),
+    LIST_XML_ELEMENT("DeleteMarker", kElemDeleteMarker),
+    LIST_XML_ELEMENT("StorageTier", kElemStorageTier),
+    LIST_XML_ELEMENT("RestoreStatus", kElemRestoreStatus),
+    LIST_XML_ELEMENT("CommonPrefixes", kElemCommonPrefixes),
+    LIST_XML_ELEMENT("Prefix", kElemPrefix),
+    LIST_XML_ELEMENT("IsTruncated", kElemIsTruncated),
+    LIST_XML_ELEMENT("NextMarker", kElemNextMarker),
+    LIST_XML_ELEMENT("NextKeyMarker", kElemNextKeyMarker),
+    LIST_XML_ELEMENT("NextVersionIdMarker", kElemNextVersionIdMarker),
+    LIST_XML_ELEMENT("ListBucketResult", kElemRoot),
+    LIST_XML_ELEMENT("ListVersionsResult", kElemRoot),
+};
+
+#undef LIST_XML_ELEMENT
+
+// 实体引用的最大长度, 如&#x10FFFF
+const size_t kMaxEntityLen = 10;
+
+int LookupElement(const char* name, size_t len) {
+  for (size_t i = 0; i < sizeof(kElementNames) / sizeof(kElementNames[0]);
+       ++i) {
+    if (kElementNames[i].len == len &&
+        memcmp(kElementNames[i].name, name, len) == 0) {
+      return kElementNames[i].element;
+    }
+  }
+  return kElemUnknown;
+}
+
+bool IsEntryElement(int element) {
+  return element == kElemContents || element == kElemVersion ||
+         element == kElemDeleteMarker;
+}
+
+bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+void AppendUtf8(uint32_t code_point, std::string* out) {
+  if (code_point < 0x80) {
+    out->push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    out->push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    out->push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    out->push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+bool ParseDigits(const char* str, size_t len, int* value) {
+  int result = 0;
+  for (size_t i = 0; i < len; ++i) {
+    if (str[i] < '0' || str[i] > '9') {
+      return false;
+    }
+    result = result * 10 + (str[i] - '0');
+  }
+  *value = result;
+  return true;
+}
+
+bool ParseUint64(const std::string& str, uint64_t* value) {
+  if (str.empty()) {
+    return false;
+  }
+  uint64_t result = 0;
+  for (size_t i = 0; i < str.size(); ++i) {
+    if (str[i] < '0' || str[i] > '9') {
+      return false;
+    }
+    result = result * 10 + static_cast<uint64_t>(str[i] - '0');
+  }
+  *value = result;
+  return true;
+}
+
+// 公历日期到1970-01-01的天数
+int64_t DaysFromCivil(int64_t y, int64_t m, int64_t d) {
+  y -= m <= 2 ? 1 : 0;
+  const int64_t era = (y >= 0 ? y : y - 399) / 400;
+  const int64_t yoe = y - era * 400;
+  const int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+void CivilFromDays(int64_t z, int* y, int* m, int* d) {
+  z += 719468;
+  const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  const int64_t doe = z - era * 146097;
+  const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const int64_t mp = (5 * doy + 2) / 153;
+  *d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+  *m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+  *y = static_cast<int>(yoe + era * 400 + (*m <= 2 ? 1 : 0));
+}
+
+}  // namespace
+
+void ListEntry::ToContent(Content* content) const {
+  content->m_key = key;
+  content->m_last_modified = ListXmlParser::FormatIso8601Ms(last_modified_ms);
+  content->m_etag = etag;
+  content->m_size = StringUtil::Uint64ToString(size);
+  content->m_owner_ids.clear();
+  if (!owner_id.empty()) {
+    content->m_owner_ids.push_back(owner_id);
+  }
+  content->m_storage_class = storage_class;
+  content->m_storage_tier = storage_tier;
+  content->m_restore_status = restore_status;
+}
+
+void ListEntry::ToVersionSummary(COSVersionSummary* summary) const {
+  summary->m_is_delete_marker = is_delete_marker;
+  summary->m_etag = etag;
+  summary->m_size = size;
+  summary->m_storage_class = storage_class;
+  summary->m_is_latest = is_latest;
+  summary->m_key = key;
+  summary->m_last_modified = ListXmlParser::FormatIso8601Ms(last_modified_ms);
+  summary->m_owner.m_id = owner_id;
+  summary->m_owner.m_display_name = owner_display_name;
+  summary->m_version_id = version_id;
+}
+
+ListXmlParser::ListXmlParser(ListXmlHandler* handler)
+    : m_handler(handler),
+      m_state(kStateText),
+      m_failed(false),
+      m_root_closed(false) {}
+
+void ListXmlParser::Reset() {
+  m_state = kStateText;
+  m_failed = false;
+  m_root_closed = false;
+  m_err_msg.clear();
+  m_tag.clear();
+  m_text.clear();
+  m_entity.clear();
+  m_elements.clear();
+  m_entry.Clear();
+  m_page_info = ListPageInfo();
+  m_handler->OnReset();
+}
+
+void ListXmlParser::SetError(const std::string& err_msg) {
+  if (!m_failed) {
+    m_failed = true;
+    m_err_msg = err_msg;
+    SDK_LOG_ERR("Parse list result fail, %s", err_msg.c_str());
+  }
+}
+
+bool ListXmlParser::Feed(const char* data, size_t len) {
+  if (m_failed) {
+    return false;
+  }
+  const char* p = data;
+  const char* end = data + len;
+  while (p < end) {
+    if (m_state == kStateTag) {
+      const char* gt = static_cast<const char*>(memchr(p, '>', end - p));
+      if (gt == NULL) {
+        m_tag.append(p, end);
+        break;
+      }
+      m_tag.append(p, gt);
+      p = gt + 1;
+      m_state = kStateText;
+      if (!HandleTag()) {
+        return false;
+      }
+      m_tag.clear();
+    } else if (m_state == kStateEntity) {
+      const char* semi = static_cast<const char*>(memchr(p, ';', end - p));
+      if (semi == NULL) {
+        m_entity.append(p, end);
+        if (m_entity.size() > kMaxEntityLen) {
+          SetError("entity too long");
+          return false;
+        }
+        break;
+      }
+      m_entity.append(p, semi);
+      p = semi + 1;
+      m_state = kStateText;
+      if (!DecodeEntity()) {
+        return false;
+      }
+    } else {
+      // 文本中只需关注<和&, 其余字符成段追加
+      const char* q = p;
+      while (q < end && *q != '<' && *q != '&') {
+        ++q;
+      }
+      m_text.append(p, q);
+      p = q;
+      if (p < end) {
+        m_state = (*p == '<') ? kStateTag : kStateEntity;
+        m_entity.clear();
+        ++p;
+      }
+    }
+  }
+  return true;
+}
+
+bool ListXmlParser::Finish() {
+  if (m_failed) {
+    return false;
+  }
+  if (!m_root_closed || m_state != kStateText) {
+    SetError("incomplete list result");
+    return false;
+  }
+  return true;
+}
+
+bool ListXmlParser::DecodeEntity() {
+  const std::string& e = m_entity;
+  if (e == "lt") {
+    m_text.push_back('<');
+  } else if (e == "gt") {
+    m_text.push_back('>');
+  } else if (e == "amp") {
+    m_text.push_back('&');
+  } else if (e == "quot") {
+    m_text.push_back('"');
+  } else if (e == "apos") {
+    m_text.push_back('\'');
+  } else if (e.size() > 1 && e[0] == '#') {
+    uint32_t code_point = 0;
+    bool hex = (e[1] == 'x' || e[1] == 'X');
+    size_t begin = hex ? 2 : 1;
+    if (begin >= e.size()) {
+      SetError("invalid entity &" + e + ";");
+      return false;
+    }
+    for (size_t i = begin; i < e.size(); ++i) {
+      char c = e[i];
+      uint32_t digit = 0;
+      if (c >= '0' && c <= '9') {
+        digit = c - '0';
+      } else if (hex && c >= 'a' && c <= 'f') {
+        digit = c - 'a' + 10;
+      } else if (hex && c >= 'A' && c <= 'F') {
+        digit = c - 'A' + 10;
+      } else {
+        SetError("invalid entity &" + e + ";");
+        return false;
+      }
+      code_point = code_point * (hex ? 16 : 10) + digit;
+      if (code_point > 0x10FFFF) {
+        SetError("invalid entity &" + e + ";");
+        return false;
+      }
+    }
+    AppendUtf8(code_point, &m_text);
+  } else {
+    SetError("unknown entity &" + e + ";");
+    return false;
+  }
+  return true;
+}
+
+bool ListXmlParser::HandleTag() {
+  if (m_tag.empty()) {
+    SetError("empty tag");
+    return false;
+  }
+  // 声明、注释等直接忽略
+  if (m_tag[0] == '?' || m_tag[0] == '!') {
+    m_text.clear();
+    return true;
+  }
+  if (m_root_closed) {
+    SetError("element after root element");
+    return false;
+  }
+
+  if (m_tag[0] == '/') {
+    size_t len = 1;
+    while (len < m_tag.size() && !IsSpace(m_tag[len])) {
+      ++len;
+    }
+    int element = LookupElement(m_tag.data() + 1, len - 1);
+    if (m_elements.empty() || m_elements.back() != element) {
+      SetError("unexpected end tag <" + m_tag + ">");
+      return false;
+    }
+    HandleEndElement(element);
+    m_elements.pop_back();
+    if (m_elements.empty()) {
+      m_root_closed = true;
+    }
+    m_text.clear();
+    return true;
+  }
+
+  bool self_closing = (m_tag[m_tag.size() - 1] == '/');
+  size_t len = 0;
+  while (len < m_tag.size() && !IsSpace(m_tag[len]) && m_tag[len] != '/') {
+    ++len;
+  }
+  int element = LookupElement(m_tag.data(), len);
+  if (m_elements.empty() && element != kElemRoot) {
+    SetError("unexpected root element <" + m_tag + ">");
+    return false;
+  }
+  m_elements.push_back(element);
+  m_text.clear();
+  HandleStartElement(element);
+  if (self_closing) {
+    HandleEndElement(element);
+    m_elements.pop_back();
+    if (m_elements.empty()) {
+      m_root_closed = true;
+    }
+  }
+  return true;
+}
+
+void ListXmlParser::HandleStartElement(int element) {
+  if (m_elements.size() == 2 && IsEntryElement(element)) {
+    m_entry.Clear();
+    m_entry.is_delete_marker = (element == kElemDeleteMarker);
+  }
+}
+
+void ListXmlParser::HandleEndElement(int element) {
+  const size_t depth = m_elements.size();
+  if (depth == 2) {
+    switch (element) {
+      case kElemContents:
+      case kElemVersion:
+      case kElemDeleteMarker:
+        m_handler->OnEntry(m_entry);
+        break;
+      case kElemIsTruncated:
+        m_page_info.is_truncated = (m_text == "true");
+        break;
+      case kElemNextMarker:
+        m_page_info.next_marker = m_text;
+        break;
+      case kElemNextKeyMarker:
+        m_page_info.next_key_marker = m_text;
+        break;
+      case kElemNextVersionIdMarker:
+        m_page_info.next_version_id_marker = m_text;
+        break;
+      default:
+        break;
+    }
+    return;
+  }
+
+  if (depth == 3 && m_elements[1] == kElemCommonPrefixes) {
+    if (element == kElemPrefix) {
+      m_handler->OnCommonPrefix(m_text);
+    }
+    return;
+  }
+
+  if (depth == 3 && IsEntryElement(m_elements[1])) {
+    switch (element) {
+      case kElemKey:
+        m_entry.key = m_text;
+        break;
+      case kElemLastModified:
+        if (!ParseIso8601Ms(m_text, &m_entry.last_modified_ms)) {
+          SDK_LOG_WARN("Invalid LastModified %s, key=%s", m_text.c_str(),
+                       m_entry.key.c_str());
+        }
+        break;
+      case kElemETag: {
+        size_t begin = 0;
+        size_t end = m_text.size();
+        while (begin < end && m_text[begin] == '"') {
+          ++begin;
+        }
+        while (end > begin && m_text[end - 1] == '"') {
+          --end;
+        }
+        m_entry.etag.assign(m_text, begin, end - begin);
+        break;
+      }
+      case kElemSize:
+        if (!ParseUint64(m_text, &m_entry.size)) {
+          SDK_LOG_WARN("Invalid Size %s, key=%s", m_text.c_str(),
+                       m_entry.key.c_str());
+        }
+        break;
+      case kElemStorageClass:
+        m_entry.storage_class = m_text;
+        break;
+      case kElemStorageTier:
+        m_entry.storage_tier = m_text;
+        break;
+      case kElemRestoreStatus:
+        m_entry.restore_status = m_text;
+        break;
+      case kElemVersionId:
+        m_entry.version_id = m_text;
+        break;
+      case kElemIsLatest:
+        m_entry.is_latest = (m_text == "true");
+        break;
+      default:
+        break;
+    }
+    return;
+  }
+
+  if (depth == 4 && IsEntryElement(m_elements[1]) &&
+      m_elements[2] == kElemOwner) {
+    if (element == kElemId) {
+      m_entry.owner_id = m_text;
+    } else if (element == kElemDisplayName) {
+      m_entry.owner_display_name = m_text;
+    }
+  }
+}
+
+bool ListXmlParser::ParseIso8601Ms(const std::string& str, int64_t* ms) {
+  // YYYY-MM-DDTHH:MM:SS[.fff]Z
+  if (str.size() < 20 || str[4] != '-' || str[7] != '-' || str[10] != 'T' ||
+      str[13] != ':' || str[16] != ':' || str[str.size() - 1] != 'Z') {
+    return false;
+  }
+  const char* s = str.c_str();
+  int year = 0;
+  int month = 0;
+  int day = 0;
+  int hour = 0;
+  int minute = 0;
+  int second = 0;
+  int millis = 0;
+  if (!ParseDigits(s, 4, &year) || !ParseDigits(s + 5, 2, &month) ||
+      !ParseDigits(s + 8, 2, &day) || !ParseDigits(s + 11, 2, &hour) ||
+      !ParseDigits(s + 14, 2, &minute) || !ParseDigits(s + 17, 2, &second)) {
+    return false;
+  }
+  if (str.size() > 20) {
+    // 小数部分按毫秒截断
+    if (str[19] != '.') {
+      return false;
+    }
+    size_t frac_len = str.size() - 21;
+    int frac = 0;
+    if (frac_len == 0 || !ParseDigits(s + 20, frac_len < 3 ? frac_len : 3, &frac)) {
+      return false;
+    }
+    for (size_t i = frac_len; i < 3; ++i) {
+      frac *= 10;
+    }
+    millis = frac;
+  }
+  if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 ||
+      minute > 59 || second > 60) {
+    return false;
+  }
+  int64_t days = DaysFromCivil(year, month, day);
+  *ms = ((days * 24 + hour) * 60 + minute) * 60000 +
+        static_cast<int64_t>(second) * 1000 + millis;
+  return true;
+}
+
+std::string ListXmlParser::FormatIso8601Ms(int64_t ms) {
+  int64_t days = ms >= 0 ? ms / 86400000 : (ms - 86399999) / 86400000;
+  int64_t ms_of_day = ms - days * 86400000;
+  int year = 0;
+  int month = 0;
+  int day = 0;
+  CivilFromDays(days, &year, &month, &day);
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ", year, month,
+           day, static_cast<int>(ms_of_day / 3600000),
+           static_cast<int>(ms_of_day / 60000 % 60),
+           static_cast<int>(ms_of_day / 1000 % 60),
+           static_cast<int>(ms_of_day % 1000));
+  return buf;
+}
+
+ListXmlStreamBuf::int_type ListXmlStreamBuf::overflow(int_type ch) {
+  if (traits_type::eq_int_type(ch, traits_type::eof())) {
+    return traits_type::not_eof(ch);
+  }
+  char c = traits_type::to_char_type(ch);
+  if (!m_parser->Feed(&c, 1)) {
+    return traits_type::eof();
+  }
+  ++m_pos;
+  return ch;
+}
+
+std::streamsize ListXmlStreamBuf::xsputn(const char* data,
+                                         std::streamsize len) {
+  if (!m_parser->Feed(data, static_cast<size_t>(len))) {
+    return 0;
+  }
+  m_pos += len;
+  return len;
+}
+
+ListXmlStreamBuf::pos_type ListXmlStreamBuf::seekoff(
+    off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) {
+  if (dir == std::ios_base::cur && off == 0) {
+    return pos_type(m_pos);
+  }
+  if (dir == std::ios_base::beg) {
+    return seekpos(pos_type(off), which);
+  }
+  return pos_type(off_type(-1));
+}
+
+ListXmlStreamBuf::pos_type ListXmlStreamBuf::seekpos(
+    pos_type pos, std::ios_base::openmode which) {
+  (void)which;
+  // 只支持回到起点, 用于请求重试
+  if (pos != pos_type(0)) {
+    return pos_type(off_type(-1));
+  }
+  m_parser->Reset();
+  m_pos = 0;
+  return pos;
+}
+
+}  // namespace qcloud_cos
@@ -0,0 +1,293 @@
+#include "util/select_event_decoder.h"
+
+#include <map>
+
+#include "cos_sys_config.h"
+#include "rapidxml/1.13/rapidxml.hpp"
+#include "util/string_util.h"
+
+namespace qcloud_cos {
+
+namespace {
+
+const size_t kPreludeLen = 12;  // total_byte_len + header_byte_len + CRC32
+const size_t kMessageCrcLen = 4;
+// 每条消息至少包含:message-type和:event-type两个header
+const uint32_t kMinHeaderLen = 40;
+const uint32_t kMinTotalLen = kPreludeLen + kMinHeaderLen + kMessageCrcLen;
+const char kHeaderValueTypeString = 7;
+
+uint64_t GetChildUint64(rapidxml::xml_node<>* root, const char* name) {
+  rapidxml::xml_node<>* node = root->first_node(name);
+  if (node == nullptr) {
+    return 0;
+  }
+  return StringUtil::StringToUint64(node->value());
+}
+
+// 解析<Progress>/<Stats>事件中的字节数统计
+void ParseProgress(const char* payload, size_t payload_len,
+                   SelectProgress* progress) {
+  progress->payload.assign(payload, payload_len);
+  std::string xml = progress->payload;
+  rapidxml::xml_document<> doc;
+  if (!StringUtil::StringToXml(&xml[0], &doc)) {
+    SDK_LOG_ERR("Parse select progress fail, payload=%s",
+                progress->payload.c_str());
+    return;
+  }
+  rapidxml::xml_node<>* root = doc.first_node();
+  if (root == nullptr) {
+    return;
+  }
+  progress->bytes_scanned = GetChildUint64(root, "BytesScanned");
+  progress->bytes_processed = GetChildUint64(root, "BytesProcessed");
+  progress->bytes_returned = GetChildUint64(root, "BytesReturned");
+}
+
+}  // namespace
+
+SelectEventDecoder::SelectEventDecoder(SelectEventHandler* handler)
+    : m_handler(handler) {
+  Reset();
+}
+
+void SelectEventDecoder::Reset() {
+  m_message.clear();
+  m_total_len = 0;
+  m_header_len = 0;
+  m_message_crc = Poco::Checksum();
+  m_crc_pos = 0;
+  m_end = false;
+  m_failed = false;
+  m_stopped = false;
+  m_delivered = false;
+  m_err_msg.clear();
+  m_error_code.clear();
+  m_error_message.clear();
+}
+
+void SelectEventDecoder::SetError(const std::string& err_msg) {
+  SDK_LOG_ERR("Decode select response fail, %s", err_msg.c_str());
+  m_failed = true;
+  m_err_msg = err_msg;
+}
+
+bool SelectEventDecoder::Feed(const char* data, size_t len) {
+  while (len > 0) {
+    if (m_failed || m_stopped) {
+      return false;
+    }
+    if (m_end) {
+      return true;
+    }
+
+    size_t want = (m_total_len == 0 ? kPreludeLen : m_total_len) -
+                  m_message.size();
+    size_t n = len < want ? len : want;
+    m_message.append(data, n);
+    data += n;
+    len -= n;
+
+    if (m_total_len == 0) {
+      if (m_message.size() < kPreludeLen || !ParsePrelude()) {
+        continue;
+      }
+    }
+
+    // 消息CRC覆盖除最后4字节外的全部数据, 随数据到达增量计算
+    size_t crc_end = m_message.size() < m_total_len - kMessageCrcLen
+                         ? m_message.size()
+                         : m_total_len - kMessageCrcLen;
+    if (crc_end > m_crc_pos) {
+      m_message_crc.update(m_message.data() + m_crc_pos,
+                           static_cast<unsigned int>(crc_end - m_crc_pos));
+      m_crc_pos = crc_end;
+    }
+
+    if (m_message.size() == m_total_len) {
+      HandleMessage();
+      m_message.clear();
+      m_total_len = 0;
+      m_header_len = 0;
+      m_message_crc = Poco::Checksum();
+      m_crc_pos = 0;
+    }
+  }
+  return !m_failed && !m_stopped;
+}
+
+bool SelectEventDecoder::ParsePrelude() {
+  const char* prelude = m_message.data();
+  uint32_t total_len = StringUtil::GetUint32FromStrWithBigEndian(prelude);
+  uint32_t header_len = StringUtil::GetUint32FromStrWithBigEndian(prelude + 4);
+
+  Poco::Checksum prelude_crc;
+  prelude_crc.update(prelude, 8);
+  uint32_t crc_expect = StringUtil::GetUint32FromStrWithBigEndian(prelude + 8);
+  if (prelude_crc.checksum() != crc_expect) {
+    SetError("prelude crc check fail, crc=" +
+             StringUtil::Uint64ToString(prelude_crc.checksum()) +
+             ", expected=" + StringUtil::Uint64ToString(crc_expect));
+    return false;
+  }
+  if (total_len < kMinTotalLen) {
+    SetError("invalid total_byte_length:" +
+             StringUtil::Uint64ToString(total_len));
+    return false;
+  }
+  if (header_len < kMinHeaderLen ||
+      header_len > total_len - kPreludeLen - kMessageCrcLen) {
+    SetError("invalid header_byte_length:" +
+             StringUtil::Uint64ToString(header_len));
+    return false;
+  }
+  m_total_len = total_len;
+  m_header_len = header_len;
+  m_message.reserve(total_len);
+  return true;
+}
+
+bool SelectEventDecoder::HandleMessage() {
+  uint32_t crc_expect = StringUtil::GetUint32FromStrWithBigEndian(
+      m_message.data() + m_total_len - kMessageCrcLen);
+  if (m_message_crc.checksum() != crc_expect) {
+    SetError("message crc check fail, crc=" +
+             StringUtil::Uint64ToString(m_message_crc.checksum()) +
+             ", expected=" + StringUtil::Uint64ToString(crc_expect));
+    return false;
+  }
+
+  // header = name_len(1 byte) + name + value_type(1 byte) +
+  //          value_len(2 byte) + value
+  std::map<std::string, std::string> headers;
+  const char* header = m_message.data() + kPreludeLen;
+  size_t cursor = 0;
+  while (cursor < m_header_len) {
+    size_t name_len = static_cast<unsigned char>(header[cursor]);
+    ++cursor;
+    if (cursor + name_len + 3 > m_header_len) {
+      SetError("invalid header, header_byte_length:" +
+               StringUtil::Uint64ToString(m_header_len));
+      return false;
+    }
+    std::string name(header + cursor, name_len);
+    cursor += name_len;
+    if (header[cursor] != kHeaderValueTypeString) {
+      SetError("invalid header value type:" +
+               StringUtil::IntToString(header[cursor]) + ", expect 7");
+      return false;
+    }
+    ++cursor;
+    size_t value_len = StringUtil::GetUint16FromStrWithBigEndian(header + cursor);
+    cursor += 2;
+    if (cursor + value_len > m_header_len) {
+      SetError("invalid header value length:" +
+               StringUtil::Uint64ToString(value_len));
+      return false;
+    }
+    headers[name].assign(header + cursor, value_len);
+    cursor += value_len;
+  }
+
+  const std::string& message_type = headers[":message-type"];
+  if (message_type == "event") {
+    const char* payload = header + m_header_len;
+    size_t payload_len =
+        m_total_len - kPreludeLen - m_header_len - kMessageCrcLen;
+    return HandleEvent(headers[":event-type"], headers[":content-type"],
+                       payload, payload_len);
+  }
+  if (message_type == "error") {
+    m_error_code = headers[":error-code"];
+    m_error_message = headers[":error-message"];
+    SetError("error-code:" + m_error_code + ", error-message:" + m_error_message);
+    return false;
+  }
+  if (message_type.empty()) {
+    SetError("no message type in header");
+  } else {
+    SetError("unknown message type:" + message_type);
+  }
+  return false;
+}
+
+bool SelectEventDecoder::HandleEvent(const std::string& event_type,
+                                     const std::string& content_type,
+                                     const char* payload, size_t payload_len) {
+  if (event_type == "Records") {
+    m_delivered = true;
+    if (!m_handler->OnRecords(payload, payload_len, content_type)) {
+      SDK_LOG_INFO("Select records handler requires to stop");
+      m_stopped = true;
+      return false;
+    }
+  } else if (event_type == "Progress" || event_type == "Stats") {
+    SelectProgress progress;
+    ParseProgress(payload, payload_len, &progress);
+    progress.content_type = content_type;
+    m_delivered = true;
+    if (event_type == "Progress") {
+      m_handler->OnProgress(progress);
+    } else {
+      m_handler->OnStats(progress);
+    }
+  } else if (event_type == "End") {
+    SDK_LOG_DBG("Get event End, finish decoding select response");
+    m_end = true;
+    m_delivered = true;
+    m_handler->OnEnd();
+  } else if (event_type == "Cont") {
+    SDK_LOG_DBG("Get event Continue");
+  } else {
+    SetError("invalid event:" + event_type);
+    return false;
+  }
+  return true;
+}
+
+SelectEventStreamBuf::int_type SelectEventStreamBuf::overflow(int_type ch) {
+  if (traits_type::eq_int_type(ch, traits_type::eof())) {
+    return traits_type::not_eof(ch);
+  }
+  char c = traits_type::to_char_type(ch);
+  if (!m_decoder->Feed(&c, 1)) {
+    return traits_type::eof();
+  }
+  ++m_pos;
+  return ch;
+}
+
+std::streamsize SelectEventStreamBuf::xsputn(const char* data,
+                                             std::streamsize len) {
+  if (!m_decoder->Feed(data, static_cast<size_t>(len))) {
+    return 0;
+  }
+  m_pos += len;
+  return len;
+}
+
+SelectEventStreamBuf::pos_type SelectEventStreamBuf::seekoff(
+    off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) {
+  if (dir == std::ios_base::cur && off == 0) {
+    return pos_type(m_pos);
+  }
+  if (dir == std::ios_base::beg) {
+    return seekpos(pos_type(off), which);
+  }
+  return pos_type(off_type(-1));
+}
+
+SelectEventStreamBuf::pos_type SelectEventStreamBuf::seekpos(
+    pos_type pos, std::ios_base::openmode which) {
+  (void)which;
+  // 只支持在回调任何事件之前回到起点, 用于请求重试
+  if (pos != pos_type(0) || m_decoder->HasDelivered()) {
+    return pos_type(off_type(-1));
+  }
+  m_decoder->Reset();
+  m_pos = 0;
+  return pos;
+}
+
+}  // namespace qcloud_cos
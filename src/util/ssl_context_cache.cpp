@@ -0,0 +1,120 @@
+#include "util/ssl_context_cache.h"
+
+#include <sstream>
+
+#include "cos_sys_config.h"
+
+namespace qcloud_cos {
+
+SslContextCache& GetGlobalSslContextCache() {
+  static SslContextCache ssl_context_cache(64, 1000);
+  return ssl_context_cache;
+}
+
+SslContextCache::SslContextCache(unsigned max_context_size,
+                                 unsigned max_session_size)
+    : m_contexts(max_context_size), m_max_session_size(max_session_size) {
+  m_sessions = std::make_shared<LruCache<std::string, Poco::Net::Session::Ptr>>(
+      m_max_session_size);
+}
+
+SslContextCache::~SslContextCache() {}
+
+std::string SslContextCache::BuildContextKey(bool is_verify_cert,
+                                             const std::string& ca_location,
+                                             const SSLCtxCallback& ssl_ctx_cb,
+                                             void* user_data) {
+  std::ostringstream oss;
+  oss << is_verify_cert << "|" << ca_location << "|";
+  if (ssl_ctx_cb) {
+    // 普通函数按地址区分; 同一类型的lambda/仿函数可能捕获不同的证书等状态,
+    // 无法从类型区分, 不参与缓存
+    typedef int (*SSLCtxFunc)(void*, void*);
+    const SSLCtxFunc* func = ssl_ctx_cb.target<SSLCtxFunc>();
+    if (func == nullptr) {
+      return "";
+    }
+    oss << reinterpret_cast<const void*>(*func) << "|" << user_data;
+  }
+  return oss.str();
+}
+
+Poco::Net::Context::Ptr SslContextCache::GetContext(
+    const std::string& context_key, bool is_verify_cert,
+    const std::string& ca_location, const SSLCtxCallback& ssl_ctx_cb,
+    void* user_data, int* cb_ret) {
+  *cb_ret = 0;
+  if (!context_key.empty()) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_contexts.Exist(context_key)) {
+      return m_contexts.Get(context_key);
+    }
+  }
+
+  // 加载CA证书及执行用户回调较慢, 不持锁, 并发未命中时可能重复创建
+  bool load_default_ca = ca_location.empty();
+  Poco::Net::Context::VerificationMode verify_mode =
+      Poco::Net::Context::VERIFY_RELAXED;
+  if (!is_verify_cert) {
+    verify_mode = Poco::Net::Context::VERIFY_NONE;
+  }
+  Poco::Net::Context::Ptr context = new Poco::Net::Context(
+      Poco::Net::Context::CLIENT_USE, "", "", ca_location, verify_mode, 9,
+      load_default_ca, "ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+  // 开启客户端会话缓存, 配合HTTPSClientSession::sslSession()实现会话复用
+  context->enableSessionCache(true);
+  if (ssl_ctx_cb) {
+    *cb_ret = ssl_ctx_cb(context->sslContext(), user_data);
+    if (*cb_ret != 0) {
+      return nullptr;
+    }
+  }
+  if (context_key.empty()) {
+    return context;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_contexts.Exist(context_key)) {
+    // 其他线程已先放入, 统一使用缓存中的Context, 使TLS会话可以复用
+    return m_contexts.Get(context_key);
+  }
+  m_contexts.Put(context_key, context);
+  SDK_LOG_DBG("create ssl context, total: %zu", m_contexts.Size());
+  return context;
+}
+
+Poco::Net::Session::Ptr SslContextCache::GetSession(
+    const std::string& session_key) {
+  SharedSessionCache sessions;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    sessions = m_sessions;
+  }
+  try {
+    return sessions->Get(session_key);
+  } catch (const std::exception&) {
+    return nullptr;
+  }
+}
+
+void SslContextCache::SaveSession(const std::string& session_key,
+                                  Poco::Net::Session::Ptr session) {
+  if (session.isNull()) {
+    return;
+  }
+  SharedSessionCache sessions;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    sessions = m_sessions;
+  }
+  sessions->Put(session_key, session);
+}
+
+void SslContextCache::Clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_contexts.Clear();
+  m_sessions = std::make_shared<LruCache<std::string, Poco::Net::Session::Ptr>>(
+      m_max_session_size);
+}
+
+}  // namespace qcloud_cos
@@ -0,0 +1,225 @@
+#include "util/transfer_worker_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+#include "cos_sys_config.h"
+
+namespace qcloud_cos {
+
+TransferWorkerPool& GetGlobalTransferWorkerPool() {
+  static TransferWorkerPool worker_pool(
+      CosSysConfig::GetTransferWorkerPoolSize());
+  return worker_pool;
+}
+
+TransferWorkerPool::Group::Group(TransferWorkerPool& pool,
+                                 unsigned max_concurrency)
+    : m_pool(pool),
+      m_max_concurrency(max_concurrency < 1 ? 1 : max_concurrency),
+      m_running(0) {
+  m_pool.Register(this);
+}
+
+TransferWorkerPool::Group::~Group() {
+  JoinAll();
+  m_pool.Unregister(this);
+}
+
+void TransferWorkerPool::Group::Start(Poco::Runnable& runnable) {
+  m_pool.Submit(this, &runnable);
+}
+
+void TransferWorkerPool::Group::JoinAll() {
+  std::unique_lock<std::mutex> lock(m_pool.m_mutex);
+  m_done_cond.wait(lock,
+                   [this]() { return m_pending.empty() && m_running == 0; });
+}
+
+size_t TransferWorkerPool::Group::DispatchableLocked() const {
+  if (m_running >= m_max_concurrency) {
+    return 0;
+  }
+  return std::min(m_pending.size(),
+                  static_cast<size_t>(m_max_concurrency - m_running));
+}
+
+TransferWorkerPool::TransferWorkerPool(unsigned max_workers)
+    : m_next_group(0),
+      m_max_workers(max_workers < 1 ? 1 : max_workers),
+      m_live_workers(0),
+      m_busy_workers(0),
+      m_stop(false) {}
+
+TransferWorkerPool::~TransferWorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_work_cond.notify_all();
+  for (auto& worker : m_workers) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+void TransferWorkerPool::SetMaxWorkers(unsigned max_workers) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_max_workers = max_workers < 1 ? 1 : max_workers;
+    SpawnWorkersLocked();
+  }
+  // 唤醒空闲线程, 超出上限的线程自行退出
+  m_work_cond.notify_all();
+}
+
+unsigned TransferWorkerPool::GetMaxWorkers() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_max_workers;
+}
+
+size_t TransferWorkerPool::GetWorkerCount() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_live_workers;
+}
+
+void TransferWorkerPool::Register(Group* group) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_groups.push_back(group);
+}
+
+void TransferWorkerPool::Unregister(Group* group) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = std::find(m_groups.begin(), m_groups.end(), group);
+  if (it != m_groups.end()) {
+    m_groups.erase(it);
+  }
+}
+
+void TransferWorkerPool::Submit(Group* group, Poco::Runnable* runnable) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    group->m_pending.push_back(runnable);
+    if (group->DispatchableLocked() == 0) {
+      // 组内并发已满, 等组内任务结束后再派发
+      return;
+    }
+    SpawnWorkersLocked();
+  }
+  m_work_cond.notify_one();
+}
+
+TransferWorkerPool::Group* TransferWorkerPool::PickGroupLocked() {
+  const size_t group_num = m_groups.size();
+  for (size_t i = 0; i < group_num; ++i) {
+    size_t index = (m_next_group + i) % group_num;
+    Group* group = m_groups[index];
+    if (group->DispatchableLocked() > 0) {
+      // 下次从下一个组开始选取
+      m_next_group = (index + 1) % group_num;
+      return group;
+    }
+  }
+  return nullptr;
+}
+
+void TransferWorkerPool::ReapWorkersLocked() {
+  for (const std::thread::id& id : m_exited_workers) {
+    auto it = std::find_if(
+        m_workers.begin(), m_workers.end(),
+        [&id](const std::thread& worker) { return worker.get_id() == id; });
+    if (it != m_workers.end()) {
+      // 退出的线程登记后即释放锁返回, 持锁join不会阻塞
+      it->join();
+      m_workers.erase(it);
+    }
+  }
+  m_exited_workers.clear();
+}
+
+void TransferWorkerPool::SpawnWorkersLocked() {
+  if (m_stop) {
+    return;
+  }
+  ReapWorkersLocked();
+  size_t dispatchable = 0;
+  for (const Group* group : m_groups) {
+    dispatchable += group->DispatchableLocked();
+  }
+  // 已唤醒但还未取到任务的线程也计为空闲, 避免连续提交时只唤醒同一个线程
+  while (m_live_workers < m_max_workers &&
+         m_live_workers - m_busy_workers < dispatchable) {
+    m_workers.emplace_back(&TransferWorkerPool::WorkerLoop, this);
+    ++m_live_workers;
+  }
+}
+
+void TransferWorkerPool::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    Group* group = nullptr;
+    m_work_cond.wait(lock, [this, &group]() {
+      if (m_stop || m_live_workers > m_max_workers) {
+        return true;
+      }
+      group = PickGroupLocked();
+      return group != nullptr;
+    });
+    if (group == nullptr) {
+      // 线程池销毁或线程数上限调小, 上限调小时由后续补充线程时回收
+      --m_live_workers;
+      if (!m_stop) {
+        m_exited_workers.push_back(std::this_thread::get_id());
+      }
+      return;
+    }
+
+    Poco::Runnable* runnable = group->m_pending.front();
+    group->m_pending.pop_front();
+    ++group->m_running;
+    ++m_busy_workers;
+    lock.unlock();
+
+    try {
+      runnable->run();
+    } catch (const std::exception& ex) {
+      SDK_LOG_ERR("transfer task throw exception: %s", ex.what());
+    } catch (...) {
+      SDK_LOG_ERR("transfer task throw unknown exception");
+    }
+
+    lock.lock();
+    --m_busy_workers;
+    --group->m_running;
+    if (group->m_pending.empty() && group->m_running == 0) {
+      group->m_done_cond.notify_all();
+    }
+  }
+}
+
+void RunFileWorkers(size_t worker_num, size_t count,
+                    const std::function<void(size_t index)>& fn) {
+  std::atomic<size_t> next_index(0);
+  auto worker = [&]() {
+    while (true) {
+      size_t index = next_index.fetch_add(1);
+      if (index >= count) {
+        return;
+      }
+      fn(index);
+    }
+  };
+  worker_num = std::min(worker_num, count);
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < worker_num; ++i) {
+    workers.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : workers) {
+    t.join();
+  }
+}
+
+}  // namespace qcloud_cos
@@ -0,0 +1,438 @@
+// Copyright (c) 2017, Tencent Inc.
+// All rights reserved.
+//
+// Description: 传输调度、列出解析、签名、摘要计算相关的性能基准测试, 只输出耗时统计, 不作为正确性判断依据
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <map>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "Poco/Runnable.h"
+#include "gtest/gtest.h"
+#include "cos_sys_config.h"
+#include "response/bucket_resp.h"
+#include "util/auth_tool.h"
+#include "util/completion_queue.h"
+#include "util/crc64.h"
+#include "util/hash_util.h"
+#include "util/list_xml_parser.h"
+#include "util/task.h"
+#include "util/transfer_worker_pool.h"
+
+namespace qcloud_cos {
+
+namespace {
+
+typedef std::chrono::steady_clock BenchClock;
+
+const unsigned kBenchPoolSize = 64;
+const unsigned kBenchTaskNum = 20000;
+
+// 模拟一个分块传输任务: 短暂工作后标记完成, 并记录完成时刻
+class BenchTask : public Poco::Runnable {
+ public:
+  BenchTask() : m_queue(nullptr), m_slot(0), m_work_us(0) {}
+
+  void run() override {
+    std::this_thread::sleep_for(std::chrono::microseconds(m_work_us));
+    m_finish_time = BenchClock::now();
+    m_task_info.status = TaskStatus::TASK_COMPLETED;
+    if (m_queue != nullptr) {
+      m_queue->push(m_slot);
+    } else {
+      {
+        std::lock_guard<std::mutex> lock(*m_mutex);
+        ++*m_count;
+      }
+      m_cond->notify_one();
+    }
+  }
+
+  CompletionQueue* m_queue;
+  // 基线方式使用的计数信号量
+  std::mutex* m_mutex;
+  std::condition_variable* m_cond;
+  unsigned* m_count;
+
+  unsigned m_slot;
+  unsigned m_work_us;
+  TaskInfo m_task_info;
+  BenchClock::time_point m_finish_time;
+};
+
+struct TurnaroundStats {
+  double p50_us;
+  double p99_us;
+  double total_ms;
+};
+
+TurnaroundStats Summarize(std::vector<double>* latencies, double total_ms) {
+  TurnaroundStats stats;
+  std::sort(latencies->begin(), latencies->end());
+  stats.p50_us = (*latencies)[latencies->size() / 2];
+  stats.p99_us = (*latencies)[latencies->size() * 99 / 100];
+  stats.total_ms = total_ms;
+  return stats;
+}
+
+double ElapsedUs(const BenchClock::time_point& from,
+                 const BenchClock::time_point& to) {
+  return std::chrono::duration<double, std::micro>(to - from).count();
+}
+
+// 完成队列: 取出完成的槽位后立即补充新任务
+TurnaroundStats RunWithCompletionQueue(std::vector<BenchTask>* tasks) {
+  TransferWorkerPool pool(kBenchPoolSize);
+  TransferWorkerPool::Group group(pool, kBenchPoolSize);
+  CompletionQueue done_queue;
+  std::vector<double> latencies;
+  latencies.reserve(kBenchTaskNum);
+
+  BenchClock::time_point begin = BenchClock::now();
+  unsigned started = 0;
+  for (unsigned i = 0; i < kBenchPoolSize; ++i) {
+    BenchTask& task = (*tasks)[i];
+    task.m_queue = &done_queue;
+    task.m_slot = i;
+    task.m_work_us = 50 + (i % 8) * 25;
+    task.m_task_info.status = TaskStatus::TASK_RUNNING;
+    group.Start(task);
+    ++started;
+  }
+  unsigned finished = 0;
+  std::vector<unsigned> idle_slots;
+  while (finished < kBenchTaskNum) {
+    // 与滑动窗口调度一致: 阻塞取出一个, 再取出其间完成的其他槽位
+    idle_slots.push_back(done_queue.pop());
+    unsigned slot = 0;
+    while (done_queue.try_pop(&slot)) {
+      idle_slots.push_back(slot);
+    }
+    finished += static_cast<unsigned>(idle_slots.size());
+    while (!idle_slots.empty()) {
+      BenchTask& task = (*tasks)[idle_slots.back()];
+      idle_slots.pop_back();
+      if (started < kBenchTaskNum) {
+        // 提交后任务线程会改写m_finish_time, 需在提交前记录
+        latencies.push_back(ElapsedUs(task.m_finish_time, BenchClock::now()));
+        task.m_task_info.status = TaskStatus::TASK_RUNNING;
+        group.Start(task);
+        ++started;
+      }
+    }
+  }
+  group.JoinAll();
+  double total_ms =
+      std::chrono::duration<double, std::milli>(BenchClock::now() - begin)
+          .count();
+  return Summarize(&latencies, total_ms);
+}
+
+// 基线: 等待信号量唤醒后扫描全部槽位, 处理已完成的任务再统一补充
+TurnaroundStats RunWithSlotScan(std::vector<BenchTask>* tasks) {
+  TransferWorkerPool pool(kBenchPoolSize);
+  TransferWorkerPool::Group group(pool, kBenchPoolSize);
+  std::mutex mutex;
+  std::condition_variable cond;
+  unsigned count = 0;
+  std::vector<double> latencies;
+  latencies.reserve(kBenchTaskNum);
+
+  BenchClock::time_point begin = BenchClock::now();
+  unsigned started = 0;
+  for (unsigned i = 0; i < kBenchPoolSize; ++i) {
+    BenchTask& task = (*tasks)[i];
+    task.m_queue = nullptr;
+    task.m_mutex = &mutex;
+    task.m_cond = &cond;
+    task.m_count = &count;
+    task.m_slot = i;
+    task.m_work_us = 50 + (i % 8) * 25;
+    task.m_task_info.status = TaskStatus::TASK_RUNNING;
+    group.Start(task);
+    ++started;
+  }
+  unsigned finished = 0;
+  std::vector<unsigned> idle_slots;
+  while (finished < kBenchTaskNum) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cond.wait(lock, [&count]() { return count > 0; });
+      count = 0;
+    }
+    for (unsigned i = 0; i < kBenchPoolSize; ++i) {
+      if ((*tasks)[i].m_task_info.status == TaskStatus::TASK_COMPLETED) {
+        (*tasks)[i].m_task_info.status = TaskStatus::TASK_IDLE;
+        idle_slots.push_back(i);
+        ++finished;
+      }
+    }
+    while (!idle_slots.empty()) {
+      BenchTask& task = (*tasks)[idle_slots.back()];
+      idle_slots.pop_back();
+      if (started < kBenchTaskNum) {
+        // 提交后任务线程会改写m_finish_time, 需在提交前记录
+        latencies.push_back(ElapsedUs(task.m_finish_time, BenchClock::now()));
+        task.m_task_info.status = TaskStatus::TASK_RUNNING;
+        group.Start(task);
+        ++started;
+      }
+    }
+  }
+  group.JoinAll();
+  double total_ms =
+      std::chrono::duration<double, std::milli>(BenchClock::now() - begin)
+          .count();
+  return Summarize(&latencies, total_ms);
+}
+
+const unsigned kBenchListKeys = 1000;
+const unsigned kBenchListPages = 200;
+// 模拟从连接中每次读取的数据长度
+const size_t kBenchRecvChunk = 16 * 1024;
+
+// 生成一页1000个key的GetBucket响应
+std::string MakeListBucketBody() {
+  std::string body = "<?xml version='1.0' encoding='utf-8' ?>\n<ListBucketResult>";
+  body += "<Name>benchbucket-1250000000</Name><Prefix>logs/</Prefix><Marker/>";
+  body += "<MaxKeys>1000</MaxKeys><IsTruncated>true</IsTruncated>";
+  body += "<NextMarker>logs/2024/05/20/object_000999.log</NextMarker>";
+  for (unsigned i = 0; i < kBenchListKeys; ++i) {
+    char key[64];
+    snprintf(key, sizeof(key), "logs/2024/05/20/object_%06u.log", i);
+    body += "<Contents><Key>";
+    body += key;
+    body += "</Key><LastModified>2024-05-20T06:42:19.000Z</LastModified>";
+    body += "<ETag>&quot;3be03ea31c1d6ce899f419c04cbf1ea9&quot;</ETag>";
+    body += "<Size>" + std::to_string(1024 * (i + 1)) + "</Size>";
+    body += "<Owner><ID>1250000000</ID><DisplayName>1250000000</DisplayName>";
+    body += "</Owner><StorageClass>STANDARD</StorageClass></Contents>";
+  }
+  body += "</ListBucketResult>";
+  return body;
+}
+
+class CountListHandler : public ListXmlHandler {
+ public:
+  CountListHandler() : m_count(0), m_total_size(0) {}
+  void OnEntry(const ListEntry& entry) override {
+    ++m_count;
+    m_total_size += entry.size;
+  }
+  uint64_t m_count;
+  uint64_t m_total_size;
+};
+
+const unsigned kBenchSignNum = 100000;
+
+// 一个UploadPart请求签名所需的头部和参数
+void MakeSignRequest(std::map<std::string, std::string>* headers,
+                     std::map<std::string, std::string>* params) {
+  (*headers)["Host"] = "examplebucket-1250000000.cos.ap-guangzhou.myqcloud.com";
+  (*headers)["Content-Type"] = "application/octet-stream";
+  (*headers)["Content-Length"] = "1048576";
+  (*headers)["Content-MD5"] = "1B2M2Y8AsgTpgAmY7PhCfg==";
+  (*headers)["User-Agent"] = "cos-cpp-sdk-v5";
+  (*headers)["x-cos-traffic-limit"] = "819200";
+  (*params)["partNumber"] = "1";
+  (*params)["uploadId"] =
+      "1585130821cbb7df1d11846c073ad648e8f33b087cec2381df437acdc833cf654b9ecc6361";
+}
+
+// 返回每秒的签名次数, key_time_changes为true时每次签名使用不同的key-time
+double RunSign(bool key_time_changes) {
+  std::map<std::string, std::string> headers;
+  std::map<std::string, std::string> params;
+  MakeSignRequest(&headers, &params);
+  std::unordered_set<std::string> not_sign_headers;
+  uint64_t start_time = 1700000000;
+  size_t total_len = 0;
+  BenchClock::time_point begin = BenchClock::now();
+  for (unsigned i = 0; i < kBenchSignNum; ++i) {
+    if (key_time_changes) {
+      ++start_time;
+    }
+    total_len += AuthTool::Sign("AKIDexample", "secret_key_example", "PUT",
+                                "/dir/object.bin", headers, params,
+                                start_time, start_time + 60, not_sign_headers)
+                     .size();
+  }
+  double seconds = std::chrono::duration<double>(BenchClock::now() - begin)
+                       .count();
+  EXPECT_GT(total_len, 0u);
+  return kBenchSignNum / seconds;
+}
+
+const size_t kBenchHashBytes = 64 * 1024 * 1024;
+// 与分块上传的读取粒度一致
+const size_t kBenchHashChunk = 1024 * 1024;
+const unsigned kBenchHmacNum = 200000;
+
+const char* HashBackendName(HASH_BACKEND backend) {
+  return backend == HASH_BACKEND_OPENSSL ? "openssl" : "builtin";
+}
+
+// 返回每秒处理的MB数
+double RunHash(HASH_ALGORITHM algorithm, HASH_BACKEND backend,
+               const std::string& data) {
+  HashEngine engine(algorithm, backend);
+  BenchClock::time_point begin = BenchClock::now();
+  for (size_t pos = 0; pos < data.size(); pos += kBenchHashChunk) {
+    engine.update(data.data() + pos,
+                  std::min(kBenchHashChunk, data.size() - pos));
+  }
+  EXPECT_FALSE(engine.HexDigest().empty());
+  double seconds = std::chrono::duration<double>(BenchClock::now() - begin)
+                       .count();
+  return data.size() / seconds / (1024 * 1024);
+}
+
+// 分块上传的part大小, 超过LLC才能体现内存带宽的差异
+const size_t kBenchPartBytes = 64 * 1024 * 1024;
+const unsigned kBenchPartNum = 8;
+
+// 返回每秒处理的MB数
+double RunMd5Crc64(bool fused, const std::string& data) {
+  std::string md5_hex;
+  uint64_t crc64 = 0;
+  BenchClock::time_point begin = BenchClock::now();
+  for (unsigned i = 0; i < kBenchPartNum; ++i) {
+    if (fused) {
+      HashUtil::Md5Crc64(data.data(), data.size(), &md5_hex, &crc64);
+    } else {
+      md5_hex = HashUtil::Md5Hex(data.data(), data.size());
+      crc64 = CRC64::CalcCRC(0, const_cast<char*>(data.data()), data.size());
+    }
+  }
+  double seconds = std::chrono::duration<double>(BenchClock::now() - begin)
+                       .count();
+  EXPECT_EQ(32u, md5_hex.size());
+  return static_cast<double>(data.size()) * kBenchPartNum / seconds /
+         (1024 * 1024);
+}
+
+void PrintStats(const char* name, const TurnaroundStats& stats) {
+  std::cout << name << ": slot turnaround p50=" << stats.p50_us
+            << "us p99=" << stats.p99_us << "us, total=" << stats.total_ms
+            << "ms" << std::endl;
+}
+
+}  // namespace
+
+TEST(SchedulerBenchmarkTest, SlotTurnaround) {
+  std::cout << "pool_size=" << kBenchPoolSize << ", task_num=" << kBenchTaskNum
+            << std::endl;
+  {
+    std::vector<BenchTask> tasks(kBenchPoolSize);
+    TurnaroundStats stats = RunWithSlotScan(&tasks);
+    PrintStats("semaphore + slot scan", stats);
+    EXPECT_GT(stats.total_ms, 0);
+  }
+  {
+    std::vector<BenchTask> tasks(kBenchPoolSize);
+    TurnaroundStats stats = RunWithCompletionQueue(&tasks);
+    PrintStats("completion queue", stats);
+    EXPECT_GT(stats.total_ms, 0);
+  }
+}
+
+TEST(ListParseBenchmarkTest, GetBucketPage) {
+  const std::string body = MakeListBucketBody();
+  std::cout << "page_size=" << body.size() << "B, keys=" << kBenchListKeys
+            << ", pages=" << kBenchListPages << std::endl;
+
+  // 现有方式: 整个响应正文构建DOM后拷贝到Content, 并保存正文
+  uint64_t dom_count = 0;
+  BenchClock::time_point begin = BenchClock::now();
+  for (unsigned i = 0; i < kBenchListPages; ++i) {
+    GetBucketResp resp;
+    resp.ParseFromXmlString(body);
+    resp.SetBody(body);
+    dom_count += resp.GetContents().size();
+  }
+  double dom_ms = std::chrono::duration<double, std::milli>(
+                      BenchClock::now() - begin).count();
+
+  // 流式解析: 按接收块输入, 每个条目直接回调
+  CountListHandler handler;
+  begin = BenchClock::now();
+  for (unsigned i = 0; i < kBenchListPages; ++i) {
+    ListXmlParser parser(&handler);
+    for (size_t pos = 0; pos < body.size(); pos += kBenchRecvChunk) {
+      parser.Feed(body.data() + pos, std::min(kBenchRecvChunk, body.size() - pos));
+    }
+    EXPECT_TRUE(parser.Finish());
+  }
+  double stream_ms = std::chrono::duration<double, std::milli>(
+                         BenchClock::now() - begin).count();
+
+  std::cout << "rapidxml dom: " << dom_ms / kBenchListPages << "ms/page"
+            << std::endl;
+  std::cout << "streaming parser: " << stream_ms / kBenchListPages
+            << "ms/page" << std::endl;
+  EXPECT_EQ(dom_count, handler.m_count);
+}
+
+TEST(SignBenchmarkTest, SignaturesPerSecond) {
+  std::cout << "sign_num=" << kBenchSignNum << std::endl;
+  // 同一秒内的请求使用相同的key-time, sign_key命中缓存
+  std::cout << "same key-time: " << RunSign(false) << " signs/s" << std::endl;
+  // 每次key-time都不同, 每次都需要重新派生sign_key
+  std::cout << "new key-time per sign: " << RunSign(true) << " signs/s"
+            << std::endl;
+}
+
+TEST(HashBenchmarkTest, Backends) {
+  std::string data(kBenchHashBytes, '\0');
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<char>((i * 131 + 7) & 0xff);
+  }
+  std::cout << "data_size=" << kBenchHashBytes << "B, hmac_num=" << kBenchHmacNum
+            << std::endl;
+  const HASH_BACKEND backends[] = {HASH_BACKEND_BUILTIN, HASH_BACKEND_OPENSSL};
+  for (HASH_BACKEND backend : backends) {
+    std::cout << HashBackendName(backend)
+              << " md5: " << RunHash(HASH_MD5, backend, data) << "MB/s, sha1: "
+              << RunHash(HASH_SHA1, backend, data) << "MB/s";
+
+    // 签名中的HMAC-SHA1, 输入很短, 主要是初始化开销
+    CosSysConfig::SetHashBackend(backend);
+    const std::string string_to_sign =
+        "sha1\n1700000000;1700000060\n"
+        "a9993e364706816aba3e25717850c26c9cd0d89d\n";
+    size_t total_len = 0;
+    BenchClock::time_point begin = BenchClock::now();
+    for (unsigned i = 0; i < kBenchHmacNum; ++i) {
+      total_len += HashUtil::HmacSha1Hex(string_to_sign, "sign_key").size();
+    }
+    double seconds = std::chrono::duration<double>(BenchClock::now() - begin)
+                         .count();
+    std::cout << ", hmac-sha1: " << kBenchHmacNum / seconds << " ops/s"
+              << std::endl;
+    EXPECT_EQ(kBenchHmacNum * 40u, total_len);
+  }
+  CosSysConfig::SetHashBackend(HASH_BACKEND_OPENSSL);
+}
+
+TEST(HashBenchmarkTest, Md5Crc64) {
+  std::string data(kBenchPartBytes, '\0');
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<char>((i * 131 + 7) & 0xff);
+  }
+  std::cout << "part_size=" << kBenchPartBytes << "B, part_num=" << kBenchPartNum
+            << ", crc64_hw=" << CRC64::IsHardwareAccelerated() << std::endl;
+  std::cout << "two pass: " << RunMd5Crc64(false, data) << "MB/s" << std::endl;
+  std::cout << "fused: " << RunMd5Crc64(true, data) << "MB/s" << std::endl;
+}
+
+}  // namespace qcloud_cos
@@ -5,6 +5,9 @@
 // Created: 08/23/17
 // Description:
 
+#include <algorithm>
+#include <sstream>
+
 #include "cos_api.h"
 #include "util/test_utils.h"
 #include "util/string_util.h"
@@ -500,6 +503,122 @@ TEST_F(BucketOpTest, GetBucketTest) {
   sleep(1);
 }
 
+TEST_F(BucketOpTest, ParallelGetBucketTest) {
+  // 添加多级前缀的Object
+  std::vector<std::string> keys;
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      keys.push_back("parallel_list/dir" + StringUtil::IntToString(i) +
+                     "/obj" + StringUtil::IntToString(j));
+    }
+  }
+  keys.push_back("parallel_list/obj");
+  for (size_t i = 0; i < keys.size(); ++i) {
+    std::istringstream iss(keys[i]);
+    PutObjectByStreamReq req(m_bucket_name, keys[i], iss);
+    PutObjectByStreamResp resp;
+    CosResult result = m_client->PutObject(req, &resp);
+    ASSERT_TRUE(result.IsSucc());
+  }
+  std::sort(keys.begin(), keys.end());
+
+  // 有序输出与GetBucket结果一致
+  {
+    ParallelGetBucketReq req(m_bucket_name, "parallel_list/");
+    req.SetOrdered(true);
+    req.SetConcurrency(4);
+    std::vector<std::string> listed;
+    CosResult result = m_client->ParallelGetBucket(
+        req, [&listed](const std::vector<Content>& contents) {
+          for (size_t i = 0; i < contents.size(); ++i) {
+            listed.push_back(contents[i].m_key);
+          }
+          return true;
+        });
+    ASSERT_TRUE(result.IsSucc());
+    EXPECT_EQ(keys, listed);
+  }
+
+  // 无序输出
+  {
+    ParallelGetBucketReq req(m_bucket_name, "parallel_list/");
+    std::vector<std::string> listed;
+    CosResult result = m_client->ParallelGetBucket(
+        req, [&listed](const std::vector<Content>& contents) {
+          for (size_t i = 0; i < contents.size(); ++i) {
+            listed.push_back(contents[i].m_key);
+          }
+          return true;
+        });
+    ASSERT_TRUE(result.IsSucc());
+    std::sort(listed.begin(), listed.end());
+    EXPECT_EQ(keys, listed);
+  }
+
+  // 回调返回false时停止列出
+  {
+    ParallelGetBucketReq req(m_bucket_name, "parallel_list/");
+    int callback_times = 0;
+    CosResult result = m_client->ParallelGetBucket(
+        req, [&callback_times](const std::vector<Content>&) {
+          ++callback_times;
+          return false;
+        });
+    ASSERT_TRUE(result.IsSucc());
+    EXPECT_EQ(1, callback_times);
+  }
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    DeleteObjectReq req(m_bucket_name, keys[i]);
+    DeleteObjectResp resp;
+    CosResult result = m_client->DeleteObject(req, &resp);
+    EXPECT_TRUE(result.IsSucc());
+  }
+}
+
+TEST_F(BucketOpTest, ParallelGetBucketSplitTest) {
+  // 单个前缀下超过1000个对象时会按页拆分继续列出
+  std::vector<std::string> keys;
+  for (int i = 0; i < 1100; ++i) {
+    keys.push_back("parallel_split/dir0/obj" + StringUtil::IntToString(i));
+  }
+  for (int i = 0; i < 10; ++i) {
+    keys.push_back("parallel_split/dir1/obj" + StringUtil::IntToString(i));
+    keys.push_back("parallel_split/obj" + StringUtil::IntToString(i));
+  }
+  for (size_t i = 0; i < keys.size(); ++i) {
+    std::istringstream iss(keys[i]);
+    PutObjectByStreamReq req(m_bucket_name, keys[i], iss);
+    PutObjectByStreamResp resp;
+    CosResult result = m_client->PutObject(req, &resp);
+    ASSERT_TRUE(result.IsSucc());
+  }
+  std::sort(keys.begin(), keys.end());
+
+  // 缓存上限远小于对象数时仍按序完整输出
+  {
+    ParallelGetBucketReq req(m_bucket_name, "parallel_split/");
+    req.SetOrdered(true);
+    req.SetConcurrency(4);
+    req.SetMaxBufferedKeys(100);
+    std::vector<std::string> listed;
+    CosResult result = m_client->ParallelGetBucket(
+        req, [&listed](const std::vector<Content>& contents) {
+          for (size_t i = 0; i < contents.size(); ++i) {
+            listed.push_back(contents[i].m_key);
+          }
+          return true;
+        });
+    ASSERT_TRUE(result.IsSucc());
+    EXPECT_EQ(keys, listed);
+  }
+
+  DeleteObjectsByPrefixReq del_req(m_bucket_name, "parallel_split/");
+  DeleteObjectsByPrefixResp del_resp;
+  CosResult del_result = m_client->DeleteObjects(del_req, &del_resp);
+  EXPECT_TRUE(del_result.IsSucc());
+}
+
 TEST_F(BucketOpTest, PutBucketVersioningTest) {
   PutBucketVersioningReq req(m_bucket_name);
   PutBucketVersioningResp resp;
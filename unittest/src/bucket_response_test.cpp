@@ -1,7 +1,12 @@
+#include <algorithm>
+#include <ostream>
+
 #include "gtest/gtest.h"
 #include "response/bucket_resp.h"
 #include "response/data_process_resp.h"
 #include "response/service_resp.h"
+#include "util/compact_list_result.h"
+#include "util/list_xml_parser.h"
 
 namespace qcloud_cos {
 
@@ -424,4 +429,382 @@ TEST(BucketRespTest, GetBucketLocationRespTest) {
     }
 }
 
+namespace {
+
+// 收集流式解析结果
+class CollectListHandler : public ListXmlHandler {
+ public:
+    CollectListHandler() : reset_times(0) {}
+
+    void OnReset() override {
+        ++reset_times;
+        entries.clear();
+        common_prefixes.clear();
+    }
+
+    void OnEntry(const ListEntry& entry) override { entries.push_back(entry); }
+
+    void OnCommonPrefix(const std::string& prefix) override {
+        common_prefixes.push_back(prefix);
+    }
+
+    int reset_times;
+    std::vector<ListEntry> entries;
+    std::vector<std::string> common_prefixes;
+};
+
+std::string GetListBucketBody() {
+    std::string body;
+    body += "<?xml version='1.0' encoding='utf-8' ?>\n";
+    body += "<ListBucketResult>";
+    body += "<Name>testbucket-111</Name>";
+    body += "<Prefix/>";
+    body += "<Marker/>";
+    body += "<MaxKeys>3</MaxKeys>";
+    body += "<IsTruncated>true</IsTruncated>";
+    body += "<NextMarker>b&amp;c&#x4e2d;.txt</NextMarker>";
+    body += "<CommonPrefixes>";
+    body += "   <Prefix>dir/</Prefix>";
+    body += "</CommonPrefixes>";
+    body += "<Contents>";
+    body += "	<Key>a&lt;1&gt;.txt</Key>";
+    body += "	<LastModified>2020-12-10T04:37:30.000Z</LastModified>";
+    body += "	<ETag>&quot;51370fc64b79d0d3c7c609635be1c41f&quot;</ETag>";
+    body += "	<Size>20</Size>";
+    body += "	<Owner>";
+    body += "		<ID>1250000000</ID>";
+    body += "		<DisplayName>1250000000</DisplayName>";
+    body += "	</Owner>";
+    body += "	<StorageClass>ARCHIVE</StorageClass>";
+    body += "	<RestoreStatus>DONE</RestoreStatus>";
+    body += "   <Unknown>unknown</Unknown>";
+    body += "</Contents>";
+    body += "<Contents>";
+    body += "	<Key>b&amp;c&#x4e2d;.txt</Key>";
+    body += "	<LastModified>2021-01-15T08:20:00.123Z</LastModified>";
+    body += "	<ETag>\"abcdef1234567890abcdef1234567890-2\"</ETag>";
+    body += "	<Size>10737418240</Size>";
+    body += "	<StorageClass>INTELLIGENT_TIERING</StorageClass>";
+    body += "	<StorageTier>ARCHIVE_ACCESS</StorageTier>";
+    body += "</Contents>";
+    body += "</ListBucketResult>\n";
+    return body;
+}
+
+}  // namespace
+
+TEST(BucketRespTest, ListXmlParserGetBucketTest) {
+    const std::string body = GetListBucketBody();
+    GetBucketResp resp;
+    ASSERT_TRUE(resp.ParseFromXmlString(body));
+    const std::vector<Content> expect = resp.GetContents();
+    ASSERT_EQ(2, expect.size());
+
+    // 以各种长度分段输入, 结果都应与DOM解析一致
+    for (size_t chunk = 1; chunk <= body.size(); ++chunk) {
+        CollectListHandler handler;
+        ListXmlParser parser(&handler);
+        for (size_t pos = 0; pos < body.size(); pos += chunk) {
+            ASSERT_TRUE(parser.Feed(body.data() + pos,
+                                    std::min(chunk, body.size() - pos)));
+        }
+        ASSERT_TRUE(parser.Finish());
+        ASSERT_TRUE(parser.GetPageInfo().is_truncated);
+        ASSERT_EQ(resp.GetNextMarker(), parser.GetPageInfo().next_marker);
+        ASSERT_EQ(resp.GetCommonPrefixes(), handler.common_prefixes);
+        ASSERT_EQ(expect.size(), handler.entries.size());
+        for (size_t i = 0; i < expect.size(); ++i) {
+            Content content;
+            handler.entries[i].ToContent(&content);
+            ASSERT_EQ(expect[i].m_key, content.m_key);
+            ASSERT_EQ(expect[i].m_last_modified, content.m_last_modified);
+            ASSERT_EQ(expect[i].m_etag, content.m_etag);
+            ASSERT_EQ(expect[i].m_size, content.m_size);
+            ASSERT_EQ(expect[i].m_owner_ids, content.m_owner_ids);
+            ASSERT_EQ(expect[i].m_storage_class, content.m_storage_class);
+            ASSERT_EQ(expect[i].m_storage_tier, content.m_storage_tier);
+            ASSERT_EQ(expect[i].m_restore_status, content.m_restore_status);
+        }
+    }
+
+    CollectListHandler handler;
+    ListXmlParser parser(&handler);
+    ASSERT_TRUE(parser.Feed(body.data(), body.size()));
+    ASSERT_TRUE(parser.Finish());
+    ASSERT_EQ("a<1>.txt", handler.entries[0].key);
+    ASSERT_EQ(20, handler.entries[0].size);
+    ASSERT_EQ(1607575050000LL, handler.entries[0].last_modified_ms);
+    ASSERT_EQ("b&c\xe4\xb8\xad.txt", handler.entries[1].key);
+    ASSERT_EQ(10737418240ULL, handler.entries[1].size);
+    ASSERT_EQ(1610698800123LL, handler.entries[1].last_modified_ms);
+    ASSERT_EQ("abcdef1234567890abcdef1234567890-2", handler.entries[1].etag);
+}
+
+TEST(BucketRespTest, ListXmlParserVersionsTest) {
+    std::string body;
+    body += "<ListVersionsResult>";
+    body += "<Name>testbucket-111</Name>";
+    body += "<IsTruncated>true</IsTruncated>";
+    body += "<NextKeyMarker>key2</NextKeyMarker>";
+    body += "<NextVersionIdMarker>MTg0NDUxNTc</NextVersionIdMarker>";
+    body += "<Version>";
+    body += "<Key>key1</Key><VersionId>v1</VersionId><IsLatest>true</IsLatest>";
+    body += "<LastModified>2020-12-10T04:37:30.000Z</LastModified>";
+    body += "<ETag>\"etag1\"</ETag><Size>5</Size><StorageClass>STANDARD</StorageClass>";
+    body += "<Owner><ID>100</ID><DisplayName>name</DisplayName></Owner>";
+    body += "</Version>";
+    body += "<DeleteMarker>";
+    body += "<Key>key2</Key><VersionId>v2</VersionId><IsLatest>false</IsLatest>";
+    body += "<LastModified>2020-12-10T04:37:31.000Z</LastModified>";
+    body += "</DeleteMarker>";
+    body += "</ListVersionsResult>";
+
+    GetBucketObjectVersionsResp resp;
+    ASSERT_TRUE(resp.ParseFromXmlString(body));
+    const std::vector<COSVersionSummary> expect = resp.GetVersionSummary();
+
+    CollectListHandler handler;
+    ListXmlParser parser(&handler);
+    ASSERT_TRUE(parser.Feed(body.data(), body.size()));
+    ASSERT_TRUE(parser.Finish());
+    ASSERT_EQ("key2", parser.GetPageInfo().next_key_marker);
+    ASSERT_EQ(resp.GetNextVersionIdMarker(),
+              parser.GetPageInfo().next_version_id_marker);
+    ASSERT_EQ(expect.size(), handler.entries.size());
+    for (size_t i = 0; i < expect.size(); ++i) {
+        COSVersionSummary summary;
+        handler.entries[i].ToVersionSummary(&summary);
+        ASSERT_EQ(expect[i].m_key, summary.m_key);
+        ASSERT_EQ(expect[i].m_version_id, summary.m_version_id);
+        ASSERT_EQ(expect[i].m_is_latest, summary.m_is_latest);
+        ASSERT_EQ(expect[i].m_is_delete_marker, summary.m_is_delete_marker);
+        ASSERT_EQ(expect[i].m_last_modified, summary.m_last_modified);
+        ASSERT_EQ(expect[i].m_owner.m_id, summary.m_owner.m_id);
+    }
+    ASSERT_EQ("etag1", handler.entries[0].etag);
+    ASSERT_EQ(5, handler.entries[0].size);
+    ASSERT_TRUE(handler.entries[1].is_delete_marker);
+}
+
+TEST(BucketRespTest, ListXmlParserErrorTest) {
+    // 不完整的响应
+    {
+        const std::string body = GetListBucketBody();
+        CollectListHandler handler;
+        ListXmlParser parser(&handler);
+        ASSERT_TRUE(parser.Feed(body.data(), body.size() / 2));
+        ASSERT_FALSE(parser.Finish());
+    }
+    // 非列出结果
+    {
+        const std::string body = "<Error><Code>NoSuchBucket</Code></Error>";
+        CollectListHandler handler;
+        ListXmlParser parser(&handler);
+        ASSERT_FALSE(parser.Feed(body.data(), body.size()));
+        ASSERT_FALSE(parser.Finish());
+    }
+    // 标签不匹配
+    {
+        const std::string body = "<ListBucketResult><Contents></Key></ListBucketResult>";
+        CollectListHandler handler;
+        ListXmlParser parser(&handler);
+        ASSERT_FALSE(parser.Feed(body.data(), body.size()));
+    }
+    // 未知实体
+    {
+        const std::string body = "<ListBucketResult><NextMarker>&unknown;</NextMarker></ListBucketResult>";
+        CollectListHandler handler;
+        ListXmlParser parser(&handler);
+        ASSERT_FALSE(parser.Feed(body.data(), body.size()));
+    }
+}
+
+TEST(BucketRespTest, ListXmlStreamBufTest) {
+    const std::string body = GetListBucketBody();
+    CollectListHandler handler;
+    ListXmlParser parser(&handler);
+    ListXmlStreamBuf stream_buf(&parser);
+    std::ostream os(&stream_buf);
+
+    // 写入一半后模拟重试, 回到起点重新写入
+    os.write(body.data(), body.size() / 2);
+    os.rdbuf()->pubseekpos(0, std::ios_base::out);
+    ASSERT_EQ(1, handler.reset_times);
+    os << body;
+    ASSERT_TRUE(os.good());
+    ASSERT_TRUE(parser.Finish());
+    ASSERT_EQ(2, handler.entries.size());
+    ASSERT_EQ(1, handler.common_prefixes.size());
+}
+
+TEST(BucketRespTest, ListXmlParserTimeTest) {
+    int64_t ms = 0;
+    ASSERT_TRUE(ListXmlParser::ParseIso8601Ms("1970-01-01T00:00:00.000Z", &ms));
+    ASSERT_EQ(0, ms);
+    ASSERT_TRUE(ListXmlParser::ParseIso8601Ms("2024-02-29T23:59:59Z", &ms));
+    ASSERT_EQ(1709251199000LL, ms);
+    ASSERT_EQ("2024-02-29T23:59:59.000Z", ListXmlParser::FormatIso8601Ms(ms));
+    ASSERT_TRUE(ListXmlParser::ParseIso8601Ms("2021-01-15T08:20:00.5Z", &ms));
+    ASSERT_EQ(1610698800500LL, ms);
+    ASSERT_FALSE(ListXmlParser::ParseIso8601Ms("2021-01-15 08:20:00", &ms));
+    ASSERT_FALSE(ListXmlParser::ParseIso8601Ms("2021-13-15T08:20:00.000Z", &ms));
+}
+
+TEST(BucketRespTest, CompactListResultTest) {
+    const std::string body = GetListBucketBody();
+    GetBucketResp resp;
+    ASSERT_TRUE(resp.ParseFromXmlString(body));
+    const std::vector<Content> expect = resp.GetContents();
+
+    // 流式解析结果与DOM解析结果追加后应完全一致
+    CompactListResult streamed;
+    ListXmlParser parser(&streamed);
+    ASSERT_TRUE(parser.Feed(body.data(), body.size()));
+    ASSERT_TRUE(parser.Finish());
+    CompactListResult appended;
+    resp.AppendTo(&appended);
+
+    const CompactListResult* results[] = {&streamed, &appended};
+    for (size_t r = 0; r < 2; ++r) {
+        const CompactListResult& result = *results[r];
+        ASSERT_EQ(expect.size(), result.Size());
+        ASSERT_EQ(resp.GetCommonPrefixes(), result.GetCommonPrefixes());
+        for (size_t i = 0; i < expect.size(); ++i) {
+            Content content;
+            result.GetContent(i, &content);
+            ASSERT_EQ(expect[i].m_key, content.m_key);
+            ASSERT_EQ(expect[i].m_last_modified, content.m_last_modified);
+            ASSERT_EQ(expect[i].m_etag, content.m_etag);
+            ASSERT_EQ(expect[i].m_size, content.m_size);
+            ASSERT_EQ(expect[i].m_owner_ids, content.m_owner_ids);
+            ASSERT_EQ(expect[i].m_storage_class, content.m_storage_class);
+            ASSERT_EQ(expect[i].m_storage_tier, content.m_storage_tier);
+            ASSERT_EQ(expect[i].m_restore_status, content.m_restore_status);
+        }
+    }
+    ASSERT_EQ(10737418240ULL, streamed.GetSize(1));
+    ASSERT_EQ(1610698800123LL, streamed.GetLastModifiedMs(1));
+    ASSERT_EQ("1250000000", streamed.GetOwnerDisplayName(0));
+    ASSERT_EQ("", streamed.GetOwnerId(1));
+    ASSERT_EQ("", streamed.GetVersionId(0));
+}
+
+TEST(BucketRespTest, CompactListResultVersionsTest) {
+    std::string body;
+    body += "<ListVersionsResult>";
+    body += "<Name>testbucket-111</Name>";
+    body += "<IsTruncated>false</IsTruncated>";
+    body += "<Version>";
+    body += "<Key>key1</Key><VersionId>MTg0NDUxNTc</VersionId><IsLatest>true</IsLatest>";
+    body += "<LastModified>2020-12-10T04:37:30.000Z</LastModified>";
+    body += "<ETag>\"51370FC64B79D0D3C7C609635BE1C41F\"</ETag><Size>5</Size>";
+    body += "<StorageClass>STANDARD</StorageClass>";
+    body += "<Owner><ID>100</ID><DisplayName>name</DisplayName></Owner>";
+    body += "</Version>";
+    body += "<DeleteMarker>";
+    body += "<Key>key1</Key><VersionId>MTg0NDUxNTY</VersionId><IsLatest>false</IsLatest>";
+    body += "<LastModified>2020-12-10T04:37:31.000Z</LastModified>";
+    body += "<Owner><ID>100</ID><DisplayName>name</DisplayName></Owner>";
+    body += "</DeleteMarker>";
+    body += "</ListVersionsResult>";
+
+    GetBucketObjectVersionsResp resp;
+    ASSERT_TRUE(resp.ParseFromXmlString(body));
+    CompactListResult result;
+    resp.AppendTo(&result);
+    ASSERT_EQ(2, result.Size());
+
+    COSVersionSummary summary;
+    result.GetVersionSummary(0, &summary);
+    ASSERT_EQ("key1", summary.m_key);
+    ASSERT_EQ("MTg0NDUxNTc", summary.m_version_id);
+    // 大写十六进制不按二进制存放, 原样保留
+    ASSERT_EQ("51370FC64B79D0D3C7C609635BE1C41F", summary.m_etag);
+    ASSERT_EQ(5, summary.m_size);
+    ASSERT_TRUE(summary.m_is_latest);
+    ASSERT_FALSE(summary.m_is_delete_marker);
+    ASSERT_EQ("2020-12-10T04:37:30.000Z", summary.m_last_modified);
+    ASSERT_EQ("name", summary.m_owner.m_display_name);
+
+    result.GetVersionSummary(1, &summary);
+    ASSERT_EQ("MTg0NDUxNTY", summary.m_version_id);
+    ASSERT_EQ("", summary.m_etag);
+    ASSERT_TRUE(summary.m_is_delete_marker);
+    ASSERT_FALSE(summary.m_is_latest);
+    ASSERT_EQ("100", summary.m_owner.m_id);
+}
+
+TEST(BucketRespTest, CompactListResultPageTest) {
+    const std::string body = GetListBucketBody();
+    CompactListResult result;
+    ListXmlParser parser(&result);
+    ASSERT_TRUE(parser.Feed(body.data(), body.size()));
+    ASSERT_TRUE(parser.Finish());
+    result.CommitPage();
+    const std::string first_key = result.GetKey(0);
+    const std::string first_etag = result.GetETag(0);
+
+    // 第二页接收一半后重试, 只丢弃第二页已解析的条目
+    ListXmlParser retry_parser(&result);
+    ASSERT_TRUE(retry_parser.Feed(body.data(), body.size() * 3 / 4));
+    ASSERT_LT(2, result.Size());
+    retry_parser.Reset();
+    ASSERT_EQ(2, result.Size());
+    ASSERT_EQ(1, result.GetCommonPrefixes().size());
+    ASSERT_TRUE(retry_parser.Feed(body.data(), body.size()));
+    ASSERT_TRUE(retry_parser.Finish());
+    result.CommitPage();
+    ASSERT_EQ(4, result.Size());
+    ASSERT_EQ(2, result.GetCommonPrefixes().size());
+    ASSERT_EQ(first_key, result.GetKey(2));
+    ASSERT_EQ(first_etag, result.GetETag(2));
+    ASSERT_EQ(result.GetStorageTier(1), result.GetStorageTier(3));
+
+    result.Truncate(1);
+    ASSERT_EQ(1, result.Size());
+    ASSERT_EQ(first_key, result.GetKey(0));
+    ASSERT_EQ("51370fc64b79d0d3c7c609635be1c41f", result.GetETag(0));
+    ASSERT_EQ(20, result.GetSize(0));
+
+    result.Clear();
+    ASSERT_TRUE(result.Empty());
+    ASSERT_TRUE(result.GetCommonPrefixes().empty());
+}
+
+TEST(BucketRespTest, CompactListResultMemoryTest) {
+    const size_t kEntryNum = 10000;
+    std::vector<Content> contents(kEntryNum);
+    CompactListResult result;
+    for (size_t i = 0; i < kEntryNum; ++i) {
+        Content& content = contents[i];
+        content.m_key = "logs/2024/05/20/object_" + std::to_string(i) + ".log";
+        content.m_last_modified = "2024-05-20T06:42:19.000Z";
+        content.m_etag = "3be03ea31c1d6ce899f419c04cbf1ea9";
+        content.m_size = std::to_string(i * 1024);
+        content.m_owner_ids.push_back("1250000000");
+        content.m_storage_class = "STANDARD";
+    }
+    result.AppendContents(contents);
+    result.ShrinkToFit();
+    ASSERT_EQ(kEntryNum, result.Size());
+
+    size_t content_bytes = contents.capacity() * sizeof(Content);
+    for (size_t i = 0; i < kEntryNum; ++i) {
+        const Content& content = contents[i];
+        content_bytes += content.m_key.capacity() + content.m_etag.capacity() +
+                         content.m_owner_ids.capacity() * sizeof(std::string);
+    }
+    // 每个条目只保存key、16字节ETag及定长字段
+    ASSERT_LT(result.MemoryUsage() * 4, content_bytes);
+    for (size_t i = 0; i < kEntryNum; i += 997) {
+        Content content;
+        result.GetContent(i, &content);
+        ASSERT_EQ(contents[i].m_key, content.m_key);
+        ASSERT_EQ(contents[i].m_etag, content.m_etag);
+        ASSERT_EQ(contents[i].m_size, content.m_size);
+        ASSERT_EQ(contents[i].m_last_modified, content.m_last_modified);
+        ASSERT_EQ(contents[i].m_owner_ids, content.m_owner_ids);
+    }
+}
+
 }  // namespace qcloud_cos
\ No newline at end of file
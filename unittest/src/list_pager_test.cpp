@@ -0,0 +1,173 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "op/list_pager.h"
+#include "util/string_util.h"
+
+namespace qcloud_cos {
+
+namespace {
+
+const int kKeysPerPage = 10;
+
+// 模拟GetBucket: 共page_num页, 每页kKeysPerPage个key, fail_page页返回失败
+class FakeGetBucket {
+ public:
+  FakeGetBucket(int page_num, int fail_page)
+      : m_page_num(page_num), m_fail_page(fail_page), m_calls(0) {}
+
+  CosResult operator()(const GetBucketReq& req, GetBucketResp* resp) {
+    ++m_calls;
+    std::string marker = req.GetParam("marker");
+    int page = marker.empty() ? 0 : StringUtil::StringToInt(marker) + 1;
+    CosResult result;
+    if (page == m_fail_page) {
+      result.SetHttpStatus(503);
+      result.SetErrorCode("ServiceUnavailable");
+      return result;
+    }
+
+    std::string body = "<ListBucketResult><Name>test</Name>";
+    body += "<IsTruncated>";
+    body += page + 1 < m_page_num ? "true" : "false";
+    body += "</IsTruncated>";
+    if (page + 1 < m_page_num) {
+      body += "<NextMarker>" + StringUtil::IntToString(page) + "</NextMarker>";
+    }
+    for (int i = 0; i < kKeysPerPage; ++i) {
+      body += "<Contents><Key>" +
+              StringUtil::IntToString(page * kKeysPerPage + i) +
+              "</Key></Contents>";
+    }
+    body += "</ListBucketResult>";
+    resp->ParseFromXmlString(body);
+    result.SetSucc();
+    return result;
+  }
+
+  int GetCalls() const { return m_calls; }
+
+ private:
+  int m_page_num;
+  int m_fail_page;
+  std::atomic<int> m_calls;
+};
+
+GetBucketPager::ListFunc Bind(FakeGetBucket* fake) {
+  return [fake](const GetBucketReq& req, GetBucketResp* resp) {
+    return (*fake)(req, resp);
+  };
+}
+
+}  // namespace
+
+TEST(ListPagerTest, ListAllPages) {
+  FakeGetBucket fake(5, -1);
+  GetBucketPager pager(Bind(&fake), GetBucketReq("test-1250000000"), 2);
+  std::vector<std::string> keys;
+  GetBucketResp page;
+  while (pager.Next(&page)) {
+    const std::vector<Content> contents = page.GetContents();
+    for (size_t i = 0; i < contents.size(); ++i) {
+      keys.push_back(contents[i].m_key);
+    }
+  }
+  EXPECT_TRUE(pager.GetResult().IsSucc());
+  ASSERT_EQ(5 * kKeysPerPage, static_cast<int>(keys.size()));
+  for (int i = 0; i < 5 * kKeysPerPage; ++i) {
+    EXPECT_EQ(StringUtil::IntToString(i), keys[i]);
+  }
+  EXPECT_EQ(5, fake.GetCalls());
+}
+
+TEST(ListPagerTest, RangeFor) {
+  FakeGetBucket fake(3, -1);
+  GetBucketPager pager(Bind(&fake), GetBucketReq("test-1250000000"), 1);
+  int page_num = 0;
+  for (const GetBucketResp& page : pager) {
+    EXPECT_EQ(kKeysPerPage, static_cast<int>(page.GetContents().size()));
+    ++page_num;
+  }
+  EXPECT_EQ(3, page_num);
+}
+
+TEST(ListPagerTest, PrefetchIsBounded) {
+  FakeGetBucket fake(100, -1);
+  GetBucketPager pager(Bind(&fake), GetBucketReq("test-1250000000"), 2);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  // 缓存2页, 另有1页请求完成后等待缓存空位
+  EXPECT_LE(fake.GetCalls(), 3);
+
+  GetBucketResp page;
+  ASSERT_TRUE(pager.Next(&page));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_LE(fake.GetCalls(), 4);
+
+  pager.Cancel();
+  EXPECT_FALSE(pager.Next(&page));
+  EXPECT_TRUE(pager.GetResult().IsSucc());
+}
+
+TEST(ListPagerTest, FailStopsListing) {
+  FakeGetBucket fake(5, 2);
+  GetBucketPager pager(Bind(&fake), GetBucketReq("test-1250000000"), 2);
+  int page_num = 0;
+  GetBucketResp page;
+  while (pager.Next(&page)) {
+    ++page_num;
+  }
+  EXPECT_EQ(2, page_num);
+  CosResult result = pager.GetResult();
+  EXPECT_FALSE(result.IsSucc());
+  EXPECT_EQ(503, result.GetHttpStatus());
+  EXPECT_EQ(3, fake.GetCalls());
+}
+
+TEST(ListPagerTest, TruncatedWithoutNextMarkerStops) {
+  // 截断但未返回下一页的marker时结束, 不重复请求同一页
+  GetBucketObjectVersionsResp versions_resp;
+  ASSERT_TRUE(versions_resp.ParseFromXmlString(
+      "<ListVersionsResult><IsTruncated>true</IsTruncated>"
+      "</ListVersionsResult>"));
+  GetBucketObjectVersionsReq versions_req("test-1250000000");
+  EXPECT_FALSE((ListPageTraits<GetBucketObjectVersionsReq,
+                               GetBucketObjectVersionsResp>::
+                    Advance(versions_resp, &versions_req)));
+
+  ASSERT_TRUE(versions_resp.ParseFromXmlString(
+      "<ListVersionsResult><IsTruncated>true</IsTruncated>"
+      "<NextKeyMarker>a</NextKeyMarker>"
+      "<NextVersionIdMarker>v1</NextVersionIdMarker>"
+      "</ListVersionsResult>"));
+  EXPECT_TRUE((ListPageTraits<GetBucketObjectVersionsReq,
+                              GetBucketObjectVersionsResp>::
+                   Advance(versions_resp, &versions_req)));
+  EXPECT_EQ("a", versions_req.GetParam("key-marker"));
+  EXPECT_EQ("v1", versions_req.GetParam("version-id-marker"));
+
+  ListMultipartUploadResp uploads_resp;
+  ASSERT_TRUE(uploads_resp.ParseFromXmlString(
+      "<ListMultipartUploadsResult><IsTruncated>true</IsTruncated>"
+      "</ListMultipartUploadsResult>"));
+  ListMultipartUploadReq uploads_req("test-1250000000");
+  EXPECT_FALSE((ListPageTraits<ListMultipartUploadReq,
+                               ListMultipartUploadResp>::
+                    Advance(uploads_resp, &uploads_req)));
+
+  ASSERT_TRUE(uploads_resp.ParseFromXmlString(
+      "<ListMultipartUploadsResult><IsTruncated>true</IsTruncated>"
+      "<NextKeyMarker>b</NextKeyMarker>"
+      "<NextUploadIdMarker>u1</NextUploadIdMarker>"
+      "</ListMultipartUploadsResult>"));
+  EXPECT_TRUE((ListPageTraits<ListMultipartUploadReq,
+                              ListMultipartUploadResp>::
+                   Advance(uploads_resp, &uploads_req)));
+  EXPECT_EQ("b", uploads_req.GetParam("key-marker"));
+  EXPECT_EQ("u1", uploads_req.GetParam("upload-id-marker"));
+}
+
+}  // namespace qcloud_cos
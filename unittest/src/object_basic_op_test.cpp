@@ -7,7 +7,10 @@
 //         GetObjectByStream, GetObjectUrl, PostObjectRestore,
 //         GetObjectByFile, ResumableGetObject
 
+#include <fstream>
+
 #include "object_op_test_common.h"
+#include "util/crc64.h"
 
 namespace qcloud_cos {
 
@@ -433,9 +436,46 @@ TEST_F(ObjectOpTest, DeleteObjectsTest) {
       catch(const std::exception& e){
         EXPECT_STREQ(e.what(), "Invalid bucket_name argument :bucket_name-12500000000@xxxx");
       }
+      req.SetCosPath(directory_name);
+      req.SetConcurrency(3);
+      uint64_t last_progress = 0;
+      req.SetTransferProgressCallback(
+          [&last_progress](uint64_t transferred_size, uint64_t total_size, void*) {
+            EXPECT_EQ(4096u, total_size);
+            EXPECT_GE(transferred_size, last_progress);
+            last_progress = transferred_size;
+          });
       PutObjectsByDirectoryResp resp;
       CosResult result = m_client->PutObjects(req, &resp);
       ASSERT_TRUE(result.IsSucc());
+      EXPECT_EQ(4u, resp.m_succ_put_objs.size());
+      EXPECT_TRUE(resp.m_fail_put_objs.empty());
+      EXPECT_EQ(4096u, last_progress);
+
+      // 按前缀下载到另一个目录, 第二次下载时本地文件一致全部跳过
+      std::string download_dir = "get_objects_testfile_directory";
+      for (int i = 0; i < 2; ++i) {
+        GetObjectsByPrefixReq get_req(m_bucket_name, directory_name + "/",
+                                      download_dir);
+        get_req.SetConcurrency(2);
+        get_req.SetSkipIdentical(true);
+        GetObjectsByPrefixResp get_resp;
+        CosResult get_result = m_client->GetObjects(get_req, &get_resp);
+        ASSERT_TRUE(get_result.IsSucc());
+        ASSERT_EQ(4u, get_resp.m_succ_get_objs.size());
+        EXPECT_TRUE(get_resp.m_fail_get_objs.empty());
+        for (const auto& r : get_resp.m_succ_get_objs) {
+          EXPECT_EQ(i == 1, r.m_skipped);
+          EXPECT_EQ(TestUtils::CalcFileMd5(r.m_file_name),
+                    TestUtils::CalcFileMd5("./" + directory_name + "/" +
+                                           r.m_file_name.substr(download_dir.size() + 1)));
+        }
+      }
+      TestUtils::RemoveFile(download_dir + "/" + object_name1);
+      TestUtils::RemoveFile(download_dir + "/" + object_name2);
+      TestUtils::RemoveFile(download_dir + "/" + object_name3);
+      TestUtils::RemoveFile(download_dir + "/" + object_name4);
+      TestUtils::RemoveDirectory(download_dir);
       TestUtils::RemoveFile(local_file1);
       TestUtils::RemoveFile(local_file2);
       TestUtils::RemoveFile(local_file3);
@@ -450,9 +490,13 @@ TEST_F(ObjectOpTest, DeleteObjectsTest) {
       catch(const std::exception& e){
         EXPECT_STREQ(e.what(), "Invalid bucket_name argument :bucket_name-12500000000@xxxx");
       }
+      del_req.SetBatchSize(3);
+      del_req.SetConcurrency(2);
       DeleteObjectsByPrefixResp del_resp;
       CosResult del_result = m_client->DeleteObjects(del_req, &del_resp);
       ASSERT_TRUE(del_result.IsSucc());
+      EXPECT_EQ(4u, del_resp.m_succ_del_objs.size());
+      EXPECT_TRUE(del_resp.m_fail_del_objs.empty());
     }
   }
   //批量删除
@@ -518,6 +562,65 @@ TEST_F(ObjectOpTest, DeleteObjectsTest) {
     ASSERT_TRUE(del_result.IsSucc());
   }
 }
+
+TEST_F(ObjectOpTest, SyncDirectoryTest) {
+  std::string directory_name = "sync_directory_testfile_directory";
+  std::string cos_prefix = "sync_directory_test/";
+  std::string manifest_file = "./sync_directory_test.manifest";
+  ASSERT_TRUE(TestUtils::MakeDirectory(directory_name));
+  std::string local_file1 = directory_name + "/testfile1";
+  std::string local_file2 = directory_name + "/testfile2";
+  std::string local_file3 = directory_name + "/testfile3";
+  TestUtils::WriteRandomDatatoFile(local_file1, 1024);
+  TestUtils::WriteRandomDatatoFile(local_file2, 2048);
+  TestUtils::WriteRandomDatatoFile(local_file3, 4096);
+
+  // 首次同步全部上传
+  {
+    SyncDirectoryReq req(m_bucket_name, directory_name, cos_prefix);
+    req.SetManifestFile(manifest_file);
+    SyncDirectoryResp resp;
+    CosResult result = m_client->SyncDirectory(req, &resp);
+    ASSERT_TRUE(result.IsSucc());
+    EXPECT_EQ(3u, resp.m_uploaded_objs.size());
+    EXPECT_TRUE(resp.m_unchanged_objs.empty());
+  }
+  // 未修改时全部跳过
+  {
+    SyncDirectoryReq req(m_bucket_name, directory_name, cos_prefix);
+    req.SetManifestFile(manifest_file);
+    SyncDirectoryResp resp;
+    CosResult result = m_client->SyncDirectory(req, &resp);
+    ASSERT_TRUE(result.IsSucc());
+    EXPECT_TRUE(resp.m_uploaded_objs.empty());
+    EXPECT_EQ(3u, resp.m_unchanged_objs.size());
+  }
+  // 修改一个文件并删除一个文件
+  TestUtils::WriteRandomDatatoFile(local_file1, 1024);
+  TestUtils::RemoveFile(local_file3);
+  {
+    SyncDirectoryReq req(m_bucket_name, directory_name, cos_prefix);
+    req.SetManifestFile(manifest_file);
+    req.SetDeleteRemote(true);
+    SyncDirectoryResp resp;
+    CosResult result = m_client->SyncDirectory(req, &resp);
+    ASSERT_TRUE(result.IsSucc());
+    ASSERT_EQ(1u, resp.m_uploaded_objs.size());
+    EXPECT_EQ(cos_prefix + "testfile1", resp.m_uploaded_objs[0]);
+    ASSERT_EQ(1u, resp.m_unchanged_objs.size());
+    EXPECT_EQ(cos_prefix + "testfile2", resp.m_unchanged_objs[0]);
+    ASSERT_EQ(1u, resp.m_deleted_objs.size());
+    EXPECT_EQ(cos_prefix + "testfile3", resp.m_deleted_objs[0]);
+  }
+
+  TestUtils::RemoveFile(local_file1);
+  TestUtils::RemoveFile(local_file2);
+  TestUtils::RemoveDirectory(directory_name);
+  TestUtils::RemoveFile(manifest_file);
+  DeleteObjectsByPrefixReq del_req(m_bucket_name, cos_prefix);
+  DeleteObjectsByPrefixResp del_resp;
+  ASSERT_TRUE(m_client->DeleteObjects(del_req, &del_resp).IsSucc());
+}
 #endif
 
 TEST_F(ObjectOpTest, GetObjectByStreamTest) {
@@ -777,4 +880,64 @@ TEST_F(ObjectOpTest, ResumableGetObjectTest) {
   TestUtils::RemoveFile(file_download);
 }
 
+TEST_F(ObjectOpTest, ResumableGetObjectSliceResumeTest) {
+  // 任务文件中只记录了乱序完成的分片1和3, 续传时只下载其余分片,
+  // 整个文件的CRC64由任务文件中的分片CRC64与新下载的分片CRC64合并得到
+  const uint64_t slice_size = 1024 * 1024;
+  std::string local_file = "resumable_get_object_slice_test_file";
+  std::string object_name = "resumable_get_object_slice_test";
+  TestUtils::WriteRandomDatatoFile(local_file, 5 * slice_size + 123);
+  PutObjectByFileReq put_req(m_bucket_name, object_name, local_file);
+  PutObjectByFileResp put_resp;
+  ASSERT_TRUE(m_client->PutObject(put_req, &put_resp).IsSucc());
+
+  HeadObjectReq head_req(m_bucket_name, object_name);
+  HeadObjectResp head_resp;
+  ASSERT_TRUE(m_client->HeadObject(head_req, &head_resp).IsSucc());
+
+  std::string content = FileUtil::GetFileContent(local_file);
+  std::string partial(content.size(), '\0');
+  std::string crc64_list;
+  const uint64_t done_slices[] = {1, 3};
+  for (uint64_t idx : done_slices) {
+    uint64_t offset = idx * slice_size;
+    partial.replace(offset, slice_size, content, offset, slice_size);
+    if (!crc64_list.empty()) {
+      crc64_list += ",";
+    }
+    crc64_list += std::to_string(CRC64::CalcCRC(0, &content[offset], slice_size));
+  }
+  std::string file_download = "resumable_get_object_slice_test_file_download";
+  TestUtils::WriteStringtoFile(file_download, partial);
+
+  std::string task_file = file_download + kResumableDownloadTaskFileSuffix;
+  std::ofstream ofs(task_file, std::ios::out | std::ios::trunc);
+  ofs << "{\"" << kResumableDownloadTaskLastModified << "\":\""
+      << head_resp.GetLastModified() << "\",\""
+      << kResumableDownloadTaskContentLength << "\":\""
+      << head_resp.GetContentLength() << "\",\"" << kResumableDownloadTaskEtag
+      << "\":\"" << head_resp.GetEtag() << "\",\""
+      << kResumableDownloadTaskCrc64ecma << "\":\""
+      << head_resp.GetXCosHashCrc64Ecma() << "\",\""
+      << kResumableDownloadSliceSize << "\":\"" << slice_size << "\",\""
+      << kResumableDownloadSliceBitmap << "\":\"0a\",\""
+      << kResumableDownloadSliceCrc64 << "\":\"" << crc64_list << "\"}";
+  ofs.close();
+
+  GetObjectByFileReq get_req(m_bucket_name, object_name, file_download);
+  GetObjectByFileResp get_resp;
+  CosResult get_result = m_client->ResumableGetObject(get_req, &get_resp);
+  ASSERT_TRUE(get_result.IsSucc());
+  ASSERT_EQ(TestUtils::CalcFileMd5(local_file),
+            TestUtils::CalcFileMd5(file_download));
+  // 下载成功后删除任务文件
+  ASSERT_FALSE(std::ifstream(task_file).good());
+
+  DeleteObjectReq del_req(m_bucket_name, object_name);
+  DeleteObjectResp del_resp;
+  ASSERT_TRUE(m_client->DeleteObject(del_req, &del_resp).IsSucc());
+  TestUtils::RemoveFile(local_file);
+  TestUtils::RemoveFile(file_download);
+}
+
 }  // namespace qcloud_cos
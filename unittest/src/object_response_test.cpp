@@ -5,10 +5,18 @@
 // Created: 07/25/17
 // Description:
 
+#include <algorithm>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Poco/Checksum.h"
 #include "gtest/gtest.h"
 #include "response/object_resp.h"
 #include "response/data_process_resp.h"
 #include "response/auditing_resp.h"
+#include "util/select_event_decoder.h"
 
 namespace qcloud_cos {
 
@@ -606,4 +614,230 @@ TEST(ObjectRespTest, AudioAuditingRespTest) {
   }
 }
 
+namespace {
+
+void AppendUint32BigEndian(uint32_t value, std::string* out) {
+  out->push_back(static_cast<char>((value >> 24) & 0xFF));
+  out->push_back(static_cast<char>((value >> 16) & 0xFF));
+  out->push_back(static_cast<char>((value >> 8) & 0xFF));
+  out->push_back(static_cast<char>(value & 0xFF));
+}
+
+// 按event stream格式构造一条消息
+std::string BuildSelectMessage(
+    const std::map<std::string, std::string>& headers,
+    const std::string& payload) {
+  std::string header_bytes;
+  for (std::map<std::string, std::string>::const_iterator itr = headers.begin();
+       itr != headers.end(); ++itr) {
+    header_bytes.push_back(static_cast<char>(itr->first.size()));
+    header_bytes += itr->first;
+    header_bytes.push_back(7);
+    header_bytes.push_back(static_cast<char>((itr->second.size() >> 8) & 0xFF));
+    header_bytes.push_back(static_cast<char>(itr->second.size() & 0xFF));
+    header_bytes += itr->second;
+  }
+  std::string message;
+  AppendUint32BigEndian(
+      static_cast<uint32_t>(12 + header_bytes.size() + payload.size() + 4),
+      &message);
+  AppendUint32BigEndian(static_cast<uint32_t>(header_bytes.size()), &message);
+  Poco::Checksum prelude_crc;
+  prelude_crc.update(message.data(), 8);
+  AppendUint32BigEndian(prelude_crc.checksum(), &message);
+  message += header_bytes;
+  message += payload;
+  Poco::Checksum message_crc;
+  message_crc.update(message.data(), static_cast<unsigned int>(message.size()));
+  AppendUint32BigEndian(message_crc.checksum(), &message);
+  return message;
+}
+
+std::string BuildSelectEvent(const std::string& event_type,
+                             const std::string& payload) {
+  std::map<std::string, std::string> headers;
+  headers[":message-type"] = "event";
+  headers[":event-type"] = event_type;
+  if (event_type == "Records") {
+    headers[":content-type"] = "application/octet-stream";
+  } else if (!payload.empty()) {
+    headers[":content-type"] = "text/xml";
+  }
+  return BuildSelectMessage(headers, payload);
+}
+
+std::string BuildSelectBody() {
+  std::string body;
+  body += BuildSelectEvent("Records", "{\"aaa\":111}\n");
+  body += BuildSelectEvent("Cont", "");
+  body += BuildSelectEvent("Records", std::string(5000, 'x'));
+  body += BuildSelectEvent(
+      "Progress",
+      "<Progress><BytesScanned>512</BytesScanned><BytesProcessed>1024"
+      "</BytesProcessed><BytesReturned>5012</BytesReturned></Progress>");
+  body += BuildSelectEvent(
+      "Stats",
+      "<Stats><BytesScanned>1024</BytesScanned><BytesProcessed>2048"
+      "</BytesProcessed><BytesReturned>5012</BytesReturned></Stats>");
+  body += BuildSelectEvent("End", "");
+  return body;
+}
+
+// 记录回调的事件
+class CollectSelectHandler : public SelectEventHandler {
+ public:
+  CollectSelectHandler()
+      : records_calls(0), stop_after(-1), progress_calls(0), end_calls(0) {}
+
+  bool OnRecords(const char* data, size_t len,
+                 const std::string& content_type) override {
+    ++records_calls;
+    records.append(data, len);
+    records_content_type = content_type;
+    return stop_after < 0 || records_calls < stop_after;
+  }
+
+  void OnProgress(const SelectProgress& progress) override {
+    ++progress_calls;
+    last_progress = progress;
+  }
+
+  void OnStats(const SelectProgress& stats) override { last_stats = stats; }
+
+  void OnEnd() override { ++end_calls; }
+
+  int records_calls;
+  int stop_after;  // 第几次Records回调返回false
+  std::string records;
+  std::string records_content_type;
+  int progress_calls;
+  SelectProgress last_progress;
+  SelectProgress last_stats;
+  int end_calls;
+};
+
+}  // namespace
+
+TEST(ObjectRespTest, SelectEventDecoderTest) {
+  const std::string body = BuildSelectBody();
+  const std::string expect_records = "{\"aaa\":111}\n" + std::string(5000, 'x');
+
+  // 以各种长度分段输入, 结果都应一致
+  const size_t chunks[] = {1, 3, 12, 13, 57, 1000, 4096, body.size()};
+  for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); ++i) {
+    CollectSelectHandler handler;
+    SelectEventDecoder decoder(&handler);
+    for (size_t pos = 0; pos < body.size(); pos += chunks[i]) {
+      ASSERT_TRUE(decoder.Feed(body.data() + pos,
+                               std::min(chunks[i], body.size() - pos)));
+    }
+    ASSERT_TRUE(decoder.IsEnd());
+    ASSERT_FALSE(decoder.InMessage());
+    ASSERT_EQ(expect_records, handler.records);
+    ASSERT_EQ(2, handler.records_calls);
+    ASSERT_EQ("application/octet-stream", handler.records_content_type);
+    ASSERT_EQ(1, handler.progress_calls);
+    ASSERT_EQ("text/xml", handler.last_progress.content_type);
+    ASSERT_EQ(512, handler.last_progress.bytes_scanned);
+    ASSERT_EQ(1024, handler.last_progress.bytes_processed);
+    ASSERT_EQ(2048, handler.last_stats.bytes_processed);
+    ASSERT_EQ(5012, handler.last_stats.bytes_returned);
+    ASSERT_EQ(1, handler.end_calls);
+  }
+
+  // 缓存形式的解析结果不变, content-type取自消息头部
+  SelectObjectContentResp resp;
+  ASSERT_TRUE(resp.ParseFromXmlString(body));
+  const std::vector<SelectMessage>& messages = resp.GetSelectMessages();
+  ASSERT_EQ(4u, messages.size());
+  ASSERT_EQ("Records", messages[0].m_event_type);
+  ASSERT_EQ("application/octet-stream", messages[0].m_content_type);
+  ASSERT_EQ("Progress", messages[2].m_event_type);
+  ASSERT_EQ("text/xml", messages[2].m_content_type);
+  ASSERT_EQ("Stats", messages[3].m_event_type);
+  ASSERT_EQ("text/xml", messages[3].m_content_type);
+}
+
+TEST(ObjectRespTest, SelectEventDecoderErrorTest) {
+  // 消息内容损坏
+  {
+    std::string body = BuildSelectBody();
+    body[20] ^= 0x01;
+    CollectSelectHandler handler;
+    SelectEventDecoder decoder(&handler);
+    ASSERT_FALSE(decoder.Feed(body.data(), body.size()));
+    ASSERT_TRUE(decoder.IsFailed());
+    ASSERT_NE(std::string::npos, decoder.GetErrorMsg().find("message crc"));
+    ASSERT_EQ(0, handler.records_calls);
+  }
+  // prelude损坏, 不等待整条消息到达即失败
+  {
+    std::string body = BuildSelectBody();
+    body[2] ^= 0x01;
+    CollectSelectHandler handler;
+    SelectEventDecoder decoder(&handler);
+    ASSERT_FALSE(decoder.Feed(body.data(), 12));
+    ASSERT_NE(std::string::npos, decoder.GetErrorMsg().find("prelude crc"));
+  }
+  // 服务端返回错误消息
+  {
+    std::map<std::string, std::string> headers;
+    headers[":message-type"] = "error";
+    headers[":error-code"] = "InvalidSqlExpression";
+    headers[":error-message"] = "Syntax error";
+    std::string body = BuildSelectEvent("Records", "abc");
+    body += BuildSelectMessage(headers, "");
+    CollectSelectHandler handler;
+    SelectEventDecoder decoder(&handler);
+    ASSERT_FALSE(decoder.Feed(body.data(), body.size()));
+    ASSERT_EQ("abc", handler.records);
+    ASSERT_EQ("InvalidSqlExpression", decoder.GetServerErrorCode());
+    ASSERT_EQ("Syntax error", decoder.GetServerErrorMessage());
+
+    SelectObjectContentResp resp;
+    ASSERT_FALSE(resp.ParseFromXmlString(body));
+  }
+  // 回调要求停止
+  {
+    const std::string body = BuildSelectBody();
+    CollectSelectHandler handler;
+    handler.stop_after = 1;
+    SelectEventDecoder decoder(&handler);
+    ASSERT_FALSE(decoder.Feed(body.data(), body.size()));
+    ASSERT_TRUE(decoder.IsStopped());
+    ASSERT_FALSE(decoder.IsFailed());
+    ASSERT_EQ(1, handler.records_calls);
+  }
+}
+
+TEST(ObjectRespTest, SelectEventStreamBufTest) {
+  const std::string body = BuildSelectBody();
+  CollectSelectHandler handler;
+  SelectEventDecoder decoder(&handler);
+  SelectEventStreamBuf stream_buf(&decoder);
+  std::ostream os(&stream_buf);
+
+  // 还未回调任何事件时可以回到起点重新解码
+  os.write(body.data(), 20);
+  ASSERT_EQ(std::streampos(0), os.rdbuf()->pubseekpos(0, std::ios_base::out));
+  os.write(body.data(), body.size() / 2);
+  ASSERT_TRUE(decoder.HasDelivered());
+  // 已回调过事件, 不能再重试
+  ASSERT_EQ(std::streampos(std::streamoff(-1)),
+            os.rdbuf()->pubseekpos(0, std::ios_base::out));
+  os.write(body.data() + body.size() / 2, body.size() - body.size() / 2);
+  ASSERT_TRUE(os.good());
+  ASSERT_TRUE(decoder.IsEnd());
+  ASSERT_EQ(2, handler.records_calls);
+
+  // 回调要求停止后写入失败, 用于中断接收
+  CollectSelectHandler stop_handler;
+  stop_handler.stop_after = 1;
+  SelectEventDecoder stop_decoder(&stop_handler);
+  SelectEventStreamBuf stop_buf(&stop_decoder);
+  std::ostream stop_os(&stop_buf);
+  stop_os.write(body.data(), body.size());
+  ASSERT_FALSE(stop_os.good());
+}
+
 }  // namespace qcloud_cos
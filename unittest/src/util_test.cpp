@@ -5,21 +5,39 @@
 // Created: 08/11/17
 // Description:
 
+#include <fcntl.h>
+#include <string.h>
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <sstream>
 #include <thread>
+#include <vector>
 
 #include "cos_sys_config.h"
 #include "gtest/gtest.h"
+#include "op/file_part_reader.h"
 #include "util/test_utils.h"
 #include "util/auth_tool.h"
 #include "util/file_util.h"
+#include "util/hash_util.h"
 #include "util/lru_cache.h"
 #include "util/simple_dns_cache.h"
 #include "util/string_util.h"
 #include "util/log_util.h"
 #include "util/codec_util.h"
+#include "util/crc64.h"
 #include "util/base_op_util.h"
+#include "util/buffer_pool.h"
 #include "util/http_sender.h"
+#include "util/http_session_pool.h"
+#include "util/ssl_context_cache.h"
+#include "util/transfer_worker_pool.h"
 
 namespace qcloud_cos {
 
@@ -113,6 +131,65 @@ TEST(UtilTest, AuthToolTest) {
   ASSERT_TRUE(sign_result.find("not-exists-header") == std::string::npos);
 }
 
+TEST(UtilTest, AuthToolCanonicalizeTest) {
+  std::map<std::string, std::string> headers;
+  // 转小写后重复的头部保留排在后面的一个
+  headers["Content-Type"] = "text/plain; charset=utf-8";
+  headers["content-type"] = "application/xml";
+  headers["host"] = "examplebucket-1250000000.cos.ap-guangzhou.myqcloud.com";
+  // x-cos前缀区分大小写, 不参与签名
+  headers["X-Cos-Meta-A"] = "skip";
+  std::map<std::string, std::string> params;
+  params["Prefix"] = "a/b c";
+  params["acl"] = "";
+  params["max-keys"] = "10";
+  std::unordered_set<std::string> not_sign_headers;
+
+  const std::string expected_prefix =
+      "q-sign-algorithm=sha1&q-ak=access_key_test&q-sign-time="
+      "1502493430;1502573430&q-key-time=1502493430;1502573430&"
+      "q-header-list=content-type;host&q-url-param-list=acl;max-keys;prefix"
+      "&q-signature=";
+  const std::string expected =
+      expected_prefix + "3474e36a029f8f3c4599d53488375f84ceebda65";
+  const std::string another_expected =
+      expected_prefix + "4581d3bc1fd044c85c6293fb55126b590db02c83";
+
+  // 相同key-time下交替使用不同的secret_key, 缓存的sign_key不能混用
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(expected,
+              AuthTool::Sign("access_key_test", "secret_key_test", "GET",
+                             "/dir/obj", headers, params, 1502493430,
+                             1502573430, not_sign_headers));
+    EXPECT_EQ(another_expected,
+              AuthTool::Sign("access_key_test", "another_secret_key", "GET",
+                             "/dir/obj", headers, params, 1502493430,
+                             1502573430, not_sign_headers));
+  }
+
+  // 多线程同时签名
+  std::atomic<int> mismatch(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.push_back(std::thread([&, t]() {
+      const std::string secret_key =
+          t % 2 == 0 ? "secret_key_test" : "another_secret_key";
+      const std::string& want = t % 2 == 0 ? expected : another_expected;
+      for (int i = 0; i < 200; ++i) {
+        if (AuthTool::Sign("access_key_test", secret_key, "GET", "/dir/obj",
+                           headers, params, 1502493430, 1502573430,
+                           not_sign_headers) != want) {
+          ++mismatch;
+        }
+      }
+    }));
+  }
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i].join();
+  }
+  EXPECT_EQ(0, mismatch.load());
+}
+
 TEST(UtilTest, MD5Test) {
   const std::string test_file = "/tmp/testmd5";
   TestUtils::WriteStringtoFile(test_file, "aaaaaaaaa");
@@ -121,11 +198,172 @@ TEST(UtilTest, MD5Test) {
   TestUtils::RemoveFile(test_file);
 }
 
+TEST(UtilTest, HashUtilTest) {
+  const std::string abc = "abc";
+  const std::string million_a(1000000, 'a');
+  const HASH_BACKEND backends[] = {HASH_BACKEND_OPENSSL, HASH_BACKEND_BUILTIN};
+  for (HASH_BACKEND backend : backends) {
+    HashEngine md5(HASH_MD5, backend);
+    EXPECT_EQ(16u, md5.digestLength());
+    md5.update(abc);
+    EXPECT_EQ("900150983cd24fb0d6963f7d28e17f72", md5.HexDigest());
+    // 取出摘要后重新开始计算, 分多次输入的结果与一次输入一致
+    for (size_t pos = 0; pos < million_a.size(); pos += 4099) {
+      md5.update(million_a.data() + pos,
+                 std::min<size_t>(4099, million_a.size() - pos));
+    }
+    EXPECT_EQ("7707d6ae4e027c70eea2a935c2296f21", md5.HexDigest());
+
+    HashEngine sha1(HASH_SHA1, backend);
+    EXPECT_EQ(20u, sha1.digestLength());
+    sha1.update(abc);
+    EXPECT_EQ("a9993e364706816aba3e25717850c26c9cd0d89d", sha1.HexDigest());
+    sha1.update(million_a);
+    sha1.reset();
+    sha1.update(million_a);
+    EXPECT_EQ("34aa973cd4c4daa4f61eeb2bdbad27316534016f", sha1.HexDigest());
+  }
+
+  // 一次性计算使用CosSysConfig指定的实现, 两种实现的结果一致
+  const std::string hmac_data = "what do ya want for nothing?";
+  for (HASH_BACKEND backend : backends) {
+    CosSysConfig::SetHashBackend(backend);
+    EXPECT_EQ("900150983cd24fb0d6963f7d28e17f72",
+              HashUtil::Md5Hex(abc.data(), abc.size()));
+    EXPECT_EQ("kAFQmDzST7DWlj99KOF/cg==",
+              CodecUtil::Base64Encode(HashUtil::Md5(abc.data(), abc.size())));
+    EXPECT_EQ("a9993e364706816aba3e25717850c26c9cd0d89d",
+              HashUtil::Sha1Hex(abc.data(), abc.size()));
+    // RFC 2202 test case 2
+    EXPECT_EQ("effcdf6ae5eb2fa2d27416d5f184df9c259a7c79",
+              HashUtil::HmacSha1Hex(hmac_data, "Jefe"));
+    std::istringstream iss(million_a);
+    EXPECT_EQ("7707d6ae4e027c70eea2a935c2296f21", HashUtil::Md5Hex(iss));
+  }
+  CosSysConfig::SetHashBackend(HASH_BACKEND_OPENSSL);
+}
+
+TEST(UtilTest, Md5Crc64Test) {
+  // 一次遍历的结果与分别计算MD5、CRC64一致, 长度覆盖分块边界
+  std::string data(3 * 16 * 1024 + 77, '\0');
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<char>((i * 131 + 7) & 0xff);
+  }
+  const size_t lens[] = {0, 1, 16 * 1024 - 1, 16 * 1024, 16 * 1024 + 1,
+                         data.size()};
+  for (size_t len : lens) {
+    std::string expected_md5 = HashUtil::Md5Hex(data.data(), len);
+    uint64_t expected_crc64 = CRC64::CalcCRC(0, &data[0], len);
+
+    std::string md5_hex;
+    uint64_t crc64 = 1;
+    HashUtil::Md5Crc64(data.data(), len, &md5_hex, &crc64);
+    EXPECT_EQ(expected_md5, md5_hex);
+    EXPECT_EQ(expected_crc64, crc64);
+
+    crc64 = 1;
+    HashUtil::Md5Crc64(data.data(), len, nullptr, &crc64);
+    EXPECT_EQ(expected_crc64, crc64);
+
+    std::istringstream iss(data.substr(0, len));
+    md5_hex.clear();
+    HashUtil::Md5Crc64(iss, &md5_hex, &crc64);
+    EXPECT_EQ(expected_md5, md5_hex);
+    EXPECT_EQ(expected_crc64, crc64);
+
+    std::istringstream crc_iss(data.substr(0, len));
+    HashUtil::Md5Crc64(crc_iss, nullptr, &crc64);
+    EXPECT_EQ(expected_crc64, crc64);
+  }
+
+  // 以之前的CRC64为初始值接着计算, 与整段计算一致
+  size_t half = data.size() / 2;
+  Md5Crc64Engine engine(CRC64::CalcCRC(0, &data[0], half));
+  engine.Update(data.data() + half, data.size() - half);
+  EXPECT_EQ(CRC64::CalcCRC(0, &data[0], data.size()), engine.GetCrc64());
+  EXPECT_EQ(HashUtil::Md5Hex(data.data() + half, data.size() - half),
+            engine.Md5Hex());
+}
+
 TEST(UtilTest, CR64Test) {
   const std::string test_file = "/tmp/testcrc64";
   TestUtils::WriteStringtoFile(test_file, "0123456789");
   ASSERT_EQ(FileUtil::GetFileCrc64(test_file), 2838902930144391966);
   TestUtils::RemoveFile(test_file);
+
+  // 多线程分段计算的结果与单线程一致
+  const std::string big_file = "/tmp/testcrc64_big";
+  TestUtils::WriteRandomDatatoFile(big_file, 40 * 1024 * 1024 + 123);
+  uint64_t crc64 = FileUtil::GetFileCrc64(big_file, 1);
+  ASSERT_EQ(FileUtil::GetFileCrc64(big_file, 3), crc64);
+  ASSERT_EQ(FileUtil::GetFileCrc64(big_file), crc64);
+  TestUtils::RemoveFile(big_file);
+}
+
+TEST(UtilTest, CRC64ConsistencyTest) {
+  // 整块计算(可能走硬件加速)与小块计算(查表)的结果必须一致
+  std::string data(1024 * 1024 + 77, '\0');
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<char>((i * 131 + 7) & 0xff);
+  }
+  const size_t lens[] = {0, 1, 127, 128, 129, 255, 256, 4097, data.size() - 1};
+  for (size_t len : lens) {
+    for (size_t offset = 0; offset <= 1 && offset + len <= data.size(); ++offset) {
+      uint64_t expected = 0;
+      for (size_t pos = 0; pos < len; pos += 64) {
+        size_t n = std::min<size_t>(64, len - pos);
+        expected = CRC64::CalcCRC(expected, &data[offset + pos], n);
+      }
+      ASSERT_EQ(expected, CRC64::CalcCRC(0, &data[offset], len));
+    }
+  }
+
+  // 与CombineCRC兼容
+  uint64_t crc1 = CRC64::CalcCRC(0, &data[0], 4096);
+  uint64_t crc2 = CRC64::CalcCRC(0, &data[4096], data.size() - 4096);
+  ASSERT_EQ(CRC64::CalcCRC(0, &data[0], data.size()),
+            CRC64::CombineCRC(crc1, crc2, data.size() - 4096));
+}
+
+TEST(UtilTest, Crc64SliceCombinerTest) {
+  std::string data(10 * 1000 + 7, '\0');
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<char>((i * 131 + 7) & 0xff);
+  }
+  const uint64_t expected = CRC64::CalcCRC(0, &data[0], data.size());
+  const size_t slice_size = 1000;
+  std::vector<size_t> offsets;
+  for (size_t offset = 0; offset < data.size(); offset += slice_size) {
+    offsets.push_back(offset);
+  }
+
+  // 分片乱序到达, 最后一个分片到达前不能合并到结尾
+  std::vector<size_t> order(offsets.rbegin(), offsets.rend());
+  std::swap(order[1], order[4]);
+  Crc64SliceCombiner combiner;
+  for (size_t idx = 0; idx < order.size(); ++idx) {
+    size_t offset = order[idx];
+    size_t len = std::min(slice_size, data.size() - offset);
+    combiner.AddSlice(offset, CRC64::CalcCRC(0, &data[offset], len), len);
+    if (idx + 1 < order.size()) {
+      EXPECT_EQ(0u, combiner.GetOffset());
+      EXPECT_TRUE(combiner.HasPending());
+    }
+  }
+  EXPECT_FALSE(combiner.HasPending());
+  EXPECT_EQ(data.size(), combiner.GetOffset());
+  EXPECT_EQ(expected, combiner.GetCrc64());
+
+  // 从已合并的前缀继续, 空分片不影响结果
+  const size_t prefix = 3 * slice_size;
+  Crc64SliceCombiner resumed(prefix, CRC64::CalcCRC(0, &data[0], prefix));
+  resumed.AddSlice(prefix, 0, 0);
+  for (size_t offset = prefix; offset < data.size(); offset += slice_size) {
+    size_t len = std::min(slice_size, data.size() - offset);
+    resumed.AddSlice(offset, CRC64::CalcCRC(0, &data[offset], len), len);
+  }
+  EXPECT_EQ(data.size(), resumed.GetOffset());
+  EXPECT_EQ(expected, resumed.GetCrc64());
 }
 
 TEST(UtilTest, FileLenTest) {
@@ -209,6 +447,371 @@ TEST(UtilTest, DnsCacheTest) {
 
 }
 
+TEST(UtilTest, HttpSessionPoolTest) {
+  CosSysConfig::SetMaxIdleSessionsPerHost(8);
+  ASSERT_EQ(CosSysConfig::GetMaxIdleSessionsPerHost(), 8);
+  CosSysConfig::SetSessionIdleTimeout(0);
+  ASSERT_EQ(CosSysConfig::GetSessionIdleTimeout(), 1);
+  CosSysConfig::SetSessionIdleTimeout(30);
+
+  const std::string key = "http://127.0.0.1:80";
+  HttpSessionPool pool(2, 30);
+  ASSERT_FALSE(pool.Acquire(key));
+  ASSERT_EQ(pool.GetActiveCount(key), 1);
+  pool.Release(key, HttpSessionPool::SessionPtr());
+  ASSERT_EQ(pool.GetActiveCount(key), 0);
+
+  // 超过单host上限时丢弃最老的连接
+  for (int i = 0; i < 3; ++i) {
+    pool.Release(key, HttpSessionPool::SessionPtr(
+                          new Poco::Net::HTTPClientSession("127.0.0.1", 80)));
+  }
+  ASSERT_EQ(pool.GetIdleCount(key), 2);
+  ASSERT_EQ(pool.GetIdleCount(), 2);
+  ASSERT_EQ(pool.GetIdleCount("http://127.0.0.2:80"), 0);
+
+  // 未建立连接的session无法通过健康检查, 不会被取出
+  ASSERT_FALSE(pool.Acquire(key));
+  ASSERT_EQ(pool.GetIdleCount(key), 0);
+  pool.Release(key, HttpSessionPool::SessionPtr());
+
+  pool.Release(key, HttpSessionPool::SessionPtr(
+                        new Poco::Net::HTTPClientSession("127.0.0.1", 80)));
+  pool.SetMaxIdlePerHost(0);
+  ASSERT_EQ(pool.GetIdleCount(), 0);
+  pool.Release(key, HttpSessionPool::SessionPtr(
+                        new Poco::Net::HTTPClientSession("127.0.0.1", 80)));
+  ASSERT_EQ(pool.GetIdleCount(), 0);
+
+  pool.SetMaxIdlePerHost(2);
+  pool.Release(key, HttpSessionPool::SessionPtr(
+                        new Poco::Net::HTTPClientSession("127.0.0.1", 80)));
+  pool.Clear();
+  ASSERT_EQ(pool.GetIdleCount(), 0);
+
+  // 活跃连接数达到上限时Acquire等待其他连接归还, 不同key互不影响
+  CosSysConfig::SetMaxSessionsPerHost(4);
+  ASSERT_EQ(CosSysConfig::GetMaxSessionsPerHost(), 4);
+  CosSysConfig::SetMaxSessionsPerHost(0);
+  pool.SetMaxActivePerHost(2);
+  pool.Acquire(key);
+  pool.Acquire(key);
+  pool.Acquire("http://127.0.0.2:80");
+  ASSERT_EQ(pool.GetActiveCount(key), 2);
+  std::atomic<bool> acquired(false);
+  std::thread waiter([&pool, &key, &acquired]() {
+    pool.Acquire(key);
+    acquired = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_FALSE(acquired);
+  pool.Release(key, HttpSessionPool::SessionPtr());
+  waiter.join();
+  ASSERT_TRUE(acquired);
+  ASSERT_EQ(pool.GetActiveCount(key), 2);
+  pool.Release(key, HttpSessionPool::SessionPtr());
+  pool.Release(key, HttpSessionPool::SessionPtr());
+  pool.Release("http://127.0.0.2:80", HttpSessionPool::SessionPtr());
+  ASSERT_EQ(pool.GetActiveCount(key), 0);
+}
+
+static int g_ssl_ctx_cb_count = 0;
+static int CountingSslCtxCb(void*, void*) {
+  ++g_ssl_ctx_cb_count;
+  return 0;
+}
+static int FailingSslCtxCb(void*, void*) { return 5; }
+
+TEST(UtilTest, SslContextCacheTest) {
+  int user_data = 0;
+  const std::string key1 = SslContextCache::BuildContextKey(true, "", nullptr, nullptr);
+  const std::string key2 = SslContextCache::BuildContextKey(false, "", nullptr, nullptr);
+  const std::string key3 = SslContextCache::BuildContextKey(true, "/tmp/ca.pem", nullptr, nullptr);
+  ASSERT_NE(key1, key2);
+  ASSERT_NE(key1, key3);
+  ASSERT_EQ(key1, SslContextCache::BuildContextKey(true, "", nullptr, nullptr));
+
+  g_ssl_ctx_cb_count = 0;
+  SSLCtxCallback ok_cb = CountingSslCtxCb;
+  SSLCtxCallback fail_cb = FailingSslCtxCb;
+  const std::string ok_key = SslContextCache::BuildContextKey(false, "", ok_cb, &user_data);
+  const std::string fail_key = SslContextCache::BuildContextKey(false, "", fail_cb, &user_data);
+  ASSERT_FALSE(ok_key.empty());
+  ASSERT_NE(ok_key, fail_key);
+  ASSERT_NE(ok_key, SslContextCache::BuildContextKey(false, "", ok_cb, nullptr));
+
+  SslContextCache cache(2, 10);
+  int cb_ret = 0;
+  // 回调只在创建Context时执行一次
+  Poco::Net::Context::Ptr ctx1 = cache.GetContext(ok_key, false, "", ok_cb, &user_data, &cb_ret);
+  Poco::Net::Context::Ptr ctx2 = cache.GetContext(ok_key, false, "", ok_cb, &user_data, &cb_ret);
+  ASSERT_FALSE(ctx1.isNull());
+  ASSERT_EQ(ctx1.get(), ctx2.get());
+  ASSERT_EQ(g_ssl_ctx_cb_count, 1);
+
+  // 回调失败时不缓存
+  ASSERT_TRUE(cache.GetContext(fail_key, false, "", fail_cb, &user_data, &cb_ret).isNull());
+  ASSERT_EQ(cb_ret, 5);
+
+  // lambda捕获的状态无法区分, 不缓存, 每次都执行回调
+  int lambda_count = 0;
+  SSLCtxCallback lambda_cb = [&lambda_count](void*, void*) { ++lambda_count; return 0; };
+  const std::string lambda_key = SslContextCache::BuildContextKey(false, "", lambda_cb, &user_data);
+  ASSERT_TRUE(lambda_key.empty());
+  Poco::Net::Context::Ptr ctx3 = cache.GetContext(lambda_key, false, "", lambda_cb, &user_data, &cb_ret);
+  Poco::Net::Context::Ptr ctx4 = cache.GetContext(lambda_key, false, "", lambda_cb, &user_data, &cb_ret);
+  ASSERT_NE(ctx3.get(), ctx4.get());
+  ASSERT_EQ(lambda_count, 2);
+
+  // 不可缓存的Context不持锁创建, 多个请求的回调可以同时执行
+  std::atomic<int> in_cb(0);
+  std::atomic<int> overlapped(0);
+  SSLCtxCallback wait_cb = [&in_cb, &overlapped](void*, void*) {
+    ++in_cb;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (in_cb.load() < 2 && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (in_cb.load() >= 2) {
+      ++overlapped;
+    }
+    return 0;
+  };
+  std::vector<std::thread> cb_threads;
+  for (int i = 0; i < 2; ++i) {
+    cb_threads.emplace_back([&cache, &wait_cb, &user_data]() {
+      int ret = 0;
+      EXPECT_FALSE(cache.GetContext("", false, "", wait_cb, &user_data, &ret).isNull());
+    });
+  }
+  for (auto& t : cb_threads) {
+    t.join();
+  }
+  ASSERT_EQ(overlapped.load(), 2);
+
+  // 超过容量时淘汰最久未使用的Context
+  int other_data[2] = {0, 0};
+  for (int i = 0; i < 2; ++i) {
+    const std::string key = SslContextCache::BuildContextKey(false, "", ok_cb, &other_data[i]);
+    ASSERT_FALSE(cache.GetContext(key, false, "", ok_cb, &other_data[i], &cb_ret).isNull());
+  }
+  ASSERT_EQ(g_ssl_ctx_cb_count, 3);
+  Poco::Net::Context::Ptr ctx5 = cache.GetContext(ok_key, false, "", ok_cb, &user_data, &cb_ret);
+  ASSERT_NE(ctx1.get(), ctx5.get());
+  ASSERT_EQ(g_ssl_ctx_cb_count, 4);
+
+  ASSERT_TRUE(cache.GetSession("host:443|" + ok_key).isNull());
+  cache.Clear();
+  Poco::Net::Context::Ptr ctx6 = cache.GetContext(ok_key, false, "", ok_cb, &user_data, &cb_ret);
+  ASSERT_FALSE(ctx6.isNull());
+  ASSERT_EQ(g_ssl_ctx_cb_count, 5);
+}
+
+namespace {
+class CountingRunnable : public Poco::Runnable {
+ public:
+  CountingRunnable(std::atomic<int>* running, std::atomic<int>* max_running,
+                   std::atomic<int>* finished)
+      : m_running(running), m_max_running(max_running), m_finished(finished) {}
+
+  void run() {
+    int cur = ++(*m_running);
+    int prev = m_max_running->load();
+    while (cur > prev && !m_max_running->compare_exchange_weak(prev, cur)) {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    --(*m_running);
+    ++(*m_finished);
+  }
+
+ private:
+  std::atomic<int>* m_running;
+  std::atomic<int>* m_max_running;
+  std::atomic<int>* m_finished;
+};
+}  // namespace
+
+TEST(UtilTest, TransferWorkerPoolTest) {
+  TransferWorkerPool pool(4);
+  ASSERT_EQ(pool.GetWorkerCount(), 0);
+
+  // 多个传输并发提交, 每组不超过自身并发上限, 全部任务都能执行完
+  std::vector<std::thread> transfers;
+  for (int g = 0; g < 3; ++g) {
+    transfers.emplace_back([&pool]() {
+      std::atomic<int> running(0);
+      std::atomic<int> max_running(0);
+      std::atomic<int> finished(0);
+      std::vector<CountingRunnable> tasks(
+          30, CountingRunnable(&running, &max_running, &finished));
+      TransferWorkerPool::Group group(pool, 2);
+      for (auto& task : tasks) {
+        group.Start(task);
+      }
+      group.JoinAll();
+      EXPECT_EQ(finished.load(), 30);
+      EXPECT_LE(max_running.load(), 2);
+    });
+  }
+  for (auto& t : transfers) {
+    t.join();
+  }
+  // 线程常驻复用, 不超过全局上限
+  ASSERT_LE(pool.GetWorkerCount(), 4);
+  ASSERT_GT(pool.GetWorkerCount(), 0);
+
+  // 调小上限后全局并发随之受限
+  pool.SetMaxWorkers(1);
+  std::atomic<int> running(0);
+  std::atomic<int> max_running(0);
+  std::atomic<int> finished(0);
+  std::vector<CountingRunnable> tasks(
+      10, CountingRunnable(&running, &max_running, &finished));
+  {
+    TransferWorkerPool::Group group(pool, 8);
+    for (auto& task : tasks) {
+      group.Start(task);
+    }
+  }
+  ASSERT_EQ(finished.load(), 10);
+  ASSERT_EQ(max_running.load(), 1);
+}
+
+TEST(UtilTest, RunFileWorkersTest) {
+  // 每个下标恰好处理一次, 并发线程数不超过worker_num
+  std::vector<std::atomic<int>> visits(100);
+  std::atomic<int> running(0);
+  std::atomic<int> max_running(0);
+  FileWorkerResult worker_result;
+  RunFileWorkers(4, visits.size(), [&](size_t index) {
+    int cur = ++running;
+    int prev = max_running.load();
+    while (cur > prev && !max_running.compare_exchange_weak(prev, cur)) {
+    }
+    ++visits[index];
+    if (index % 10 == 3) {
+      CosResult fail;
+      fail.SetErrorMsg("fail " + std::to_string(index));
+      std::lock_guard<std::mutex> lock(worker_result.GetMutex());
+      worker_result.SetFailLocked(fail);
+    }
+    --running;
+  });
+  for (const auto& visit : visits) {
+    ASSERT_EQ(visit.load(), 1);
+  }
+  ASSERT_LE(max_running.load(), 4);
+  // 只保留第一个失败的结果
+  ASSERT_TRUE(worker_result.IsFailed());
+  ASSERT_EQ(worker_result.GetFailResult().GetErrorMsg().compare(0, 5, "fail "), 0);
+
+  // 没有文件时直接返回
+  int calls = 0;
+  RunFileWorkers(4, 0, [&calls](size_t) { ++calls; });
+  ASSERT_EQ(calls, 0);
+}
+
+TEST(UtilTest, BufferPoolTest) {
+  // 规格按页对齐, 每个2的幂区间4档
+  ASSERT_EQ(BufferPool::GetSizeClass(1), 4096);
+  ASSERT_EQ(BufferPool::GetSizeClass(5000), 8192);
+  ASSERT_EQ(BufferPool::GetSizeClass(4 * 1024 * 1024), 4 * 1024 * 1024);
+  ASSERT_EQ(BufferPool::GetSizeClass(10 * 1024 * 1024), 10 * 1024 * 1024);
+  ASSERT_EQ(BufferPool::GetSizeClass(10 * 1024 * 1024 + 1), 12 * 1024 * 1024);
+
+  const size_t buf_size = 1024 * 1024;
+  BufferPool pool(3 * buf_size, false);
+  unsigned char* buf1 = pool.Acquire(buf_size);
+  unsigned char* buf2 = pool.Acquire(buf_size);
+  ASSERT_TRUE(buf1 != nullptr);
+  ASSERT_TRUE(buf2 != nullptr);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(buf1) % 4096, 0);
+  memset(buf1, 'a', buf_size);
+  pool.Release(buf1);
+  pool.Release(buf2);
+  BufferPool::Stats stats = pool.GetStats();
+  ASSERT_EQ(stats.bytes_cached, 2 * buf_size);
+  ASSERT_EQ(stats.bytes_in_use, 0);
+
+  // 同规格的申请复用缓存
+  unsigned char* buf3 = pool.Acquire(buf_size - 100);
+  ASSERT_TRUE(buf3 == buf1 || buf3 == buf2);
+  stats = pool.GetStats();
+  ASSERT_EQ(stats.reuse_count, 1);
+
+  // 超过上限时淘汰缓存, 释放后不再缓存
+  unsigned char* big = pool.Acquire(4 * buf_size);
+  ASSERT_TRUE(big != nullptr);
+  stats = pool.GetStats();
+  ASSERT_EQ(stats.over_limit_count, 1);
+  ASSERT_EQ(stats.bytes_cached, 0);
+  pool.Release(big);
+  pool.Release(buf3);
+  stats = pool.GetStats();
+  ASSERT_EQ(stats.bytes_in_use, 0);
+  ASSERT_EQ(stats.bytes_cached, buf_size);
+  ASSERT_EQ(stats.peak_bytes_in_use, 5 * buf_size);
+
+  pool.Trim();
+  ASSERT_EQ(pool.GetStats().bytes_cached, 0);
+}
+
+TEST(UtilTest, FilePartReaderTest) {
+  const uint64_t part_size = 4096;
+  const uint64_t file_size = part_size * 9 + 100;
+  std::string content;
+  for (uint64_t i = 0; i < file_size; ++i) {
+    content.push_back(static_cast<char>('a' + (i / part_size) % 26));
+  }
+  const std::string file_path = "/tmp/test_file_part_reader.bin";
+  {
+    std::ofstream ofs(file_path, std::ios::out | std::ios::binary);
+    ofs.write(content.data(), content.size());
+  }
+
+  {
+    // 多个读线程并发预读, 分块仍按part_number顺序交付
+    FilePartReader reader(file_size, part_size, 2, 2, 3);
+    ASSERT_TRUE(reader.Start(file_path));
+    ReadAheadPart part;
+    uint64_t expect_part_number = 1;
+    while (reader.Next(&part)) {
+      ASSERT_EQ(part.part_number, expect_part_number);
+      ASSERT_EQ(part.offset, (expect_part_number - 1) * part_size);
+      ASSERT_EQ(part.len, std::min(part_size, file_size - part.offset));
+      ASSERT_EQ(std::string(reinterpret_cast<char*>(part.buf), part.len),
+                content.substr(part.offset, part.len));
+      reader.Release(part.buf);
+      ++expect_part_number;
+    }
+    ASSERT_EQ(expect_part_number, 11);
+    ASSERT_TRUE(reader.GetErrMsg().empty());
+  }
+
+  {
+    // 文件比声明的短, 读到截断处的分块时报错, 不交付残缺分块
+    FilePartReader reader(file_size + part_size, part_size, 1, 1, 1);
+    ASSERT_TRUE(reader.Start(file_path));
+    ReadAheadPart part;
+    uint64_t delivered = 0;
+    while (reader.Next(&part)) {
+      ASSERT_EQ(part.len, part_size);
+      reader.Release(part.buf);
+      ++delivered;
+    }
+    ASSERT_EQ(delivered, 9);
+    ASSERT_FALSE(reader.GetErrMsg().empty());
+  }
+
+  {
+    // 打开文件失败
+    FilePartReader reader(file_size, part_size, 1, 1, 1);
+    ASSERT_FALSE(reader.Start("/tmp/test_file_part_reader_not_exist.bin"));
+    ASSERT_FALSE(reader.GetErrMsg().empty());
+  }
+  std::remove(file_path.c_str());
+}
+
 TEST(UtilTest, StringUtilTest) {
   StringUtil string_util;
   {
@@ -416,6 +1019,59 @@ TEST(UtilTest, FileUtilTest){
     std::string actual1 = qcloud_cos::FileUtil::GetDirectory(path1);
     EXPECT_EQ(expected1, actual1);
   }
+#if !defined(_WIN32)
+  {
+    // 多线程乱序写入不同区间
+    std::string temp_file_path = "/tmp/test_write_file_at.bin";
+    int fd = open(temp_file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ASSERT_NE(-1, fd);
+    const size_t slice_len = 4096;
+    const int slice_num = 8;
+    qcloud_cos::FileUtil::PreallocateFile(fd, slice_len * slice_num);
+    std::vector<std::thread> threads;
+    for (int i = slice_num - 1; i >= 0; --i) {
+      threads.emplace_back([fd, i, slice_len]() {
+        std::string data(slice_len, static_cast<char>('a' + i));
+        std::string err_msg;
+        EXPECT_TRUE(qcloud_cos::FileUtil::WriteFileAt(
+            fd, reinterpret_cast<const unsigned char*>(data.data()),
+            data.size(), i * slice_len, &err_msg));
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    close(fd);
+
+    std::string actual = qcloud_cos::FileUtil::GetFileContent(temp_file_path);
+    ASSERT_EQ(slice_len * slice_num, actual.size());
+    for (int i = 0; i < slice_num; ++i) {
+      EXPECT_EQ(std::string(slice_len, static_cast<char>('a' + i)),
+                actual.substr(i * slice_len, slice_len));
+    }
+    std::remove(temp_file_path.c_str());
+
+    std::string err_msg;
+    EXPECT_FALSE(qcloud_cos::FileUtil::WriteFileAt(
+        -1, reinterpret_cast<const unsigned char*>("x"), 1, 0, &err_msg));
+    EXPECT_FALSE(err_msg.empty());
+  }
+#endif
+  {
+    // 对象key转换的本地相对路径不能写到目标目录之外
+    std::string normalized;
+    EXPECT_TRUE(qcloud_cos::FileUtil::NormalizeRelativePath("a/./b//c.txt", &normalized));
+    EXPECT_EQ("a/b/c.txt", normalized);
+    EXPECT_TRUE(qcloud_cos::FileUtil::NormalizeRelativePath("a\\b..c/d", &normalized));
+    EXPECT_EQ("a/b..c/d", normalized);
+    EXPECT_TRUE(qcloud_cos::FileUtil::NormalizeRelativePath("", &normalized));
+    EXPECT_EQ("", normalized);
+    EXPECT_FALSE(qcloud_cos::FileUtil::NormalizeRelativePath("../../home/x/.bashrc", &normalized));
+    EXPECT_FALSE(qcloud_cos::FileUtil::NormalizeRelativePath("a/../../x", &normalized));
+    EXPECT_FALSE(qcloud_cos::FileUtil::NormalizeRelativePath("a\\..\\x", &normalized));
+    EXPECT_FALSE(qcloud_cos::FileUtil::NormalizeRelativePath("\\\\server\\share", &normalized));
+    EXPECT_FALSE(qcloud_cos::FileUtil::NormalizeRelativePath("C:/Windows/x", &normalized));
+  }
 }
 
 TEST(UtilTest, CodecUtilTest){